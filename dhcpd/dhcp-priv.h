@@ -20,6 +20,10 @@
 
 #define SERVER_BUFFER_SIZE        1024
 #define MAC_IP_CACHE_SIZE         8
+/* Upper bound on datagrams drained from one socket per select() wakeup */
+#define SERVER_MAX_BURST          8
+/* subnet mask, lease time, server id, router, nameserver and end option */
+#define DHCP_REPLY_OPTS_SIZE      (5U * (2U + 4U) + 1U)
 #define SEND_RESPONSE(w, x, y, z) dhcp_send_response(w, x, y, z)
 
 struct client_mac_cache
@@ -41,6 +45,12 @@ struct dhcp_server_data
     uint32_t client_ip;  /* last address that was requested, network
                           * order */
     uint32_t current_ip; /* keep track of assigned IP addresses */
+    /* Options common to every OFFER/ACK, built once and copied in after the
+     * message type option of each reply.
+     */
+    char reply_opts[DHCP_REPLY_OPTS_SIZE];
+    unsigned int reply_opts_len;
+    bool reply_opts_valid;
 };
 
 int dhcp_server_init(void *intrfc_handle);
@@ -131,7 +131,8 @@ int dhcp_server_lease_timeout(uint32_t val)
     }
     else
     {
-        dhcp_address_timeout = val;
+        dhcp_address_timeout   = val;
+        dhcps.reply_opts_valid = false;
         return WM_SUCCESS;
     }
 }
@@ -170,6 +171,36 @@ static unsigned int next_yiaddr(void)
     return new_ip;
 }
 
+static unsigned int put_u32_option(char *dest, uint8_t type, uint32_t be_value)
+{
+    struct bootp_option *opt = (struct bootp_option *)(void *)dest;
+
+    opt->type = type;
+    write_u32(opt->value, be_value);
+    opt->length = 4;
+
+    return (unsigned int)(sizeof(struct bootp_option) + opt->length);
+}
+
+/* Build the options shared by all OFFER/ACK replies. They only depend on the
+ * server configuration, so they are formatted once and copied verbatim into
+ * each reply instead of being regenerated per request.
+ */
+static void build_reply_template(void)
+{
+    char *offset = dhcps.reply_opts;
+
+    offset += put_u32_option(offset, BOOTP_OPTION_SUBNET_MASK, dhcps.netmask);
+    offset += put_u32_option(offset, BOOTP_OPTION_ADDRESS_TIME, htonl(dhcp_address_timeout));
+    offset += put_u32_option(offset, BOOTP_OPTION_DHCP_SERVER_ID, dhcps.my_ip);
+    offset += put_u32_option(offset, BOOTP_OPTION_ROUTER, dhcps.my_ip);
+    offset += put_u32_option(offset, BOOTP_OPTION_NAMESERVER, dns_get_nameserver());
+    *offset++ = (char)BOOTP_END_OPTION;
+
+    dhcps.reply_opts_len   = (unsigned int)(offset - dhcps.reply_opts);
+    dhcps.reply_opts_valid = true;
+}
+
 static unsigned int make_response(char *msg, enum dhcp_message_type type)
 {
     struct bootp_header *hdr;
@@ -199,39 +230,13 @@ static unsigned int make_response(char *msg, enum dhcp_message_type type)
         return (unsigned int)(offset - msg);
     }
 
-    opt       = (struct bootp_option *)(void *)offset;
-    opt->type = BOOTP_OPTION_SUBNET_MASK;
-    write_u32(opt->value, dhcps.netmask);
-    opt->length = 4;
-    offset += sizeof(struct bootp_option) + opt->length;
-
-    opt       = (struct bootp_option *)(void *)offset;
-    opt->type = BOOTP_OPTION_ADDRESS_TIME;
-    write_u32(opt->value, htonl(dhcp_address_timeout));
-    opt->length = 4;
-    offset += sizeof(struct bootp_option) + opt->length;
-
-    opt       = (struct bootp_option *)(void *)offset;
-    opt->type = BOOTP_OPTION_DHCP_SERVER_ID;
-    write_u32(opt->value, dhcps.my_ip);
-    opt->length = 4;
-    offset += sizeof(struct bootp_option) + opt->length;
-
-    opt       = (struct bootp_option *)(void *)offset;
-    opt->type = BOOTP_OPTION_ROUTER;
-    write_u32(opt->value, dhcps.my_ip);
-    opt->length = 4;
-    offset += sizeof(struct bootp_option) + opt->length;
-
-    opt       = (struct bootp_option *)(void *)offset;
-    opt->type = BOOTP_OPTION_NAMESERVER;
-    write_u32(opt->value, dns_get_nameserver());
-    opt->length = 4;
-    offset += sizeof(struct bootp_option) + opt->length;
+    if (!dhcps.reply_opts_valid)
+    {
+        build_reply_template();
+    }
 
-    opt       = (struct bootp_option *)(void *)offset;
-    opt->type = BOOTP_END_OPTION;
-    offset++;
+    (void)memcpy(offset, dhcps.reply_opts, dhcps.reply_opts_len);
+    offset += dhcps.reply_opts_len;
 
     return (unsigned int)(offset - msg);
 }
@@ -265,12 +270,58 @@ int dhcp_send_response(int sock, struct sockaddr *addr, char *msg, int len)
     return WM_SUCCESS;
 }
 
+/* Options of interest in a client message, located in a single walk of the
+ * options area.
+ */
+struct dhcp_opt_index
+{
+    uint8_t msg_type;            /* DHCP message type, 0 if absent */
+    const char *requested_ip;    /* value of the requested IP option */
+};
+
+static void index_dhcp_options(const char *opts, int len, struct dhcp_opt_index *idx)
+{
+    const struct bootp_option *opt;
+    unsigned int consumed;
+
+    (void)memset(idx, 0, sizeof(*idx));
+
+    while (len >= (int)sizeof(struct bootp_option))
+    {
+        opt = (const struct bootp_option *)(const void *)opts;
+        if (opt->type == BOOTP_END_OPTION)
+        {
+            break;
+        }
+
+        consumed = sizeof(struct bootp_option) + opt->length;
+        if ((int)consumed > len)
+        {
+            break;
+        }
+
+        if (opt->type == BOOTP_OPTION_DHCP_MESSAGE && opt->length == 1U)
+        {
+            idx->msg_type = *(const uint8_t *)opt->value;
+        }
+        else if (opt->type == BOOTP_OPTION_REQUESTED_IP && opt->length == 4U)
+        {
+            idx->requested_ip = opt->value;
+        }
+        else
+        { /* Do Nothing */
+        }
+
+        len -= (int)consumed;
+        opts += consumed;
+    }
+}
+
 static int process_dhcp_message(char *msg, int len)
 {
     struct bootp_header *hdr;
-    struct bootp_option *opt;
+    struct dhcp_opt_index idx;
     uint8_t response_type = (uint8_t)DHCP_NO_RESPONSE;
-    unsigned int consumed = 0;
     bool got_ip           = 0;
     bool need_ip          = 0;
     int ret               = WM_SUCCESS;
@@ -308,109 +359,89 @@ static int process_dhcp_message(char *msg, int len)
 
     dhcp_d("magic cookie: 0x%X", hdr->cookie);
 
-    len -= sizeof(struct bootp_header);
-    opt = (struct bootp_option *)(void *)(msg + sizeof(struct bootp_header));
-    while (len > 0 && opt->type != BOOTP_END_OPTION)
+    index_dhcp_options(msg + sizeof(struct bootp_header), len - (int)sizeof(struct bootp_header), &idx);
+
+    switch (idx.msg_type)
     {
-        if (opt->type == BOOTP_OPTION_DHCP_MESSAGE && opt->length == 1U)
-        {
-            dhcp_d("found DHCP message option");
-            switch (*(uint8_t *)opt->value)
+        case DHCP_MESSAGE_DISCOVER:
+            dhcp_d("DHCP discover");
+            response_type = (uint8_t)DHCP_MESSAGE_OFFER;
+            break;
+
+        case DHCP_MESSAGE_REQUEST:
+            dhcp_d("DHCP request");
+            need_ip = 1;
+            if (hdr->ciaddr != 0x0000000U)
             {
-                case DHCP_MESSAGE_DISCOVER:
-                    dhcp_d("DHCP discover");
-                    response_type = (uint8_t)DHCP_MESSAGE_OFFER;
-                    break;
+                dhcps.client_ip = hdr->ciaddr;
+                got_client_ip   = 1;
+            }
+            break;
 
-                case DHCP_MESSAGE_REQUEST:
-                    dhcp_d("DHCP request");
-                    need_ip = 1;
-                    if (hdr->ciaddr != 0x0000000U)
-                    {
-                        dhcps.client_ip = hdr->ciaddr;
-                        got_client_ip   = 1;
-                    }
-                    break;
+        default:
+            dhcp_d("ignoring message type %d", idx.msg_type);
+            break;
+    }
 
-                default:
-                    dhcp_d("ignoring message type %d", *(uint8_t *)opt->value);
-                    break;
-            }
-        }
-        if (opt->type == BOOTP_OPTION_REQUESTED_IP && opt->length == 4U)
+    if (idx.requested_ip != NULL)
+    {
+        dhcp_d("found REQUESTED IP option %hhu.%hhu.%hhu.%hhu", idx.requested_ip[0], idx.requested_ip[1],
+               idx.requested_ip[2], idx.requested_ip[3]);
+        (void)memcpy((uint8_t *)&dhcps.client_ip, (const uint8_t *)idx.requested_ip, 4);
+        got_client_ip = 1;
+    }
+
+    /* requested address outside of subnet */
+    if (got_client_ip && ((dhcps.client_ip & dhcps.netmask) == (dhcps.my_ip & dhcps.netmask)))
+    {
+        /* When client requests an IP address,
+         * DHCP-server checks if the valid
+         * IP-MAC entry is present in the
+         * ip-mac cache, if yes, also checks
+         * if the requested IP is same as the
+         * IP address present in IP-MAC entry,
+         * if yes, it allows the device to
+         * continue with the requested IP
+         * address.
+         */
+        new_ip = ac_lookup_mac(hdr->chaddr);
+        if (new_ip != (CLIENT_IP_NOT_FOUND))
         {
-            dhcp_d("found REQUESTED IP option %hhu.%hhu.%hhu.%hhu", opt->value[0], opt->value[1], opt->value[2],
-                   opt->value[3]);
-            (void)memcpy((uint8_t *)&dhcps.client_ip, (uint8_t *)opt->value, 4);
-            got_client_ip = 1;
+            /* if new_ip is equal to requested ip */
+            got_ip = (new_ip == dhcps.client_ip);
         }
-
-        if (got_client_ip)
+        else if (ac_valid_ip(ntohl(dhcps.client_ip)))
         {
-            /* requested address outside of subnet */
-            if ((dhcps.client_ip & dhcps.netmask) == (dhcps.my_ip & dhcps.netmask))
+            /* When client requests with an IP
+             * address that is within subnet range
+             * and not assigned to any other client,
+             * then dhcp-server allows that device
+             * to continue with that IP address.
+             * And if IP-MAC cache is not full then
+             * adds this entry in cache.
+             */
+            if (ac_not_full())
             {
-                /* When client requests an IP address,
-                 * DHCP-server checks if the valid
-                 * IP-MAC entry is present in the
-                 * ip-mac cache, if yes, also checks
-                 * if the requested IP is same as the
-                 * IP address present in IP-MAC entry,
-                 * if yes, it allows the device to
-                 * continue with the requested IP
-                 * address.
-                 */
-                new_ip = ac_lookup_mac(hdr->chaddr);
-                if (new_ip != (CLIENT_IP_NOT_FOUND))
-                {
-                    /* if new_ip is equal to requested ip */
-                    if (new_ip == dhcps.client_ip)
-                    {
-                        got_ip = 1;
-                    }
-                    else
-                    {
-                        got_ip = 0;
-                    }
-                }
-                else if (ac_valid_ip(ntohl(dhcps.client_ip)))
-                {
-                    /* When client requests with an IP
-                     * address that is within subnet range
-                     * and not assigned to any other client,
-                     * then dhcp-server allows that device
-                     * to continue with that IP address.
-                     * And if IP-MAC cache is not full then
-                     * adds this entry in cache.
-                     */
-                    if (ac_not_full())
-                    {
-                        (void)ac_add(hdr->chaddr, dhcps.client_ip);
-                    }
-                    else
-                    {
-                        dhcp_w(
-                            "No space to store new "
-                            "mapping..");
-                    }
-                    got_ip = 1;
-                }
-                else
-                { /* Do Nothing */
-                }
+                (void)ac_add(hdr->chaddr, dhcps.client_ip);
             }
+            else
+            {
+                dhcp_w(
+                    "No space to store new "
+                    "mapping..");
+            }
+            got_ip = 1;
         }
-
-        /* look at the next option (if any) */
-        consumed = sizeof(struct bootp_option) + opt->length;
-        len -= consumed;
-        opt = (struct bootp_option *)(void *)((char *)opt + consumed);
-        if (need_ip)
-        {
-            response_type = (uint8_t)(got_ip ? DHCP_MESSAGE_ACK : DHCP_MESSAGE_NAK);
+        else
+        { /* Do Nothing */
         }
     }
 
+    if (need_ip)
+    {
+        response_type = (uint8_t)(got_ip ? DHCP_MESSAGE_ACK : DHCP_MESSAGE_NAK);
+    }
+
     if (response_type != DHCP_NO_RESPONSE)
     {
         ret = make_response(msg, (enum dhcp_message_type)response_type);
@@ -459,6 +490,7 @@ void dhcp_server(os_thread_arg_t data)
     int addr_len = 0;
     int max_sock;
     int len;
+    int burst;
     socklen_t flen = sizeof(caddr);
     fd_set rfds;
 
@@ -537,9 +569,18 @@ void dhcp_server(os_thread_arg_t data)
 
         if (FD_ISSET(dhcps.sock, &rfds) != 0)
         {
-            len = recvfrom(dhcps.sock, dhcps.msg, sizeof(dhcps.msg), 0, (struct sockaddr *)(void *)&caddr, &flen);
-            if (len > 0)
+            /* The socket is non-blocking: drain what is already queued so that
+             * a burst of clients joining together costs one select() wakeup
+             * instead of one per request.
+             */
+            for (burst = 0; burst < SERVER_MAX_BURST; burst++)
             {
+                flen = sizeof(caddr);
+                len  = recvfrom(dhcps.sock, dhcps.msg, sizeof(dhcps.msg), 0, (struct sockaddr *)(void *)&caddr, &flen);
+                if (len <= 0)
+                {
+                    break;
+                }
                 dhcp_d("recved msg on dhcp sock len: %d", len);
                 (void)process_dhcp_message(dhcps.msg, len);
             }
@@ -58,70 +58,65 @@ static void format_qname(char *domain_name, char *dns_qname)
     dns_qname[0] = (char)i;
 }
 
-static unsigned int make_answer_rr(char *base, char *query, char *dst)
+static void make_answer_rr(char *base, const struct dns_qref *query, char *dst)
 {
-    struct dns_question *q;
     struct dns_rr *rr = (struct dns_rr *)(void *)dst;
-    char *query_start = query;
 
-    rr->name_ptr = htons(((uint16_t)(query - base) | 0xC000U));
-
-    /* skip past the qname (label) field */
-    do
-    {
-        if (*query > 0U)
-        {
-            query += *query + 1;
-        }
-    } while (*query > 0U);
-    query++;
-
-    q = (struct dns_question *)(void *)query;
-    query += sizeof(struct dns_question);
-
-    rr->type     = q->type;
-    rr->class    = q->class;
-    rr->ttl      = htonl(60U * 60U * 1U); /* 1 hour */
-    rr->rdlength = htons(4);
+    (void)memcpy(rr, &dnss.answer_tmpl, sizeof(*rr));
+    rr->name_ptr = htons(((uint16_t)(query->name - base) | 0xC000U));
+    rr->type     = query->q->type;
+    rr->class    = query->q->class;
     rr->rd       = dhcps.my_ip;
-
-    return (unsigned int)(query - query_start);
 }
 
-static char *parse_questions(unsigned int num_questions, uint8_t *pos, int *found)
+/* Walk the question section once, remembering where each question lives so
+ * that answers can be built without walking the labels again.
+ */
+static char *parse_questions(
+    unsigned int num_questions, uint8_t *pos, int len, int *found, struct dns_qref *qrefs, int *nq_ret)
 {
     uint8_t *base = pos;
-    int i;
+    uint8_t *end  = base + len;
+    uint8_t *qname;
+    int i, nq = 0;
 
     pos += sizeof(struct dns_header);
 
     for (; num_questions > 0U; num_questions--)
     {
+        qname = pos;
+        while (pos < end && *pos > 0U)
+        {
+            pos += *pos + 1U;
+        }
+        if (pos + 1U + sizeof(struct dns_question) > end)
+        {
+            return NULL;
+        }
+
         if (!*found)
         {
             for (i = 0; i < dnss.count_qnames; i++)
             {
-                *found =
-                    (int)(!strncmp(dnss.list_qnames[i].qname, (char *)pos, (size_t)(base + SERVER_BUFFER_SIZE - pos)));
-                if (*found != 0)
+                if (dnss.list_qnames[i].qname_len == (size_t)(pos + 1U - qname) &&
+                    memcmp(dnss.list_qnames[i].qname, qname, dnss.list_qnames[i].qname_len) == 0)
                 {
+                    *found = 1;
                     break;
                 }
             }
         }
-        do
+
+        if (nq < DNS_MAX_ANSWERS)
         {
-            if (*pos > 0U)
-            {
-                pos += *pos + 1U;
-            }
-            if (pos >= base + SERVER_BUFFER_SIZE)
-            {
-                return NULL;
-            }
-        } while (*pos > 0U);
+            qrefs[nq].name = (char *)qname;
+            qrefs[nq].q    = (const struct dns_question *)(const void *)(pos + 1U);
+            nq++;
+        }
         pos += 1U + sizeof(struct dns_question);
     }
+
+    *nq_ret = nq;
     return (char *)pos;
 }
 
@@ -129,7 +124,7 @@ static char *parse_questions(unsigned int num_questions, uint8_t *pos, int *foun
 static int process_dns_message(char *msg, int len, struct sockaddr_in *fromaddr)
 {
     struct dns_header *hdr;
-    char *pos;
+    struct dns_qref qrefs[DNS_MAX_ANSWERS];
     char *outp = msg + len;
     int found  = 0, nq, i;
 
@@ -158,10 +153,9 @@ static int process_dns_message(char *msg, int len, struct sockaddr_in *fromaddr)
         return -WM_E_DHCPD_DNS_IGNORE;
     }
 
-    outp = parse_questions((unsigned int)nq, (uint8_t *)msg, &found);
+    outp = parse_questions((unsigned int)nq, (uint8_t *)msg, len, &found, qrefs, &nq);
     if (found && outp != NULL)
     {
-        pos = msg + sizeof(struct dns_header);
         for (i = 0; i < nq; i++)
         {
             if (outp + sizeof(struct dns_rr) >= msg + SERVER_BUFFER_SIZE)
@@ -169,7 +163,7 @@ static int process_dns_message(char *msg, int len, struct sockaddr_in *fromaddr)
                 dhcp_d("no room for more answers, refusing");
                 break;
             }
-            pos += make_answer_rr(msg, pos, outp);
+            make_answer_rr(msg, &qrefs[i], outp);
             outp += sizeof(struct dns_rr);
         }
         hdr->flags.fields.qr    = 1;
@@ -185,6 +179,11 @@ static int process_dns_message(char *msg, int len, struct sockaddr_in *fromaddr)
         return SEND_RESPONSE(dnss.dnssock, (struct sockaddr *)(void *)fromaddr, msg, outp - msg);
     }
 
+    if (outp == NULL)
+    {
+        outp = msg + len;
+    }
+
     /* make the header represent a response */
     hdr->flags.fields.qr     = 1;
     hdr->flags.fields.opcode = 0;
@@ -228,8 +227,13 @@ void dhcp_enable_dns_server(char **domain_names)
         {
             (void)memset(dnss.list_qnames[i].qname, 0, sizeof(struct dns_qname));
             format_qname(domain_names[i], dnss.list_qnames[i].qname);
+            dnss.list_qnames[i].qname_len = strlen(dnss.list_qnames[i].qname) + 1U;
         }
     }
+
+    (void)memset(&dnss.answer_tmpl, 0, sizeof(dnss.answer_tmpl));
+    dnss.answer_tmpl.ttl      = htonl(60U * 60U * 1U); /* 1 hour */
+    dnss.answer_tmpl.rdlength = htons(4);
 }
 
 int dns_server_init(void *intrfc_handle)
@@ -261,9 +265,16 @@ void dns_process_packet(void)
     struct sockaddr_in caddr;
     socklen_t flen = sizeof(caddr);
     int len;
-    len = recvfrom(dnss.dnssock, dhcps.msg, sizeof(dhcps.msg), 0, (struct sockaddr *)(void *)&caddr, &flen);
-    if (len > 0)
+    int burst;
+
+    for (burst = 0; burst < SERVER_MAX_BURST; burst++)
     {
+        flen = sizeof(caddr);
+        len  = recvfrom(dnss.dnssock, dhcps.msg, sizeof(dhcps.msg), 0, (struct sockaddr *)(void *)&caddr, &flen);
+        if (len <= 0)
+        {
+            break;
+        }
         dhcp_d("recved msg on dns sock len: %d", len);
         (void)dhcp_dns_server_handler(dhcps.msg, len, &caddr);
     }
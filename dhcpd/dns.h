@@ -60,6 +60,17 @@ PACK_START struct dns_rr
 struct dns_qname
 {
     char qname[MAX_QNAME_SIZE + 1];
+    size_t qname_len; /* encoded length including the root label */
+};
+
+/* Upper bound on answers appended to a single response */
+#define DNS_MAX_ANSWERS 8
+
+/* Location of one question inside a received query */
+struct dns_qref
+{
+    char *name;                  /* start of the qname */
+    const struct dns_question *q; /* type and class following the qname */
 };
 
 struct dns_server_data
@@ -68,6 +79,8 @@ struct dns_server_data
     int dnssock;
     struct sockaddr_in dnsaddr; /* dns server address */
     struct dns_qname *list_qnames;
+    /* Answer record with the constant fields filled in at enable time */
+    struct dns_rr answer_tmpl;
 };
 
 int dns_server_init(void *intrfc_handle);
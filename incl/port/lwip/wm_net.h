@@ -509,6 +509,172 @@ void net_ipv6stack_init(struct netif *netif);
  */
 void net_stat(void);
 
+#ifdef CONFIG_WIFI_RX_PRIO
+/** Number of access categories used by the prioritized RX hand-off */
+#define NET_RX_PRIO_NUM_AC 4U
+
+/** Per access category RX hand-off counters */
+struct net_rx_prio_ac_stats
+{
+    /** Frames queued for the TCP/IP thread */
+    uint32_t enqueued;
+    /** Frames handed to lwIP */
+    uint32_t delivered;
+    /** Frames dropped because the queue was full */
+    uint32_t dropped;
+    /** Frames currently waiting */
+    uint16_t depth;
+    /** Highest queue depth seen */
+    uint16_t max_depth;
+    /** Average time from queueing to lwIP input in milliseconds */
+    uint32_t avg_latency_ms;
+    /** Worst time from queueing to lwIP input in milliseconds */
+    uint32_t max_latency_ms;
+};
+
+/** RX hand-off statistics */
+struct net_rx_prio_stats
+{
+    /** Counters indexed BK, BE, VI, VO */
+    struct net_rx_prio_ac_stats ac[NET_RX_PRIO_NUM_AC];
+    /** Times a waiting lower category was served ahead of a higher one */
+    uint32_t starve_breaks;
+    /** Drain callbacks run on the TCP/IP thread */
+    uint32_t drain_runs;
+};
+
+/** Get prioritized RX hand-off statistics
+ *
+ * \param[out] stats Per access category queue depth, drop and latency
+ *             counters.
+ *
+ * \return WM_SUCCESS on success or -WM_E_INVAL if \a stats is NULL.
+ */
+int net_get_rx_prio_stats(struct net_rx_prio_stats *stats);
+
+/** Reset prioritized RX hand-off statistics
+ */
+void net_reset_rx_prio_stats(void);
+#endif
+
+#ifdef CONFIG_WIFI_RX_BATCH
+/** RX batch hand-off configuration */
+struct net_rx_batch_config
+{
+    /** Frames accumulated before the batch is handed to the TCP/IP thread */
+    uint16_t max_frames;
+    /** Longest a frame may wait for its batch, in milliseconds. 0 hands
+     *  each frame over as soon as it arrives. */
+    uint16_t max_latency_ms;
+};
+
+/** RX batch hand-off statistics */
+struct net_rx_batch_stats
+{
+    /** Frames passed through the hand-off */
+    uint32_t frames;
+    /** TCP/IP thread messages posted */
+    uint32_t posts;
+    /** Messages that could not be posted because the mbox was full */
+    uint32_t post_failures;
+    /** Batches flushed at the end of an SDIO read cycle */
+    uint32_t flush_cycle_end;
+    /** Batches flushed because they reached max_frames */
+    uint32_t flush_full;
+    /** Batches flushed by the latency timer */
+    uint32_t flush_timer;
+    /** Largest batch handed over */
+    uint32_t max_batch;
+    /** Messages posted per 10000 frames */
+    uint32_t posts_per_10k_frames;
+};
+
+/** Configure RX batch hand-off
+ *
+ * \param[in] cfg Batch size and latency bound. \a max_frames must be
+ *            between 1 and the hand-off queue length.
+ *
+ * \return WM_SUCCESS on success or -WM_E_INVAL on invalid parameters.
+ */
+int net_set_rx_batch_config(const struct net_rx_batch_config *cfg);
+
+/** Get RX batch hand-off statistics
+ *
+ * \param[out] stats Batch and TCP/IP message counters.
+ *
+ * \return WM_SUCCESS on success or -WM_E_INVAL if \a stats is NULL.
+ */
+int net_get_rx_batch_stats(struct net_rx_batch_stats *stats);
+
+/** Reset RX batch hand-off statistics
+ */
+void net_reset_rx_batch_stats(void);
+#endif
+
+/** Standard Ethernet MTU, used for peers not known to take more */
+#define NET_MTU_DEFAULT 1500U
+
+#ifdef CONFIG_WIFI_MAX_MTU
+/** Large MTU statistics
+ *
+ * The same counters are part of the Wi-Fi statistics set as
+ * WIFI_STAT_MTU_TX_LARGE to WIFI_STAT_MTU_PEERS_LEARNED.
+ */
+struct net_mtu_stats
+{
+    /** Frames sent above the standard MTU */
+    uint32_t tx_large;
+    /** IPv4 datagrams fragmented again for a peer with a smaller MTU */
+    uint32_t tx_refrag;
+    /** Frames dropped because they exceeded the MTU of their destination */
+    uint32_t tx_drop;
+    /** Peers found to take more than the standard MTU */
+    uint32_t peers_learned;
+};
+
+/** Set the MTU of an interface
+ *
+ * Interfaces start at NET_MTU_DEFAULT. Frames to a peer not known to take
+ * this MTU are kept to NET_MTU_DEFAULT. The IPv6 MTU is not raised.
+ *
+ * \param[in] bss_type WLAN_BSS_TYPE_STA or WLAN_BSS_TYPE_UAP.
+ * \param[in] mtu MTU between NET_MTU_DEFAULT and CONFIG_WIFI_MAX_MTU.
+ *
+ * \return WM_SUCCESS on success or -WM_E_INVAL on invalid parameters.
+ */
+int net_set_mtu(enum wlan_bss_type bss_type, uint16_t mtu);
+
+/** Get the MTU of an interface
+ *
+ * \param[in] bss_type WLAN_BSS_TYPE_STA or WLAN_BSS_TYPE_UAP.
+ * \param[out] mtu Current MTU.
+ *
+ * \return WM_SUCCESS on success or -WM_E_INVAL on invalid parameters.
+ */
+int net_get_mtu(enum wlan_bss_type bss_type, uint16_t *mtu);
+
+/** Set the MTU a peer takes
+ *
+ * Peers that send a packet above NET_MTU_DEFAULT are also learned
+ * automatically.
+ *
+ * \param[in] mac Unicast MAC address of the peer.
+ * \param[in] mtu MTU between NET_MTU_DEFAULT and CONFIG_WIFI_MAX_MTU.
+ *            NET_MTU_DEFAULT forgets the peer.
+ *
+ * \return WM_SUCCESS on success or -WM_E_INVAL on invalid parameters.
+ */
+int net_set_peer_mtu(const uint8_t *mac, uint16_t mtu);
+
+/** Get large MTU statistics
+ *
+ * \param[out] stats Large frame, fragmentation and drop counters since the
+ *                   last wifi_stats_reset().
+ *
+ * \return WM_SUCCESS on success or -WM_E_INVAL if \a stats is NULL.
+ */
+int net_get_mtu_stats(struct net_mtu_stats *stats);
+#endif
 
 #ifndef CONFIG_WPA_SUPP
 void rx_mgmt_register_callback(int (*rx_mgmt_cb_fn)(const enum wlan_bss_type bss_type,
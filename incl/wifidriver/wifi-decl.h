@@ -331,6 +331,103 @@ struct wifi_scan_result2
 #endif
 };
 
+/** Read-only view of one scan table entry.
+ *
+ *  The cheap fields point straight into the driver scan table and stay valid
+ *  only for the duration of the visit. Security and capability info are
+ *  decoded on request from the driver BSS descriptor.
+ */
+typedef struct
+{
+    /** Index of the entry in the scan table */
+    unsigned int index;
+    /** BSSID */
+    const uint8_t *bssid;
+    /** SSID, not NUL terminated */
+    const uint8_t *ssid;
+    /** SSID length */
+    uint8_t ssid_len;
+    /** Channel associated to the BSSID */
+    uint8_t channel;
+    /** Received signal strength (absolute value in dBm) */
+    uint8_t rssi;
+    /** Is bssid an IBSS? */
+    bool is_ibss_bit_set;
+    /** Band info */
+    uint16_t band;
+    /** Beacon period */
+    uint16_t beacon_period;
+    /** Driver BSS descriptor, private to the decoders */
+    const void *bss;
+} wifi_scan_view_t;
+
+/** Capability info decoded from a \ref wifi_scan_view_t */
+typedef struct
+{
+    /** HT capabilities IE present */
+    bool ht;
+    /** HT information IE present */
+    bool ht_info;
+    /** VHT capabilities IE present */
+    bool vht;
+    /** WMM IE present */
+    bool wmm;
+    /** WPS IE present */
+    bool wps;
+    /** Mobility domain IE present (802.11r) */
+    bool mobility_domain;
+    /** Mobility domain identifier */
+    uint16_t mdid;
+    /** Neighbor report supported (802.11k) */
+    bool neighbor_report_supported;
+    /** BSS transition supported (802.11v) */
+    bool bss_transition_supported;
+    /** MBO association disallowed */
+    bool mbo_assoc_disallowed;
+} wifi_scan_caps_t;
+
+/** Security info decoded from a \ref wifi_scan_view_t */
+typedef struct
+{
+    /** Security mode info */
+    _SecurityMode_t sec;
+    /** MFPC bit of AP */
+    uint8_t ap_mfpc;
+    /** MFPR bit of AP */
+    uint8_t ap_mfpr;
+} wifi_scan_security_t;
+
+/** Scan table visitor, return non-zero to stop the walk */
+typedef int (*wifi_scan_visit_fn_t)(const wifi_scan_view_t *view, void *arg);
+
+/** Sort key for a scan table entry, entries are ordered by descending key */
+typedef int32_t (*wifi_scan_key_fn_t)(const wifi_scan_view_t *view, void *arg);
+
+/** Scan table memory use and beacon handling cost */
+typedef struct
+{
+    /** Entries in the scan table */
+    uint32_t entries;
+    /** Size of one scan table slot in bytes */
+    uint32_t slot_bytes;
+    /** Size of the IE copies each slot would embed without CONFIG_COMPACT_SCAN_TABLE */
+    uint32_t inline_ie_bytes;
+    /** Shared IE arena size in bytes, 0 without CONFIG_COMPACT_SCAN_TABLE */
+    uint32_t arena_bytes;
+    /** Arena bytes in use, including blobs of replaced entries */
+    uint32_t arena_used;
+    /** Optional IEs dropped because the arena was full */
+    uint32_t ie_dropped;
+    /** Beacons and probe responses parsed */
+    uint32_t parse_cnt;
+    /** Total parse time in microseconds */
+    uint32_t parse_us;
+    /** Entries stored in the table */
+    uint32_t store_cnt;
+    /** Total time storing entries, IE packing included, in microseconds */
+    uint32_t store_us;
+} wifi_scan_mem_stats_t;
+
 /** MAC address */
 typedef struct
 {
@@ -811,6 +908,406 @@ typedef struct
     int16_t bcn_nf_avg;
 } wifi_rssi_info_t;
 
+/** Link quality derived from received data packets */
+typedef struct
+{
+    /** RSSI of the last packet in dBm */
+    int16_t rssi_last;
+    /** Exponentially weighted RSSI average in dBm */
+    int16_t rssi_avg;
+    /** Mean RSSI over the last window of packets in dBm */
+    int16_t rssi_win_avg;
+    /** Lowest RSSI over the last window of packets in dBm */
+    int16_t rssi_win_min;
+    /** Highest RSSI over the last window of packets in dBm */
+    int16_t rssi_win_max;
+    /** SNR of the last packet in dB */
+    int16_t snr_last;
+    /** Exponentially weighted SNR average in dB */
+    int16_t snr_avg;
+    /** Noise floor of the last packet in dBm */
+    int16_t nf_last;
+    /** Exponentially weighted noise floor average in dBm */
+    int16_t nf_avg;
+    /** RxPD rate index of the last packet */
+    uint8_t rx_rate;
+    /** RxPD rate info (format, bandwidth, GI) of the last packet */
+    uint8_t rate_info;
+    /** Number of packets accounted */
+    uint32_t rx_pkts;
+    /** Milliseconds since the last packet was received */
+    uint32_t age_ms;
+} wifi_link_stats_t;
+
+/** TX aggregation auto tuner decisions for one peer and access category */
+typedef struct
+{
+    /** True when tuned for throughput, false when tuned for latency */
+    bool bulk;
+    /** True when the tuner lets the peer use A-MSDU aggregation, advisory
+     *  unless the driver is built with AMSDU_IN_AMPDU */
+    bool amsdu_allowed;
+    /** A-MSDU size limit in bytes, advisory unless the driver is built
+     *  with AMSDU_IN_AMPDU */
+    uint16_t amsdu_limit;
+    /** True when the peer may trigger block ack setup */
+    bool ba_allowed;
+    /** Number of mode switches */
+    uint16_t switches;
+    /** Throughput over the last observation window in kbps */
+    uint32_t tput_kbps;
+    /** Average queue depth over the last observation window */
+    uint8_t queue_depth;
+    /** Percentage of small packets over the last observation window */
+    uint8_t small_pct;
+    /** Packets dropped in the host queues */
+    uint16_t drop_count;
+} wifi_aggr_tune_stats_t;
+
+/** Data path primitives backend
+ *
+ * Members left NULL keep the built-in implementation.
+ */
+typedef struct
+{
+    /** Copy \a len bytes from \a src to \a dst */
+    void (*copy)(void *dst, const void *src, uint32_t len);
+    /** Copy \a len bytes and return the Internet checksum of the copied
+     *  data, not complemented, as computed by lwIP's LWIP_CHKSUM() */
+    uint16_t (*copy_chksum)(void *dst, const void *src, uint32_t len);
+    /** Return the Internet checksum of \a len bytes, not complemented */
+    uint16_t (*chksum)(const void *data, uint32_t len);
+    /** Copy with a DMA engine, the copy must be complete on return. Calls
+     * never overlap, a copy issued while the engine is busy uses \a copy */
+    void (*dma_copy)(void *dst, const void *src, uint32_t len);
+    /** Copies of at least this many bytes use \a dma_copy */
+    uint32_t dma_min_len;
+} wifi_dp_ops_t;
+
+/** TX buffer pool statistics */
+typedef struct
+{
+    /** Buffers in internal RAM */
+    uint16_t int_total;
+    /** Internal buffers in use */
+    uint16_t int_used;
+    /** Most internal buffers in use at once */
+    uint16_t int_peak;
+    /** Buffers in the external region */
+    uint16_t ext_total;
+    /** External buffers in use */
+    uint16_t ext_used;
+    /** Most external buffers in use at once */
+    uint16_t ext_peak;
+    /** Packets queued in an external buffer */
+    uint32_t ext_queued;
+    /** External packets moved to internal RAM for transmission */
+    uint32_t promoted;
+} wifi_tx_buf_pool_stats_t;
+
+/** Shared TX scheduler statistics of one interface */
+typedef struct
+{
+    /** TX weight */
+    uint8_t weight;
+    /** Packets queued now */
+    uint32_t queued;
+    /** Packets sent by the scheduler */
+    uint32_t sent;
+    /** Frames refused because the interface held its share of buffers */
+    uint32_t share_drops;
+} wifi_bss_tx_sched_stats_t;
+
+/** SDIO register access statistics */
+typedef struct
+{
+    /** Interrupt register image reads */
+    uint32_t int_reads;
+    /** Command port length reads */
+    uint32_t cmd_len_reads;
+    /** Write port bitmap reads by TX when out of ports */
+    uint32_t wr_refreshes;
+    /** Register bytes read */
+    uint32_t reg_bytes;
+    /** Data packets received */
+    uint32_t rx_pkts;
+    /** Data packets sent */
+    uint32_t tx_pkts;
+    /** Register reads per 1000 data packets */
+    uint32_t reads_per_1k_pkts;
+} wifi_sdio_reg_stats_t;
+
+/** Channel switch statistics of one interface */
+typedef struct
+{
+    /** True while TX is held for a channel switch */
+    bool in_progress;
+    /** Completed channel switches */
+    uint32_t count;
+    /** Channel switches which never reported completion */
+    uint32_t timeouts;
+    /** Channel of the last switch */
+    uint8_t last_channel;
+    /** TX outage of the last switch in milliseconds */
+    uint32_t last_outage_ms;
+    /** Longest TX outage in milliseconds */
+    uint32_t max_outage_ms;
+    /** Frames queued and kept during the last switch */
+    uint16_t last_retained;
+    /** Frames refused during the last switch */
+    uint16_t last_dropped;
+} wifi_chan_switch_stats_t;
+
+/** Remain on channel coordinator configuration */
+typedef struct
+{
+    /** Longest time off the home channel in one go while connected, in
+     *  milliseconds. Longer requests are served in slices. 0 disables
+     *  slicing. */
+    uint32_t max_slice_ms;
+    /** Time spent on the home channel between slices in milliseconds */
+    uint32_t home_ms;
+} wifi_roc_config_t;
+
+/** Remain on channel statistics */
+typedef struct
+{
+    /** True while a request is being served */
+    bool in_progress;
+    /** Completed requests */
+    uint32_t count;
+    /** Requests cancelled before their duration was served */
+    uint32_t cancelled;
+    /** Slices which never reported expiry */
+    uint32_t timeouts;
+    /** Requested duration of the last request in milliseconds */
+    uint32_t last_duration_ms;
+    /** Slices the last request was served in */
+    uint16_t last_slices;
+    /** Home channel TX outage of the last request in milliseconds */
+    uint32_t last_outage_ms;
+    /** Longest continuous outage of the last request in milliseconds */
+    uint32_t last_max_gap_ms;
+    /** Longest continuous outage of any request in milliseconds */
+    uint32_t max_gap_ms;
+} wifi_roc_stats_t;
+
+/** Coexistence controller made no change */
+#define WIFI_COEX_CTRL_HOLD 0U
+/** Coexistence controller gave BT more time, BT latency over budget */
+#define WIFI_COEX_CTRL_TO_BT_LATENCY 1U
+/** Coexistence controller gave Wi-Fi more time, Wi-Fi queue under pressure */
+#define WIFI_COEX_CTRL_TO_WIFI_LOAD 2U
+/** Coexistence controller gave time back to BT, Wi-Fi queue idle */
+#define WIFI_COEX_CTRL_TO_BT_IDLE 3U
+
+/** Adaptive coexistence duty cycle controller configuration */
+typedef struct
+{
+    /** Drive the dual antenna duty cycle instead of the single antenna one */
+    bool dual_ant;
+    /** Duty cycle period */
+    uint16_t total_time;
+    /** Least BT time per period */
+    uint16_t nb_time_min;
+    /** Most BT time per period, also the starting point */
+    uint16_t nb_time_max;
+    /** BT time moved per adjustment */
+    uint16_t nb_time_step;
+    /** WLAN block time, dual antenna only */
+    uint16_t far_range_time;
+    /** Sampling period in milliseconds */
+    uint32_t period_ms;
+    /** Consecutive samples which must agree before an adjustment */
+    uint8_t hysteresis;
+    /** BT latency budget in milliseconds */
+    uint32_t bt_latency_budget_ms;
+    /** Wi-Fi TX queue depth at or above which Wi-Fi asks for time */
+    uint32_t wifi_queue_high;
+    /** Wi-Fi TX queue depth at or below which Wi-Fi gives time back */
+    uint32_t wifi_queue_low;
+} wifi_coex_ctrl_config_t;
+
+/** Adaptive coexistence duty cycle controller statistics */
+typedef struct
+{
+    /** True while the controller runs */
+    bool running;
+    /** BT time currently applied */
+    uint16_t nb_time;
+    /** Duty cycle changes applied */
+    uint32_t adjustments;
+    /** Adjustments in favour of Wi-Fi */
+    uint32_t to_wifi;
+    /** Adjustments in favour of BT */
+    uint32_t to_bt;
+    /** Reason of the last decision, WIFI_COEX_CTRL_* */
+    uint8_t last_reason;
+    /** Wi-Fi TX queue depth at the last sample */
+    uint32_t wifi_queued;
+    /** Wi-Fi TX drops during the last period */
+    uint32_t wifi_drops;
+    /** Last BT latency reported in milliseconds, 0 once a period passes
+     *  without a report */
+    uint32_t bt_latency_ms;
+} wifi_coex_ctrl_stats_t;
+
+/** Cause of a detected firmware hang */
+typedef enum
+{
+    /** No hang */
+    WIFI_HANG_NONE = 0,
+    /** A command got no response within the watchdog period */
+    WIFI_HANG_CMD_TIMEOUT,
+    /** Reads of received data from the card kept failing */
+    WIFI_HANG_RX_STALL,
+} wifi_hang_reason_t;
+
+/** Firmware hang recovery configuration */
+typedef struct
+{
+    /** Command response watchdog in milliseconds, 0 keeps the default */
+    uint32_t cmd_timeout_ms;
+    /** Probe the firmware after this many milliseconds without a command response, 0 disables probing */
+    uint32_t probe_interval_ms;
+    /** Board hook resetting the module before firmware download, may be NULL */
+    void (*card_reset)(void);
+} wifi_recovery_config_t;
+
+/** Firmware hang recovery statistics */
+typedef struct
+{
+    /** Hangs detected */
+    uint32_t hangs;
+    /** Successful recoveries */
+    uint32_t recoveries;
+    /** Recoveries which failed to bring the firmware back */
+    uint32_t failures;
+    /** Liveness probes sent */
+    uint32_t probes;
+    /** Cause of the last hang, \ref wifi_hang_reason_t */
+    uint8_t last_reason;
+    /** Time from hang detection to restored configuration of the last recovery */
+    uint32_t last_downtime_ms;
+    /** Longest downtime in milliseconds */
+    uint32_t max_downtime_ms;
+} wifi_recovery_stats_t;
+
+/** Firmware boot statistics */
+typedef struct
+{
+    /** Last boot reused the firmware already running on the card */
+    bool warm;
+    /** Duration of the last boot in milliseconds */
+    uint32_t boot_ms;
+    /** Boots that reused the running firmware */
+    uint32_t warm_starts;
+    /** Boots that downloaded the firmware */
+    uint32_t cold_starts;
+    /** Running firmware found but rejected by the version check */
+    uint32_t warm_rejects;
+} wifi_fw_boot_stats_t;
+
+/** uAP station setup statistics */
+typedef struct
+{
+    /** Clients authorised */
+    uint32_t authorized;
+    /** Clients added but not yet authorised */
+    uint32_t pending;
+    /** Average time from station add to authorised in milliseconds */
+    uint32_t avg_ms;
+    /** Time to authorised of the last client in milliseconds */
+    uint32_t last_ms;
+    /** Longest time to authorised in milliseconds */
+    uint32_t max_ms;
+    /** Station add commands sent to firmware */
+    uint32_t fw_cmds;
+    /** Repeated station add requests answered without firmware */
+    uint32_t skipped;
+} wifi_uap_sta_setup_stats_t;
+
+/** Wi-Fi statistics counters
+ *
+ *  The counter set is fixed at build time. Per BSS counters are laid out
+ *  once for the station and repeated for the uAP, use \ref WIFI_STAT_BSS
+ *  to select the uAP copy. New counters are added after the uAP copies so
+ *  the exported numbering of existing counters never changes.
+ *
+ *  Only event counters with a fixed identity belong here. Per peer and per
+ *  RA list records (link monitor, aggregation tuner), levels and last
+ *  values (queue depth, pool use, coex state, boot time) and accumulated
+ *  durations keep their own statistics struct next to the feature, since
+ *  a delta or a reset of the counter set has no meaning for them.
+ */
+typedef enum
+{
+    /** Frames handed to the driver for transmission */
+    WIFI_STAT_LINK_XMIT = 0,
+    /** Frames passed to the network stack */
+    WIFI_STAT_LINK_RECV,
+    /** Frames dropped by the network interface */
+    WIFI_STAT_LINK_DROP,
+    /** Frames dropped for lack of a pbuf */
+    WIFI_STAT_LINK_MEMERR,
+    /** Transmit errors */
+    WIFI_STAT_LINK_ERR,
+    /** Malformed frames */
+    WIFI_STAT_LINK_PROTERR,
+    /** Station frames dropped while not connected */
+    WIFI_STAT_TX_NO_MEDIA,
+    /** Station frames dropped for lack of a TX buffer */
+    WIFI_STAT_TX_ERR_MEM,
+    /** Station frames dropped after retries */
+    WIFI_STAT_TX_WMM_RETRIED_DROP,
+    /** Station frames dropped on a paused RA list */
+    WIFI_STAT_TX_WMM_PAUSE_DROP,
+    /** Station frames replaced on a full paused RA list */
+    WIFI_STAT_TX_WMM_PAUSE_REPLACED,
+    /** Station frames expired in the RA list */
+    WIFI_STAT_TX_WMM_EXPIRED_DROP,
+    /** Station frames dropped by RX reordering */
+    WIFI_STAT_RX_REORDER_DROP,
+    /** uAP copies of the per BSS counters start here */
+    WIFI_STAT_UAP_BASE,
+    /** Frames sent above the standard MTU, zero without CONFIG_WIFI_MAX_MTU */
+    WIFI_STAT_MTU_TX_LARGE = WIFI_STAT_UAP_BASE + (WIFI_STAT_UAP_BASE - WIFI_STAT_TX_NO_MEDIA),
+    /** IPv4 datagrams fragmented again for a peer with a smaller MTU, zero
+     *  without CONFIG_WIFI_MAX_MTU */
+    WIFI_STAT_MTU_TX_REFRAG,
+    /** Frames dropped because they exceeded the MTU of their destination,
+     *  zero without CONFIG_WIFI_MAX_MTU */
+    WIFI_STAT_MTU_TX_DROP,
+    /** Peers found to take more than the standard MTU, zero without
+     *  CONFIG_WIFI_MAX_MTU */
+    WIFI_STAT_MTU_PEERS_LEARNED,
+    /** RX drain posts refused because the TCP/IP mbox was full and retried,
+     *  zero without CONFIG_WIFI_RX_PRIO or CONFIG_WIFI_RX_BATCH */
+    WIFI_STAT_RX_HANDOFF_POST_FAIL,
+    /** Number of counters */
+    WIFI_STAT_NUM,
+} wifi_stat_id_t;
+
+/** Select the copy of a per BSS counter for \a bss_type */
+#define WIFI_STAT_BSS(bss_type, id) \
+    ((wifi_stat_id_t)(((bss_type) == BSS_TYPE_UAP) ? ((id) + WIFI_STAT_UAP_BASE - WIFI_STAT_TX_NO_MEDIA) : (id)))
+
+/** Snapshot of the Wi-Fi statistics counters */
+typedef struct
+{
+    /** Time the snapshot was taken in milliseconds */
+    uint32_t time_ms;
+    /** Incremented on every reset, deltas across a reset start from zero */
+    uint32_t epoch;
+    /** Counter values since the last reset, indexed by \ref wifi_stat_id_t */
+    uint32_t cnt[WIFI_STAT_NUM];
+} wifi_stats_snapshot_t;
+
+/** Version of the binary format written by wifi_stats_export() */
+#define WIFI_STATS_EXPORT_VERSION 1U
+/** Largest buffer wifi_stats_export() can need */
+#define WIFI_STATS_EXPORT_MAX_LEN (12U + (5U * (uint32_t)WIFI_STAT_NUM))
+
 /**
  * Data structure for subband set
  *
@@ -959,6 +1456,17 @@ typedef PACK_START struct
 } PACK_END wifi_txpwrlimit_t;
 
 
+/** TSF read from firmware together with the host time bracketing the access */
+typedef struct
+{
+    /** TSF reported by firmware */
+    t_u64 tsf;
+    /** os_get_timestamp() just before the command is sent to the card */
+    t_u32 tx_us;
+    /** os_get_timestamp() when the command response is processed */
+    t_u32 rx_us;
+} wifi_tsf_sample_t;
+
 #ifdef CONFIG_WIFI_CLOCKSYNC
 typedef PACK_START struct
 {
@@ -51,6 +51,11 @@ extern uint8_t g_rssi;
 extern uint16_t g_data_nf_last;
 extern uint16_t g_data_snr_last;
 
+/* Packets kept in the RSSI window of the link monitor */
+#define WIFI_LINK_MON_WINDOW 16U
+/* Stations tracked per uAP by the link monitor */
+#define WIFI_LINK_MON_MAX_STA 8U
+
 /** WiFi Error Code */
 enum
 {
@@ -167,7 +172,8 @@ void wifi_deregister_data_input_callback(void);
  * processed AMSDU DATA from Wi-Fi driver.
  *
  * This callback function is used to send data received from Wi-Fi
- * firmware to the networking stack.
+ * firmware to the networking stack. Each subframe is passed with the
+ * user priority from the RxPD of its A-MSDU.
  *
  * @param[in] amsdu_data_intput_callback Function that needs to be called
  *
@@ -176,7 +182,8 @@ void wifi_deregister_data_input_callback(void);
  */
 int wifi_register_amsdu_data_input_callback(void (*amsdu_data_intput_callback)(uint8_t interface,
                                                                                uint8_t *buffer,
-                                                                               uint16_t len));
+                                                                               uint16_t len,
+                                                                               uint8_t priority));
 
 /** Deregister Data callback function from Wi-Fi Driver */
 void wifi_deregister_amsdu_data_input_callback(void);
@@ -191,6 +198,23 @@ int wifi_register_wrapper_net_is_ip_or_ipv6_callback(bool (*wrapper_net_is_ip_or
 
 void wifi_deregister_wrapper_net_is_ip_or_ipv6_callback(void);
 
+#ifdef CONFIG_WIFI_RX_BATCH
+/**
+ * Register a callback invoked after each SDIO read cycle.
+ *
+ * The networking stack uses it to hand frames accumulated during the
+ * cycle to the TCP/IP thread in one batch.
+ *
+ * @param[in] rx_batch_end_callback Function that needs to be called
+ *
+ * @return WM_SUCCESS
+ */
+int wifi_register_rx_batch_end_callback(void (*rx_batch_end_callback)(void));
+
+/** Deregister the SDIO read cycle callback */
+void wifi_deregister_rx_batch_end_callback(void);
+#endif
+
 /**
  * Wi-Fi Driver low level output function.
  *
@@ -425,6 +449,51 @@ int wifi_unregister_event_queue(os_queue_t *event_queue);
  */
 int wifi_get_scan_result(unsigned int index, struct wifi_scan_result2 **desc);
 
+/** Walk the scan table without copying the entries
+ *
+ * The caller must make sure no scan updates the table during the walk.
+ *
+ * @param[in] visit Called once per entry with a read-only view, a non-zero
+ * return value stops the walk
+ * @param[in] arg Opaque argument passed to \a visit
+ *
+ * @return Number of entries visited or -WM_E_INVAL.
+ */
+int wifi_scan_foreach(wifi_scan_visit_fn_t visit, void *arg);
+
+/** Get scan table indices ordered by descending key
+ *
+ * Every entry is ranked, only the best \a count indices are returned.
+ * The caller must make sure no scan updates the table meanwhile.
+ *
+ * @param[out] idx Array receiving the scan table indices
+ * @param[in,out] count Size of \a idx on input, number of indices stored
+ * on output
+ * @param[in] key Sort key, NULL orders by signal strength (strongest first)
+ * @param[in] arg Opaque argument passed to \a key
+ *
+ * @return WM_SUCCESS on success or error code.
+ */
+int wifi_scan_sort_index(uint16_t *idx, unsigned int *count, wifi_scan_key_fn_t key, void *arg);
+
+/** Decode security info of a scan table entry
+ *
+ * @param[in] view Scan table entry view
+ * @param[out] security Decoded security info
+ *
+ * @return WM_SUCCESS on success or error code.
+ */
+int wifi_scan_view_get_security(const wifi_scan_view_t *view, wifi_scan_security_t *security);
+
+/** Decode capability info of a scan table entry
+ *
+ * @param[in] view Scan table entry view
+ * @param[out] caps Decoded capability info
+ *
+ * @return WM_SUCCESS on success or error code.
+ */
+int wifi_scan_view_get_caps(const wifi_scan_view_t *view, wifi_scan_caps_t *caps);
+
 /**
  * Get the count of elements in the scan list
  *
@@ -443,6 +512,14 @@ int wifi_get_scan_result(unsigned int index, struct wifi_scan_result2 **desc);
  */
 int wifi_get_scan_result_count(unsigned *count);
 
+/** Get scan table memory use and beacon parse and store cost
+ *
+ * @param[out] stats Filled with the current figures
+ *
+ * @return WM_SUCCESS or -WM_E_INVAL if \a stats is NULL.
+ */
+int wifi_get_scan_mem_stats(wifi_scan_mem_stats_t *stats);
+
 /**
  * Returns the current STA list connected to our uAP
  *
@@ -762,8 +839,19 @@ bool wifi_get_xfer_pending(void);
 void wifi_set_xfer_pending(bool xfer_val);
 int wrapper_wlan_cmd_11n_ba_stream_timeout(void *saved_event_buff);
 
+void wifi_link_mon_rx(t_u8 interface, const t_u8 *src_mac, t_s8 snr, t_s8 nf, t_u8 rx_rate, t_u8 rate_info);
+int wifi_link_mon_get(t_u8 interface, const t_u8 *mac, wifi_link_stats_t *stats);
+void wifi_link_mon_reset(t_u8 interface);
+
 int wifi_set_txratecfg(wifi_ds_rate ds_rate, mlan_bss_type bss_type);
 int wifi_get_txratecfg(wifi_ds_rate *ds_rate, mlan_bss_type bss_type);
+int wifi_set_tx_ctrl_policy(mlan_bss_type bss_type, t_u8 user_prio, t_u32 tx_control, t_u16 expiry_ms);
+int wifi_chan_switch_prepare(mlan_bss_type bss_type);
+int wifi_get_chan_switch_stats(mlan_bss_type bss_type, wifi_chan_switch_stats_t *stats);
+int wifi_roc_request(unsigned int bss_type, const wifi_remain_on_channel_t *roc, bool sliced);
+void wifi_roc_next_slice(void);
+int wifi_set_roc_config(const wifi_roc_config_t *cfg);
+int wifi_get_roc_stats(wifi_roc_stats_t *stats);
 void wifi_wake_up_card(uint32_t *resp);
 
 
@@ -969,6 +1057,7 @@ int wifi_raw_packet_recv(t_u8 **data, t_u32 *pkt_type);
 #ifdef CONFIG_WIFI_CLOCKSYNC
 int wifi_set_clocksync_cfg(const wifi_clock_sync_gpio_tsf_t *tsf_latch, mlan_bss_type bss_type);
 int wifi_get_tsf_info(wifi_tsf_info_t *tsf_info);
+int wifi_get_tsf_sample(wifi_tsf_sample_t *sample);
 #endif /* CONFIG_WIFI_CLOCKSYNC */
 
 #ifdef CONFIG_RF_TEST_MODE
@@ -1078,15 +1167,185 @@ void wifi_register_fw_dump_cb(int (*wifi_usb_mount_cb)(),
                               int (*wifi_usb_file_close_cb)());
 #endif
 
+/* Wi-Fi statistics counters, indexed by wifi_stat_id_t. Use the
+ * accessors below, the values include counts from before the last
+ * reset. */
+extern volatile uint32_t wifi_stats_cnt[WIFI_STAT_NUM];
+
+/** Add to a statistics counter
+ *
+ * Lock free on cores with exclusive access instructions, where the
+ * update is a relaxed atomic add usable from tasks and interrupts alike.
+ * Elsewhere it falls back to a short critical section.
+ *
+ * \param[in] id Counter to update.
+ * \param[in] n Value to add.
+ */
+static inline void wifi_stats_add(wifi_stat_id_t id, uint32_t n)
+{
+#if defined(__ATOMIC_RELAXED) && !defined(__ARM_ARCH_6M__)
+    (void)__atomic_fetch_add(&wifi_stats_cnt[id], n, __ATOMIC_RELAXED);
+#else
+    unsigned long sta = os_enter_critical_section();
+    wifi_stats_cnt[id] += n;
+    os_exit_critical_section(sta);
+#endif
+}
+
+/** Increment a statistics counter, see wifi_stats_add() */
+static inline void wifi_stats_inc(wifi_stat_id_t id)
+{
+    wifi_stats_add(id, 1U);
+}
+
+/** Take a snapshot of all statistics counters
+ *
+ * Writers are never blocked. Each counter is read once, the snapshot is
+ * retried if a reset runs concurrently so it never mixes values from
+ * before and after a reset.
+ *
+ * \param[out] snap Filled with the counter values since the last reset.
+ *
+ * \return WM_SUCCESS on success or -WM_E_INVAL if \a snap is NULL.
+ */
+int wifi_stats_snapshot(wifi_stats_snapshot_t *snap);
+
+/** Compute the counter changes between two snapshots
+ *
+ * \param[in] prev Older snapshot.
+ * \param[in] cur Newer snapshot.
+ * \param[out] delta Counter changes, \a time_ms holds the elapsed time.
+ *                   If a reset happened in between, the values of \a cur
+ *                   are returned. May alias \a cur.
+ *
+ * \return WM_SUCCESS on success or -WM_E_INVAL on a NULL argument.
+ */
+int wifi_stats_delta(const wifi_stats_snapshot_t *prev,
+                     const wifi_stats_snapshot_t *cur,
+                     wifi_stats_snapshot_t *delta);
+
+/** Restart all statistics counters from zero */
+void wifi_stats_reset(void);
+
+/** Get the name of a statistics counter
+ *
+ * \param[in] id Counter.
+ *
+ * \return Counter name, or NULL if \a id is out of range.
+ */
+const char *wifi_stats_name(wifi_stat_id_t id);
+
+/** Serialize a snapshot in the compact binary telemetry format
+ *
+ * The format is a 12 byte little endian header: magic "WS", version
+ * \ref WIFI_STATS_EXPORT_VERSION, number of counters, time_ms and epoch.
+ * It is followed by every counter as an unsigned LEB128 varint, so idle
+ * counters take a single byte. Counters added later are appended, older
+ * readers skip what they do not know.
+ *
+ * \param[in] snap Snapshot or delta to serialize.
+ * \param[out] buf Output buffer, \ref WIFI_STATS_EXPORT_MAX_LEN always fits.
+ * \param[in] buf_len Size of \a buf.
+ * \param[out] out_len Bytes written.
+ *
+ * \return WM_SUCCESS on success, -WM_E_INVAL on a NULL argument or
+ *         -WM_E_NOMEM if \a buf is too small.
+ */
+int wifi_stats_export(const wifi_stats_snapshot_t *snap, uint8_t *buf, uint32_t buf_len, uint32_t *out_len);
+
 #ifdef CONFIG_WMM
 void wifi_wmm_init();
 t_u32 wifi_wmm_get_pkt_prio(t_u8 *buf, t_u8 *tid);
-t_u8 wifi_wmm_get_packet_cnt(void);
+t_u32 wifi_wmm_get_packet_cnt(void);
 /* handle EVENT_TX_DATA_PAUSE */
 void wifi_handle_event_data_pause(void *data);
 void wifi_wmm_tx_stats_dump(int bss_type);
+void wifi_set_aggr_auto_tune(bool enable);
+int wifi_get_aggr_tune_stats(int bss_type, const t_u8 *mac, t_u8 ac, wifi_aggr_tune_stats_t *stats);
+int wifi_set_tx_ext_buf_region(uint8_t *region, uint32_t len);
+int wifi_get_tx_buf_pool_stats(wifi_tx_buf_pool_stats_t *stats);
+int wifi_set_bss_tx_weight(mlan_bss_type bss_type, t_u8 weight);
+int wifi_get_bss_tx_sched_stats(mlan_bss_type bss_type, wifi_bss_tx_sched_stats_t *stats);
+/* Packets queued for TX and the running sum of TX drops, which wraps at 16 bits */
+int wifi_get_wmm_load(int bss_type, t_u32 *queued, t_u32 *dropped);
 #endif /* CONFIG_WMM */
 
+#ifdef CONFIG_WIFI_RECOVERY
+/** Register the handler told about firmware hangs
+ *
+ * \param[in] cb Handler, called once per hang from driver context. NULL
+ *               restores the assert on command timeout.
+ */
+void wifi_set_hang_cb(void (*cb)(wifi_hang_reason_t reason));
+
+/** Set the command response watchdog
+ *
+ * \param[in] timeout_ms Watchdog in milliseconds, 0 restores the default.
+ */
+void wifi_set_cmd_timeout(uint32_t timeout_ms);
+#endif
+
+#ifdef CONFIG_WIFI_WARM_START
+/** Allow the next wifi_init() to reuse firmware already running on the card
+ *
+ * \param[in] fw_version Extended version string the running firmware must
+ *                       report, empty string accepts any version. NULL
+ *                       disables warm start.
+ */
+void wifi_set_fw_warm_start(const char *fw_version);
+
+/** Get firmware boot statistics
+ *
+ * \param[out] stats Filled with the statistics.
+ *
+ * \return WM_SUCCESS on success, -WM_E_INVAL if \a stats is NULL.
+ */
+int wifi_get_fw_boot_stats(wifi_fw_boot_stats_t *stats);
+#endif
+
+/** Get the multicast MAC addresses currently filtered
+ *
+ * \param[out] mlist Buffer for the addresses, \ref MLAN_MAC_ADDR_LENGTH bytes each.
+ * \param[in] maxlen Size of \a mlist in bytes.
+ *
+ * \return Number of addresses copied.
+ */
+int wifi_get_mcast_filter_list(uint8_t *mlist, int maxlen);
+
+/** Select the data path primitives backend
+ *
+ * \param[in] ops Backend, NULL restores the built-in one.
+ */
+void wifi_dp_set_ops(const wifi_dp_ops_t *ops);
+
+/** Copy data path bytes, large copies use the DMA backend if any */
+void wifi_dp_copy(void *dst, const void *src, uint32_t len);
+
+/** Copy data path bytes and return their Internet checksum
+ *
+ * Suitable as lwIP's LWIP_CHKSUM_COPY() with LWIP_CHECKSUM_ON_COPY.
+ */
+uint16_t wifi_dp_copy_chksum(void *dst, const void *src, uint32_t len);
+
+/** Return the Internet checksum of data path bytes
+ *
+ * Suitable as lwIP's LWIP_CHKSUM().
+ */
+uint16_t wifi_dp_chksum(const void *data, uint32_t len);
+
+#ifdef CONFIG_WIFI_SDIO_REG_CACHE
+/** Get SDIO register access statistics
+ *
+ * \param[out] stats Filled with the statistics.
+ *
+ * \return WM_SUCCESS on success, -WM_E_INVAL if \a stats is NULL.
+ */
+int wifi_get_sdio_reg_stats(wifi_sdio_reg_stats_t *stats);
+
+/** Clear SDIO register access statistics */
+void wifi_reset_sdio_reg_stats(void);
+#endif
+
 int wifi_set_rssi_low_threshold(uint8_t *low_rssi);
 
 #ifdef CONFIG_HEAP_DEBUG
@@ -1178,6 +1437,24 @@ t_u32 wifi_get_default_vht_capab();
 void wifi_uap_client_assoc(t_u8 *sta_addr, unsigned char is_11n_enabled);
 void wifi_uap_client_deauth(t_u8 *sta_addr);
 
+/** Get uAP station setup statistics
+ *
+ * \param[out] stats A pointer to \ref wifi_uap_sta_setup_stats_t.
+ *
+ * \return WM_SUCCESS on success or -WM_E_INVAL if \a stats is NULL.
+ */
+int wifi_uap_get_sta_setup_stats(wifi_uap_sta_setup_stats_t *stats);
+
+/** Get the time a uAP client took from station add to authorised
+ *
+ * \param[in] mac MAC address of the client.
+ * \param[out] time_ms Time in milliseconds, 0 while not yet authorised.
+ *
+ * \return WM_SUCCESS on success, -WM_E_INVAL on invalid arguments or
+ *         -WM_FAIL if the client is unknown.
+ */
+int wifi_uap_get_sta_setup_time(const uint8_t *mac, uint32_t *time_ms);
+
 #endif
 
 #endif /* __WIFI_H__ */
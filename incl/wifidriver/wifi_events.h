@@ -120,6 +120,8 @@ enum wifi_event
     WIFI_EVENT_REMAIN_ON_CHANNEL,
     /* Event to indicate Management tx status */
     WIFI_EVENT_MGMT_TX_STATUS,
+    /* Event to start the next slice of a remain on channel request */
+    WIFI_EVENT_REMAIN_ON_CHANNEL_SLICE,
     /** Event to indicate end of Wi-Fi events */
     WIFI_EVENT_LAST,
     /* other events can be added after this, however this must
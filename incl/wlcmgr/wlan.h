@@ -373,6 +373,13 @@ enum wlan_event_reason
        threshold and frequency. If CONFIG_11K, CONFIG_11V, CONFIG_11R or CONFIG_ROAMING enabled then RSSI low event is
        processed internally.*/
     WLAN_REASON_RSSI_LOW,
+    /** The firmware stopped responding and has been reloaded with the
+     *  previous configuration. The data is a pointer to
+     *  \ref wlan_recovery_stats_t. */
+    WLAN_REASON_FW_RECOVERED,
+    /** The firmware stopped responding and could not be reloaded. The WLAN
+     *  Connection Manager is left stopped. */
+    WLAN_REASON_FW_RECOVERY_FAILED,
 };
 
 /** Wakeup events for which wakeup will occur */
@@ -1075,6 +1082,27 @@ typedef wifi_clock_sync_gpio_tsf_t wlan_clock_sync_gpio_tsf_t;
  * \ref wifi_tsf_info_t
  */
 typedef wifi_tsf_info_t wlan_tsf_info_t;
+
+/** Host to TSF clock synchronization statistics */
+typedef struct
+{
+    /** Estimated host clock rate error relative to TSF in ppb */
+    int32_t drift_ppb;
+    /** Residual of the last accepted sample in microseconds */
+    int32_t last_residual_us;
+    /** Largest absolute residual while slewing in microseconds */
+    uint32_t max_abs_residual_us;
+    /** Current error bound used to reject slow samples in microseconds */
+    uint32_t min_err_us;
+    /** Number of samples fed */
+    uint32_t samples;
+    /** Samples rejected because of a large round trip */
+    uint32_t rejected;
+    /** Number of times the model was re-anchored */
+    uint32_t steps;
+    /** True when the residual is within the lock threshold */
+    bool locked;
+} wlan_clock_sync_stats_t;
 #endif
 
 
@@ -1089,6 +1117,117 @@ typedef wifi_mgmt_frame_t wlan_mgmt_frame_t;
  */
 typedef wifi_rssi_info_t wlan_rssi_info_t;
 
+/** Link quality derived from received data packets
+ * \ref wifi_link_stats_t
+ */
+typedef wifi_link_stats_t wlan_link_stats_t;
+
+/** TX aggregation auto tuner decisions
+ * \ref wifi_aggr_tune_stats_t
+ */
+typedef wifi_aggr_tune_stats_t wlan_aggr_tune_stats_t;
+
+/** Data path primitives backend
+ * \ref wifi_dp_ops_t
+ */
+typedef wifi_dp_ops_t wlan_dp_ops_t;
+
+/** TX buffer pool statistics
+ * \ref wifi_tx_buf_pool_stats_t
+ */
+typedef wifi_tx_buf_pool_stats_t wlan_tx_buf_pool_stats_t;
+
+/** Shared TX scheduler statistics
+ * \ref wifi_bss_tx_sched_stats_t
+ */
+typedef wifi_bss_tx_sched_stats_t wlan_bss_tx_sched_stats_t;
+
+/** SDIO register access statistics
+ * \ref wifi_sdio_reg_stats_t
+ */
+typedef wifi_sdio_reg_stats_t wlan_sdio_reg_stats_t;
+
+/** Channel switch statistics
+ * \ref wifi_chan_switch_stats_t
+ */
+typedef wifi_chan_switch_stats_t wlan_chan_switch_stats_t;
+
+/** Remain on channel coordinator configuration
+ * \ref wifi_roc_config_t
+ */
+typedef wifi_roc_config_t wlan_roc_config_t;
+
+/** Remain on channel statistics
+ * \ref wifi_roc_stats_t
+ */
+typedef wifi_roc_stats_t wlan_roc_stats_t;
+
+/** Adaptive coexistence controller configuration
+ * \ref wifi_coex_ctrl_config_t
+ */
+typedef wifi_coex_ctrl_config_t wlan_coex_ctrl_config_t;
+
+/** Adaptive coexistence controller statistics
+ * \ref wifi_coex_ctrl_stats_t
+ */
+typedef wifi_coex_ctrl_stats_t wlan_coex_ctrl_stats_t;
+
+/** Firmware hang recovery configuration
+ * \ref wifi_recovery_config_t
+ */
+typedef wifi_recovery_config_t wlan_recovery_config_t;
+
+/** Firmware hang recovery statistics
+ * \ref wifi_recovery_stats_t
+ */
+typedef wifi_recovery_stats_t wlan_recovery_stats_t;
+
+/** Firmware boot statistics
+ * \ref wifi_fw_boot_stats_t
+ */
+typedef wifi_fw_boot_stats_t wlan_fw_boot_stats_t;
+
+/** uAP client setup statistics
+ * \ref wifi_uap_sta_setup_stats_t
+ */
+typedef wifi_uap_sta_setup_stats_t wlan_uap_sta_setup_stats_t;
+
+/** Wi-Fi statistics counter identifier
+ * \ref wifi_stat_id_t
+ */
+typedef wifi_stat_id_t wlan_stat_id_t;
+
+/** Snapshot of the Wi-Fi statistics counters
+ * \ref wifi_stats_snapshot_t
+ */
+typedef wifi_stats_snapshot_t wlan_stats_snapshot_t;
+
+/** Read-only view of one scan result
+ * \ref wifi_scan_view_t
+ */
+typedef wifi_scan_view_t wlan_scan_view_t;
+
+/** Capability information of a scan result
+ * \ref wifi_scan_caps_t
+ */
+typedef wifi_scan_caps_t wlan_scan_caps_t;
+
+/** Security information of a scan result
+ * \ref wifi_scan_security_t
+ */
+typedef wifi_scan_security_t wlan_scan_security_t;
+
+/** Scan result visitor for \ref wlan_scan_foreach */
+typedef wifi_scan_visit_fn_t wlan_scan_visit_fn_t;
+
+/** Scan result sort key for \ref wlan_scan_sort_index */
+typedef wifi_scan_key_fn_t wlan_scan_key_fn_t;
+
+/** Scan table memory use and beacon handling cost
+ * \ref wifi_scan_mem_stats_t
+ */
+typedef wifi_scan_mem_stats_t wlan_scan_mem_stats_t;
+
 int verify_scan_duration_value(int scan_duration);
 int verify_scan_channel_value(int channel);
 int verify_split_scan_delay(int delay);
@@ -1971,6 +2110,88 @@ int wlan_scan_with_opt(wlan_scan_params_v2_t t_wlan_scan_param);
  */
 int wlan_get_scan_result(unsigned int index, struct wlan_scan_result *res);
 
+/** Walk the scan results without copying them.
+ *
+ *  This function calls \a visit once for every entry of the scan table with
+ *  a read-only view of the entry. Security and capability information is
+ *  only decoded when asked for with \ref wlan_scan_view_get_security() and
+ *  \ref wlan_scan_view_get_caps(). The view is valid only during the call.
+ *
+ *  The walk holds the scan lock, so the table is not updated meanwhile.
+ *  It may also be called from the scan result callback passed to
+ *  \ref wlan_scan(), which already runs under that lock. Called from
+ *  another WLAN Connection Manager callback while a scan is in progress,
+ *  it fails with WLAN_ERROR_ACTION instead of waiting for the lock.
+ *
+ *  \param[in] visit Called for each entry, a non-zero return value stops
+ *             the walk.
+ *  \param[in] arg Opaque argument passed to \a visit.
+ *
+ *  \return Number of entries visited if successful.
+ *  \return -WM_E_INVAL if \a visit is NULL.
+ *  \return WLAN_ERROR_STATE if the WLAN Connection Manager was not running.
+ *  \return WLAN_ERROR_ACTION if the scan lock could not be taken.
+ */
+int wlan_scan_foreach(wlan_scan_visit_fn_t visit, void *arg);
+
+/** Rank the scan results.
+ *
+ *  This function fills \a idx with scan result indices ordered by
+ *  descending \a key, without copying the results. Each key is evaluated
+ *  once per entry and the best \a count entries of the whole table are
+ *  returned. Entries with equal keys keep the scan table order.
+ *  The indices can be passed to \ref wlan_get_scan_result().
+ *
+ *  \param[out] idx Array receiving the scan result indices.
+ *  \param[in,out] count Size of \a idx on input, number of indices stored
+ *                 on output.
+ *  \param[in] key Sort key, NULL orders by signal strength, strongest first.
+ *  \param[in] arg Opaque argument passed to \a key.
+ *
+ *  \return WM_SUCCESS if successful.
+ *  \return -WM_E_INVAL if \a idx or \a count is NULL.
+ *  \return -WM_E_NOMEM if the key array could not be allocated.
+ *  \return WLAN_ERROR_STATE if the WLAN Connection Manager was not running.
+ *  \return WLAN_ERROR_ACTION if the scan lock could not be taken.
+ */
+int wlan_scan_sort_index(uint16_t *idx, unsigned int *count, wlan_scan_key_fn_t key, void *arg);
+
+/** Decode the security information of a scan result view.
+ *
+ *  \param[in] view View passed to a \ref wlan_scan_foreach() visitor or
+ *             a \ref wlan_scan_sort_index() key.
+ *  \param[out] security Decoded security information.
+ *
+ *  \return WM_SUCCESS if successful.
+ *  \return -WM_E_INVAL if \a view or \a security is NULL.
+ */
+int wlan_scan_view_get_security(const wlan_scan_view_t *view, wlan_scan_security_t *security);
+
+/** Decode the capability information of a scan result view.
+ *
+ *  \param[in] view View passed to a \ref wlan_scan_foreach() visitor or
+ *             a \ref wlan_scan_sort_index() key.
+ *  \param[out] caps Decoded 802.11n/ac, 802.11k/v/r and WMM capabilities.
+ *
+ *  \return WM_SUCCESS if successful.
+ *  \return -WM_E_INVAL if \a view or \a caps is NULL.
+ */
+int wlan_scan_view_get_caps(const wlan_scan_view_t *view, wlan_scan_caps_t *caps);
+
+/** Get scan table memory use and beacon handling cost.
+ *
+ *  Reports the size of the scan table slots and the IE storage next to
+ *  the time spent parsing beacons and storing entries since the driver
+ *  started, so builds with and without CONFIG_COMPACT_SCAN_TABLE can be
+ *  compared.
+ *
+ *  \param[out] stats A pointer to \ref wlan_scan_mem_stats_t.
+ *
+ *  \return WM_SUCCESS if successful.
+ *  \return -WM_E_INVAL if \a stats is NULL.
+ */
+int wlan_get_scan_mem_stats(wlan_scan_mem_stats_t *stats);
+
 #ifdef WLAN_LOW_POWER_ENABLE
 /**
  * Enable Low Power Mode in Wireless Firmware.
@@ -2921,6 +3142,27 @@ int wlan_set_txratecfg(wlan_ds_rate ds_rate, mlan_bss_type bss_type);
  */
 int wlan_get_txratecfg(wlan_ds_rate *ds_rate, mlan_bss_type bss_type);
 
+/**
+ * Set per user priority transmit control policy.
+ *
+ * The tx_control word is copied into the TxPD of every data packet with
+ * this user priority (e.g. to request a fixed rate or retry limit from
+ * firmware); 0 selects the interface default. With WMM enabled, packets
+ * which waited in the host queues longer than expiry_ms are dropped
+ * before being sent to firmware, so that stale latency critical frames
+ * do not hold back the queue.
+ *
+ * \param[in] bss_type BSS type, MLAN_BSS_TYPE_STA or MLAN_BSS_TYPE_UAP.
+ * \param[in] user_prio User priority (0 to 7).
+ * \param[in] tx_control Firmware TxPD tx_control word, 0 for default.
+ * \param[in] expiry_ms Host queue expiry in milliseconds, 0 to never expire.
+ *
+ * \return WM_SUCCESS if successful.
+ * \return -WM_E_INVAL if any of the arguments is invalid.
+ *
+ */
+int wlan_set_tx_ctrl_policy(mlan_bss_type bss_type, uint8_t user_prio, uint32_t tx_control, uint16_t expiry_ms);
+
 /**
  * Get Station interface transmit power
  *
@@ -3052,6 +3294,11 @@ int wlan_get_average_signal_strength(short *rssi, int *snr);
  * \note When status is false, channel and duration parameters are
  * ignored.
  *
+ * \note Data queued for transmission is held while the radio is off
+ * channel. While connected, long durations are served in slices with
+ * time on the home channel in between, see wlan_set_roc_config(). A
+ * management frame sent between two slices waits for the next one.
+ *
  * \param[in] bss_type The interface to set channel.
  * \param[in] status false : Cancel the remain on channel configuration
  *                   true : Set the remain on channel configuration
@@ -3242,6 +3489,210 @@ void wlan_uap_ctrl_deauth(const bool enable);
  */
 void wlan_uap_set_ecsa(void);
 
+/** Hold transmission on an interface for a planned channel switch.
+ *
+ *  Queued frames are kept, and up to half of the TX buffer pool is
+ *  accepted for new frames, until the firmware reports the switch
+ *  complete. Transmission then resumes at once. If no completion comes
+ *  within 3 seconds transmission resumes anyway.
+ *
+ *  A station interface does this by itself on a channel switch
+ *  announcement from its AP when ECSA is enabled, and a uAP does it
+ *  on its own announcement or, when set up with wlan_uap_set_ecsa(),
+ *  when it follows the station to the new channel.
+ *
+ *  \param[in] bss_type BSS type, MLAN_BSS_TYPE_STA or MLAN_BSS_TYPE_UAP.
+ *
+ *  \return WM_SUCCESS if successful.
+ *  \return -WM_E_INVAL if \a bss_type is invalid.
+ */
+int wlan_chan_switch_prepare(mlan_bss_type bss_type);
+
+/** Get channel switch statistics of an interface.
+ *
+ *  \param[in] bss_type BSS type, MLAN_BSS_TYPE_STA or MLAN_BSS_TYPE_UAP.
+ *  \param[out] stats A pointer to \ref wlan_chan_switch_stats_t.
+ *
+ *  \return WM_SUCCESS if successful.
+ *  \return -WM_E_INVAL if any of the arguments is invalid.
+ */
+int wlan_get_chan_switch_stats(mlan_bss_type bss_type, wlan_chan_switch_stats_t *stats);
+
+/** Configure remain on channel slicing.
+ *
+ *  While any interface is connected, a remain on channel request longer
+ *  than \a max_slice_ms is served in slices of at most that length with
+ *  \a home_ms on the home channel in between, so that queued data is
+ *  sent and the peers do not time out. The default is 100 ms slices
+ *  with 50 ms on the home channel. Only requests made through
+ *  wlan_remain_on_channel() are sliced. A management frame sent while
+ *  the radio is back on the home channel waits for the next slice.
+ *  Requests from the supplicant always stay on the channel for their
+ *  whole duration.
+ *
+ *  \param[in] cfg A pointer to \ref wlan_roc_config_t, copied.
+ *
+ *  \return WM_SUCCESS if successful.
+ *  \return -WM_E_INVAL if \a cfg is NULL.
+ */
+int wlan_set_roc_config(const wlan_roc_config_t *cfg);
+
+/** Get remain on channel statistics, including the home channel outage
+ *  of the last request.
+ *
+ *  \param[out] stats A pointer to \ref wlan_roc_stats_t.
+ *
+ *  \return WM_SUCCESS if successful.
+ *  \return -WM_E_INVAL if \a stats is NULL.
+ */
+int wlan_get_roc_stats(wlan_roc_stats_t *stats);
+
+/** Take a snapshot of the Wi-Fi statistics counters.
+ *
+ *  Counters are updated without locks from the data path and can be
+ *  read at any time without stopping traffic.
+ *
+ *  \param[out] snap A pointer to \ref wlan_stats_snapshot_t.
+ *
+ *  \return WM_SUCCESS if successful.
+ *  \return -WM_E_INVAL if \a snap is NULL.
+ */
+int wlan_stats_snapshot(wlan_stats_snapshot_t *snap);
+
+/** Compute the counter changes between two snapshots.
+ *
+ *  \param[in] prev Older snapshot.
+ *  \param[in] cur Newer snapshot.
+ *  \param[out] delta Counter changes and elapsed time. When the counters
+ *                    were reset in between, the values of \a cur.
+ *
+ *  \return WM_SUCCESS if successful.
+ *  \return -WM_E_INVAL on a NULL argument.
+ */
+int wlan_stats_delta(const wlan_stats_snapshot_t *prev,
+                     const wlan_stats_snapshot_t *cur,
+                     wlan_stats_snapshot_t *delta);
+
+/** Restart all Wi-Fi statistics counters from zero. */
+void wlan_stats_reset(void);
+
+/** Get the name of a Wi-Fi statistics counter.
+ *
+ *  \param[in] id Counter.
+ *
+ *  \return Counter name, or NULL if \a id is out of range.
+ */
+const char *wlan_stats_name(wlan_stat_id_t id);
+
+/** Serialize a snapshot in the compact binary telemetry format.
+ *
+ *  See wifi_stats_export() for the format.
+ *
+ *  \param[in] snap Snapshot or delta to serialize.
+ *  \param[out] buf Output buffer, \ref WIFI_STATS_EXPORT_MAX_LEN bytes always fit.
+ *  \param[in] buf_len Size of \a buf.
+ *  \param[out] out_len Bytes written.
+ *
+ *  \return WM_SUCCESS if successful.
+ *  \return -WM_E_INVAL on a NULL argument.
+ *  \return -WM_E_NOMEM if \a buf is too small.
+ */
+int wlan_stats_export(const wlan_stats_snapshot_t *snap, uint8_t *buf, uint32_t buf_len, uint32_t *out_len);
+
+#ifdef CONFIG_WPA_SUPP_AP
+/** Get uAP client setup statistics.
+ *
+ *  A client is authorised when its pairwise key is installed, or when
+ *  it is added authorised on an open network. Repeated station add
+ *  requests, as sent for retransmitted association requests, are not
+ *  passed to the firmware and are counted as skipped.
+ *
+ *  \param[out] stats A pointer to \ref wlan_uap_sta_setup_stats_t.
+ *
+ *  \return WM_SUCCESS if successful.
+ *  \return -WM_E_INVAL if \a stats is NULL.
+ */
+int wlan_uap_get_sta_setup_stats(wlan_uap_sta_setup_stats_t *stats);
+
+/** Get the time a uAP client took from station add to authorised.
+ *
+ *  \param[in] mac MAC address of the client.
+ *  \param[out] time_ms Time in milliseconds, 0 while the client is not
+ *              yet authorised.
+ *
+ *  \return WM_SUCCESS if successful.
+ *  \return -WM_E_INVAL if any of the arguments is invalid.
+ *  \return -WM_FAIL if the client is not known.
+ */
+int wlan_uap_get_sta_setup_time(const uint8_t *mac, uint32_t *time_ms);
+#endif
+
+#ifdef CONFIG_WIFI_RECOVERY
+/** Enable automatic firmware hang recovery.
+ *
+ *  A hang is detected when a command gets no response within
+ *  \a cmd_timeout_ms or when reads of received data keep failing. With
+ *  \a probe_interval_ms set, an idle firmware is probed with a version
+ *  query. On a hang the stack is stopped, \a card_reset is called, the
+ *  firmware is downloaded again and the known networks, uAP network,
+ *  country, multicast filters, power save and cloud keep alive settings
+ *  are replayed. The application gets a single \ref
+ *  WLAN_REASON_FW_RECOVERED, or \ref WLAN_REASON_FW_RECOVERY_FAILED,
+ *  instead of the usual initialization events.
+ *
+ *  Call after wlan_init(). The firmware image passed to wlan_init() must
+ *  stay valid.
+ *
+ *  \param[in] cfg A pointer to \ref wlan_recovery_config_t, copied.
+ *
+ *  \return WM_SUCCESS if successful.
+ *  \return -WM_E_INVAL if \a cfg is NULL.
+ *  \return -WM_FAIL if the recovery thread could not be created.
+ */
+int wlan_recovery_enable(const wlan_recovery_config_t *cfg);
+
+/** Get firmware hang recovery statistics.
+ *
+ *  \param[out] stats A pointer to \ref wlan_recovery_stats_t.
+ *
+ *  \return WM_SUCCESS if successful.
+ *  \return -WM_E_INVAL if \a stats is NULL.
+ */
+int wlan_get_recovery_stats(wlan_recovery_stats_t *stats);
+#endif
+
+#ifdef CONFIG_WIFI_WARM_START
+/** Reuse the firmware already running on the card at the next wlan_init().
+ *
+ *  Meant for restarts of the host alone, where the card kept power and
+ *  its firmware. The firmware download is skipped when the card reports
+ *  firmware ready and the running firmware answers a version query with
+ *  \a fw_version. The usual initialization commands are still sent so
+ *  the driver relearns the card state. If the check fails the firmware
+ *  is reset, through the firmware reset register where the card has one
+ *  and an SDIO I/O reset otherwise, and downloaded again. Only if the
+ *  firmware keeps running after the reset does wlan_init() fail, and the
+ *  card then needs a power cycle.
+ *
+ *  Call before wlan_init(). The application typically stores the
+ *  version reported after a firmware download and passes it back here.
+ *
+ *  \param[in] fw_version Expected extended firmware version, empty
+ *                        string accepts any version, NULL disables
+ *                        warm start.
+ */
+void wlan_set_fw_warm_start(const char *fw_version);
+
+/** Get firmware boot statistics.
+ *
+ *  \param[out] stats A pointer to \ref wlan_fw_boot_stats_t.
+ *
+ *  \return WM_SUCCESS if successful.
+ *  \return -WM_E_INVAL if \a stats is NULL.
+ */
+int wlan_get_fw_boot_stats(wlan_fw_boot_stats_t *stats);
+#endif
+
 /** API to set the HT Capability Information of uAP
  *
  *\param[in] ht_cap_info - This is a bitmap and should be used as following\n
@@ -4011,6 +4462,50 @@ int wlan_set_clocksync_cfg(const wlan_clock_sync_gpio_tsf_t *tsf_latch);
  * \return WM_SUCCESS if successful otherwise failure.
  */
 int wlan_get_tsf_info(wlan_tsf_info_t *tsf_info);
+
+/** Take a TSF sample from firmware and feed it to the clock sync loop
+ *
+ * The TSF is read with a firmware command bracketed by host timestamps;
+ * samples whose round trip is much larger than the best one seen are
+ * discarded. Call periodically (at least every few minutes, since the
+ * host microsecond counter wraps) to keep the drift estimate tracking.
+ *
+ * \return WM_SUCCESS if the sample was accepted,
+ *         -WM_E_AGAIN if it was rejected, otherwise failure.
+ */
+int wlan_clock_sync_update(void);
+/** Feed an externally obtained TSF sample to the clock sync loop
+ *
+ * This can be used with a GPIO latched TSF (\ref wlan_get_tsf_info)
+ * where the host time of the latch is known precisely.
+ *
+ * \param[in] host_us os_get_timestamp() value at which \a tsf was valid
+ * \param[in] tsf TSF value in microseconds
+ * \param[in] err_us Uncertainty of \a host_us in microseconds
+ *
+ * \return WM_SUCCESS if the sample was accepted,
+ *         -WM_E_AGAIN if it was rejected.
+ */
+int wlan_clock_sync_feed(uint32_t host_us, uint64_t tsf, uint32_t err_us);
+/** Get the current TSF estimated from the host clock
+ *
+ * This does not access the firmware and can be called from any context.
+ *
+ * \param[out] tsf Estimated TSF in microseconds
+ *
+ * \return WM_SUCCESS if successful,
+ *         -WM_FAIL if no sample has been taken yet.
+ */
+int wlan_clock_sync_now(uint64_t *tsf);
+/** Get clock sync statistics
+ *
+ * \param[out] stats Clock sync statistics
+ *
+ * \return WM_SUCCESS if successful otherwise failure.
+ */
+int wlan_clock_sync_get_stats(wlan_clock_sync_stats_t *stats);
+/** Discard the clock sync model and statistics */
+void wlan_clock_sync_reset(void);
 #endif /* CONFIG_WIFI_CLOCKSYNC */
 
 #ifdef CONFIG_HEAP_DEBUG
@@ -4077,6 +4572,158 @@ int wlan_rx_mgmt_indication(const enum wlan_bss_type bss_type,
 
 #ifdef CONFIG_WMM
 void wlan_wmm_tx_stats_dump(int bss_type);
+
+/**
+ * Enable or disable TX aggregation auto tuning.
+ *
+ * When enabled, the driver watches the packet size mix, the host queue
+ * depth and the drop counters of every peer and access category. Peers
+ * carrying small or sparse packets are tuned for latency: A-MSDU is not
+ * used and block ack setup waits for sustained traffic. Peers with deep
+ * queues of large packets are tuned for throughput: A-MSDU is used and
+ * its size limit backs off on drops. A mode only changes after several
+ * consecutive observation windows agree, to avoid oscillation.
+ *
+ * The static A-MPDU and A-MSDU settings still apply on top of the tuner
+ * decisions.
+ *
+ * The A-MSDU decisions only take effect when the driver builds A-MSDUs
+ * on the host, i.e. when it is built with AMSDU_IN_AMPDU. Otherwise they
+ * are advisory and only reported by \ref wlan_get_aggr_tune_stats(), while
+ * the block ack decisions still apply.
+ *
+ * \param[in] enable true to enable, false to disable.
+ */
+void wlan_set_aggr_auto_tune(bool enable);
+
+/**
+ * Get TX aggregation auto tuner decisions for a peer.
+ *
+ * The A-MSDU fields report what the tuner picked. Without AMSDU_IN_AMPDU
+ * the driver never builds A-MSDUs on the host and they are not applied.
+ *
+ * \param[in] bss_type BSS type, MLAN_BSS_TYPE_STA or MLAN_BSS_TYPE_UAP.
+ * \param[in] mac Destination MAC address of the peer.
+ * \param[in] ac WMM access category (0 to 3).
+ * \param[out] stats A pointer to \ref wlan_aggr_tune_stats_t.
+ *
+ * \return WM_SUCCESS if successful.
+ * \return -WM_E_INVAL if any of the arguments is invalid.
+ * \return -WM_FAIL if no TX queue exists for the peer.
+ */
+int wlan_get_aggr_tune_stats(int bss_type, const uint8_t *mac, uint8_t ac, wlan_aggr_tune_stats_t *stats);
+
+/**
+ * Add an external RAM region to the TX buffer pool.
+ *
+ * TX packets use the buffers in internal RAM first. When a burst
+ * exhausts them, further packets are queued in buffers carved from
+ * this region instead of being dropped or replacing queued packets.
+ * A packet in an external buffer is moved to internal RAM just before
+ * it is handed to SDIO. If no internal buffer is free at that moment
+ * it is sent from the external region, so without SDIO multi port
+ * aggregation the region must be reachable by the SDIO DMA.
+ *
+ * \note Call this after \ref wlan_init(). Only one region is supported
+ * and it must stay valid until \ref wlan_deinit().
+ *
+ * \param[in] region Start of the region.
+ * \param[in] len Length of the region in bytes.
+ *
+ * \return WM_SUCCESS if successful.
+ * \return -WM_E_INVAL if the region is too small for one buffer.
+ * \return -WM_FAIL if a region was already added.
+ */
+int wlan_set_tx_ext_buf_region(uint8_t *region, uint32_t len);
+
+/**
+ * Get TX buffer pool occupancy and promotion counters.
+ *
+ * \param[out] stats A pointer to \ref wlan_tx_buf_pool_stats_t.
+ *
+ * \return WM_SUCCESS if successful.
+ * \return -WM_E_INVAL if \a stats is NULL.
+ */
+int wlan_get_tx_buf_pool_stats(wlan_tx_buf_pool_stats_t *stats);
+
+/**
+ * Set the TX weight of an interface.
+ *
+ * The interfaces share one TX scheduler. In each round an interface may
+ * send up to 4 packets per unit of weight before the next interface is
+ * served. When TX buffers run low, an interface holding its weighted
+ * share of the buffer pool, internal and external buffers together,
+ * gets no more while another interface is connected. All interfaces
+ * start with weight 1.
+ *
+ * The scheduler serves the station and the single uAP interface. Running
+ * several uAP BSSs at once is not supported.
+ *
+ * \param[in] bss_type BSS type, MLAN_BSS_TYPE_STA or MLAN_BSS_TYPE_UAP.
+ * \param[in] weight Weight, 1 to 255.
+ *
+ * \return WM_SUCCESS if successful.
+ * \return -WM_E_INVAL if any of the arguments is invalid.
+ */
+int wlan_set_bss_tx_weight(mlan_bss_type bss_type, uint8_t weight);
+
+/**
+ * Get shared TX scheduler statistics of an interface.
+ *
+ * \param[in] bss_type BSS type, MLAN_BSS_TYPE_STA or MLAN_BSS_TYPE_UAP.
+ * \param[out] stats A pointer to \ref wlan_bss_tx_sched_stats_t.
+ *
+ * \return WM_SUCCESS if successful.
+ * \return -WM_E_INVAL if any of the arguments is invalid.
+ */
+int wlan_get_bss_tx_sched_stats(mlan_bss_type bss_type, wlan_bss_tx_sched_stats_t *stats);
+#endif
+
+/**
+ * Select the copy and checksum primitives used on the data path.
+ *
+ * The driver copies RX data into lwIP pbufs, TX pbufs into its TX
+ * buffers, TX buffers into the SDIO aggregation buffer and frames into
+ * A-MSDUs through these primitives. Copies of at least
+ * \a dma_min_len bytes use \a dma_copy when it is set. The built-in
+ * backend uses memcpy(), IMU GDMA for large copies when
+ * CONFIG_IMU_GDMA is set, and a word based checksum fused with the
+ * copy.
+ *
+ * To let lwIP compute checksums while copying, set in lwipopts.h:
+ * \code
+ * #define LWIP_CHECKSUM_ON_COPY 1
+ * #define LWIP_CHKSUM_COPY(dst, src, len) wifi_dp_copy_chksum(dst, src, len)
+ * #define LWIP_CHKSUM(data, len) wifi_dp_chksum(data, len)
+ * \endcode
+ *
+ * \note Call this while no data traffic is running.
+ *
+ * \param[in] ops Backend, members left NULL keep the built-in
+ *            implementation. NULL restores the built-in backend.
+ */
+void wlan_set_data_path_ops(const wlan_dp_ops_t *ops);
+
+#ifdef CONFIG_WIFI_SDIO_REG_CACHE
+/**
+ * Get SDIO register access statistics.
+ *
+ * Each interrupt reads the status, port bitmaps and data port lengths in
+ * one transfer. The command port length is read only when the command
+ * port has data, and TX reads the write port bitmap only when it runs
+ * out of ports on a stale register image.
+ *
+ * \param[out] stats A pointer to \ref wlan_sdio_reg_stats_t.
+ *
+ * \return WM_SUCCESS if successful.
+ * \return -WM_E_INVAL if \a stats is NULL.
+ */
+int wlan_get_sdio_reg_stats(wlan_sdio_reg_stats_t *stats);
+
+/**
+ * Clear SDIO register access statistics.
+ */
+void wlan_reset_sdio_reg_stats(void);
 #endif
 
 /**
@@ -4391,6 +5038,24 @@ uint8_t wlan_check_11ax_capa(unsigned int channel);
  */
 int wlan_get_signal_info(wlan_rssi_info_t *signal);
 
+/**
+ * Get link quality statistics collected from received data packets.
+ *
+ * The statistics are updated from the metadata of every received packet
+ * and reading them does not issue any firmware command.
+ *
+ * \param[in] bss_type WLAN_BSS_TYPE_STA or WLAN_BSS_TYPE_UAP.
+ * \param[in] mac Station MAC address for WLAN_BSS_TYPE_UAP, ignored
+ *                for WLAN_BSS_TYPE_STA.
+ * \param[out] stats Link quality statistics.
+ *
+ * \return WM_SUCCESS if successful.
+ * \return -WM_FAIL if no packet was received from this link yet.
+ * \return -WM_E_BUSY if the caller preempted an update of this link;
+ *         retry once the RX path had a chance to run.
+ */
+int wlan_get_link_stats(enum wlan_bss_type bss_type, const uint8_t *mac, wlan_link_stats_t *stats);
+
 
 #ifdef CONFIG_TURBO_MODE
 /**
@@ -4553,5 +5218,53 @@ int wlan_single_ant_duty_cycle(t_u16 enable, t_u16 nbTime, t_u16 wlanTime);
  * \return WM_SUCCESS if successful otherwise failure.
  */
 int wlan_dual_ant_duty_cycle(t_u16 enable, t_u16 nbTime, t_u16 wlanTime, t_u16 wlanBlockTime);
+
+/**
+ * Start the adaptive coexistence duty cycle controller.
+ *
+ * Every \a period_ms the controller samples the Wi-Fi station TX queue
+ * depth and drops together with the last BT latency given to
+ * \ref wlan_coex_ctrl_report_bt_latency. BT time moves by \a nb_time_step
+ * within [\a nb_time_min, \a nb_time_max] once \a hysteresis consecutive
+ * samples agree: towards BT when BT latency exceeds its budget, towards
+ * Wi-Fi when its queue is under pressure and BT is within budget, and back
+ * to BT when the Wi-Fi queue is idle. Each decision is logged.
+ *
+ * \param[in] cfg Controller configuration, copied.
+ *
+ * \return WM_SUCCESS if successful.
+ * \return -WM_E_INVAL if the configuration is invalid.
+ * \return -WM_FAIL if the controller could not be started.
+ */
+int wlan_coex_ctrl_start(const wlan_coex_ctrl_config_t *cfg);
+
+/**
+ * Stop the adaptive coexistence duty cycle controller.
+ *
+ * The last duty cycle applied stays in effect.
+ *
+ * \return WM_SUCCESS if successful.
+ */
+int wlan_coex_ctrl_stop(void);
+
+/**
+ * Report the latest BT link latency to the coexistence controller.
+ *
+ * A report counts for one controller period. When a period passes without
+ * one, BT is taken as idle and the latency as 0.
+ *
+ * \param[in] latency_ms Latency measured by the BT stack in milliseconds.
+ */
+void wlan_coex_ctrl_report_bt_latency(uint32_t latency_ms);
+
+/**
+ * Get the adaptive coexistence controller statistics.
+ *
+ * \param[out] stats A pointer to \ref wlan_coex_ctrl_stats_t.
+ *
+ * \return WM_SUCCESS if successful.
+ * \return -WM_E_INVAL if \a stats is NULL.
+ */
+int wlan_coex_ctrl_get_stats(wlan_coex_ctrl_stats_t *stats);
 #endif
 #endif /* __WLAN_H__ */
@@ -74,8 +74,11 @@ static void dhcp_timer_cb(os_timer_arg_t arg);
 err_t lwip_netif_init(struct netif *netif);
 err_t lwip_netif_uap_init(struct netif *netif);
 void handle_data_packet(const t_u8 interface, const t_u8 *rcvdata, const t_u16 datalen);
-void handle_amsdu_data_packet(t_u8 interface, t_u8 *rcvdata, t_u16 datalen);
+void handle_amsdu_data_packet(t_u8 interface, t_u8 *rcvdata, t_u16 datalen, t_u8 priority);
 void handle_deliver_packet_above(t_void *rxpd, t_u8 interface, t_void *lwip_pbuf);
+#ifdef CONFIG_WIFI_RX_BATCH
+void handle_rx_batch_end(void);
+#endif
 bool wrapper_net_is_ip_or_ipv6(const t_u8 *buffer);
 
 NETIF_DECLARE_EXT_CALLBACK(netif_ext_callback)
@@ -261,6 +264,9 @@ int net_wlan_init(void)
         (void)wifi_register_amsdu_data_input_callback(&handle_amsdu_data_packet);
         (void)wifi_register_deliver_packet_above_callback(&handle_deliver_packet_above);
         (void)wifi_register_wrapper_net_is_ip_or_ipv6_callback(&wrapper_net_is_ip_or_ipv6);
+#ifdef CONFIG_WIFI_RX_BATCH
+        (void)wifi_register_rx_batch_end_callback(&handle_rx_batch_end);
+#endif
         ip_2_ip4(&g_mlan.ipaddr)->addr = INADDR_ANY;
         ret = netifapi_netif_add(&g_mlan.netif, ip_2_ip4(&g_mlan.ipaddr), ip_2_ip4(&g_mlan.ipaddr),
                                  ip_2_ip4(&g_mlan.ipaddr), NULL, lwip_netif_init, tcpip_input);
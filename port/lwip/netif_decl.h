@@ -16,6 +16,7 @@
 #include "lwip/mem.h"
 #include "lwip/pbuf.h"
 #include "lwip/udp.h"
+#include "lwip/ip4_frag.h"
 #include "lwip/sys.h"
 #ifdef CONFIG_IPV6
 #include "lwip/ethip6.h"
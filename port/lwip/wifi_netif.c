@@ -41,6 +41,15 @@
 
 /*------------------------------------------------------*/
 #include <netif_decl.h>
+
+/* Count in the lwIP link stats, when enabled, and in the driver counters */
+#define WIFI_LINK_STATS_INC(x, id) \
+    do                             \
+    {                              \
+        LINK_STATS_INC(link.x);    \
+        wifi_stats_inc(id);        \
+    } while (false)
+
 /*------------------------------------------------------*/
 uint16_t g_data_nf_last;
 uint16_t g_data_snr_last;
@@ -55,9 +64,12 @@ static err_t mld_mac_filter(struct netif *netif, const ip6_addr_t *group, enum n
 err_t lwip_netif_uap_init(struct netif *netif);
 err_t lwip_netif_init(struct netif *netif);
 void handle_data_packet(const t_u8 interface, const t_u8 *rcvdata, const t_u16 datalen);
-void handle_amsdu_data_packet(t_u8 interface, t_u8 *rcvdata, t_u16 datalen);
+void handle_amsdu_data_packet(t_u8 interface, t_u8 *rcvdata, t_u16 datalen, t_u8 priority);
 void handle_deliver_packet_above(t_void *rxpd, t_u8 interface, t_void *lwip_pbuf);
 bool wrapper_net_is_ip_or_ipv6(const t_u8 *buffer);
+#ifdef CONFIG_WIFI_RX_BATCH
+void handle_rx_batch_end(void);
+#endif
 
 #ifndef CONFIG_WPA_SUPP
 static int (*rx_mgmt_callback)(const enum wlan_bss_type bss_type, const wifi_mgmt_frame_t *frame, const size_t len);
@@ -79,7 +91,731 @@ static void register_interface(struct netif *iface, mlan_bss_type iface_type)
     netif_arr[iface_type] = iface;
 }
 
-static void deliver_packet_above(struct pbuf *p, int recv_interface)
+#if defined(CONFIG_WIFI_RX_PRIO) || defined(CONFIG_WIFI_RX_BATCH)
+/*
+ * Frames bound for lwIP are parked in hand-off queues and passed to the
+ * tcpip thread by a single drain callback that feeds ethernet_input()
+ * directly, instead of one tcpip_input() mbox message per frame.
+ *
+ * With CONFIG_WIFI_RX_PRIO there is one queue per access category. The
+ * drain always serves the highest category first, so a VO frame that
+ * arrives behind a bulk backlog is delivered ahead of it. A lower
+ * category that has been passed over RX_PRIO_STARVE_LIMIT times in a row
+ * is served once to keep it moving.
+ *
+ * With CONFIG_WIFI_RX_BATCH the drain is not posted on the first frame.
+ * Frames accumulate until the SDIO read cycle ends, the batch is full or
+ * the batch latency expires, and are then handed over in one message.
+ */
+#ifndef CONFIG_WIFI_RX_HANDOFF_QUEUE_LEN
+#define RX_HANDOFF_QUEUE_LEN 16U
+#else
+#define RX_HANDOFF_QUEUE_LEN CONFIG_WIFI_RX_HANDOFF_QUEUE_LEN
+#endif
+
+/* Frames delivered per drain callback before yielding the tcpip thread */
+#define RX_HANDOFF_DRAIN_BUDGET 16U
+
+#ifdef CONFIG_WIFI_RX_PRIO
+#define RX_HANDOFF_NUM_Q NET_RX_PRIO_NUM_AC
+/* Consecutive higher category frames before a waiting lower one is served */
+#define RX_PRIO_STARVE_LIMIT 8U
+
+/* Access category indices, lowest priority first */
+#define RX_PRIO_AC_BK 0U
+#define RX_PRIO_AC_BE 1U
+#define RX_PRIO_AC_VI 2U
+#define RX_PRIO_AC_VO 3U
+#else
+#define RX_HANDOFF_NUM_Q 1U
+#endif
+
+typedef struct
+{
+    struct pbuf *p;
+    t_u8 interface;
+    t_u32 enq_ms;
+} rx_handoff_entry_t;
+
+typedef struct
+{
+    rx_handoff_entry_t ring[RX_HANDOFF_QUEUE_LEN];
+    t_u16 head;
+    t_u16 count;
+} rx_handoff_queue_t;
+
+static rx_handoff_queue_t rx_handoff_q[RX_HANDOFF_NUM_Q];
+static bool rx_handoff_pending;
+/* Reposts the drain a tick after the tcpip mbox was found full */
+static os_timer_t rx_handoff_retry_timer;
+
+#ifdef CONFIG_WIFI_RX_PRIO
+/* 802.1D user priority to access category */
+static const t_u8 rx_prio_up_to_ac[8] = {RX_PRIO_AC_BE, RX_PRIO_AC_BK, RX_PRIO_AC_BK, RX_PRIO_AC_BE,
+                                         RX_PRIO_AC_VI, RX_PRIO_AC_VI, RX_PRIO_AC_VO, RX_PRIO_AC_VO};
+
+static struct net_rx_prio_stats rx_prio_stats;
+static t_u64 rx_prio_lat_sum[NET_RX_PRIO_NUM_AC];
+static t_u8 rx_prio_streak;
+#endif
+
+#ifdef CONFIG_WIFI_RX_BATCH
+#ifndef CONFIG_WIFI_RX_BATCH_MAX
+#define RX_BATCH_MAX 8U
+#else
+#define RX_BATCH_MAX CONFIG_WIFI_RX_BATCH_MAX
+#endif
+
+#ifndef CONFIG_WIFI_RX_BATCH_LATENCY_MS
+#define RX_BATCH_LATENCY_MS 2U
+#else
+#define RX_BATCH_LATENCY_MS CONFIG_WIFI_RX_BATCH_LATENCY_MS
+#endif
+
+static struct net_rx_batch_config rx_batch_cfg = {
+    .max_frames     = RX_BATCH_MAX,
+    .max_latency_ms = RX_BATCH_LATENCY_MS,
+};
+static struct net_rx_batch_stats rx_batch_stats;
+static os_timer_t rx_batch_timer;
+/* Frames queued since the last drain post */
+static t_u16 rx_batch_count;
+#endif
+
+/* Pick the next queue to serve, called with the queues locked */
+static int rx_handoff_pick(void)
+{
+    int hi = -1;
+    int lo = -1;
+    int q;
+
+    for (q = (int)RX_HANDOFF_NUM_Q - 1; q >= 0; q--)
+    {
+        if (rx_handoff_q[q].count != 0U)
+        {
+            if (hi < 0)
+            {
+                hi = q;
+            }
+            lo = q;
+        }
+    }
+
+#ifdef CONFIG_WIFI_RX_PRIO
+    if (hi == lo)
+    {
+        rx_prio_streak = 0;
+        return hi;
+    }
+
+    if (rx_prio_streak >= RX_PRIO_STARVE_LIMIT)
+    {
+        rx_prio_streak = 0;
+        rx_prio_stats.starve_breaks++;
+        return lo;
+    }
+
+    rx_prio_streak++;
+#else
+    (void)lo;
+#endif
+    return hi;
+}
+
+static void rx_handoff_drain(void *ctx);
+
+/* Post the drain callback, called with rx_handoff_pending already set */
+static void rx_handoff_post(void)
+{
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    if (tcpip_try_callback(rx_handoff_drain, NULL) != ERR_OK)
+    {
+        /* The frames stay queued; the next arrival, flush or the retry
+         * timer posts again */
+        SYS_ARCH_PROTECT(lev);
+        rx_handoff_pending = false;
+#ifdef CONFIG_WIFI_RX_BATCH
+        rx_batch_stats.post_failures++;
+#endif
+        SYS_ARCH_UNPROTECT(lev);
+        wifi_stats_inc(WIFI_STAT_RX_HANDOFF_POST_FAIL);
+        if (rx_handoff_retry_timer != NULL)
+        {
+            (void)os_timer_activate(&rx_handoff_retry_timer);
+        }
+        return;
+    }
+#ifdef CONFIG_WIFI_RX_BATCH
+    rx_batch_stats.posts++;
+#endif
+}
+
+static void rx_handoff_drain(void *ctx)
+{
+    unsigned int budget = RX_HANDOFF_DRAIN_BUDGET;
+    rx_handoff_entry_t entry;
+    struct netif *netif;
+    bool more;
+    int q;
+    SYS_ARCH_DECL_PROTECT(lev);
+#ifdef CONFIG_WIFI_RX_PRIO
+    t_u32 latency;
+
+    rx_prio_stats.drain_runs++;
+#endif
+
+    (void)ctx;
+
+    while (budget > 0U)
+    {
+        SYS_ARCH_PROTECT(lev);
+        q = rx_handoff_pick();
+        if (q < 0)
+        {
+            SYS_ARCH_UNPROTECT(lev);
+            break;
+        }
+        entry                = rx_handoff_q[q].ring[rx_handoff_q[q].head];
+        rx_handoff_q[q].head = (t_u16)((rx_handoff_q[q].head + 1U) % RX_HANDOFF_QUEUE_LEN);
+        rx_handoff_q[q].count--;
+#ifdef CONFIG_WIFI_RX_PRIO
+        rx_prio_stats.ac[q].depth = rx_handoff_q[q].count;
+#endif
+        SYS_ARCH_UNPROTECT(lev);
+
+#ifdef CONFIG_WIFI_RX_PRIO
+        latency = os_ticks_to_msec(os_ticks_get()) - entry.enq_ms;
+        rx_prio_lat_sum[q] += latency;
+        if (latency > rx_prio_stats.ac[q].max_latency_ms)
+        {
+            rx_prio_stats.ac[q].max_latency_ms = latency;
+        }
+        rx_prio_stats.ac[q].delivered++;
+#endif
+
+        netif = netif_arr[entry.interface];
+        if (netif == NULL)
+        {
+            WIFI_LINK_STATS_INC(drop, WIFI_STAT_LINK_DROP);
+            (void)pbuf_free(entry.p);
+        }
+        /* Already on the tcpip thread, skip the tcpip_input() mbox hop */
+        else if (ethernet_input(entry.p, netif) != (s8_t)ERR_OK)
+        {
+            WIFI_LINK_STATS_INC(proterr, WIFI_STAT_LINK_PROTERR);
+            (void)pbuf_free(entry.p);
+        }
+        else
+        {
+            /* Do nothing */
+        }
+        budget--;
+    }
+
+    SYS_ARCH_PROTECT(lev);
+    more = false;
+    for (q = 0; q < (int)RX_HANDOFF_NUM_Q; q++)
+    {
+        more = more || (rx_handoff_q[q].count != 0U);
+    }
+    rx_handoff_pending = more;
+    SYS_ARCH_UNPROTECT(lev);
+
+    /* Requeue behind other tcpip work rather than monopolising the thread */
+    if (more)
+    {
+        rx_handoff_post();
+    }
+}
+
+/* Post the drain again if frames were left behind by a failed post */
+static void rx_handoff_retry_cb(os_timer_arg_t arg)
+{
+    bool post = false;
+    int q;
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    (void)arg;
+
+    SYS_ARCH_PROTECT(lev);
+    if (!rx_handoff_pending)
+    {
+        for (q = 0; q < (int)RX_HANDOFF_NUM_Q; q++)
+        {
+            post = post || (rx_handoff_q[q].count != 0U);
+        }
+        rx_handoff_pending = post;
+#ifdef CONFIG_WIFI_RX_BATCH
+        if (post)
+        {
+            rx_batch_count = 0;
+        }
+#endif
+    }
+    SYS_ARCH_UNPROTECT(lev);
+
+    if (post)
+    {
+        rx_handoff_post();
+    }
+}
+
+#ifdef CONFIG_WIFI_RX_BATCH
+/* Hand the accumulated batch to the tcpip thread */
+static void rx_batch_flush(uint32_t *reason_cnt)
+{
+    bool post = false;
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    SYS_ARCH_PROTECT(lev);
+    if (!rx_handoff_pending && rx_batch_count != 0U)
+    {
+        rx_handoff_pending = true;
+        post               = true;
+        (*reason_cnt)++;
+        if (rx_batch_count > rx_batch_stats.max_batch)
+        {
+            rx_batch_stats.max_batch = rx_batch_count;
+        }
+        rx_batch_count = 0;
+    }
+    SYS_ARCH_UNPROTECT(lev);
+
+    if (post)
+    {
+        if (rx_batch_timer != NULL)
+        {
+            (void)os_timer_deactivate(&rx_batch_timer);
+        }
+        rx_handoff_post();
+    }
+}
+
+static void rx_batch_timer_cb(os_timer_arg_t arg)
+{
+    (void)arg;
+    rx_batch_flush(&rx_batch_stats.flush_timer);
+}
+
+/* Called by the Wi-Fi driver once an SDIO read cycle has been processed */
+void handle_rx_batch_end(void)
+{
+    rx_batch_flush(&rx_batch_stats.flush_cycle_end);
+}
+
+int net_set_rx_batch_config(const struct net_rx_batch_config *cfg)
+{
+    if (cfg == NULL || cfg->max_frames == 0U || cfg->max_frames > RX_HANDOFF_QUEUE_LEN)
+    {
+        return -WM_E_INVAL;
+    }
+
+    rx_batch_cfg = *cfg;
+
+    return WM_SUCCESS;
+}
+
+int net_get_rx_batch_stats(struct net_rx_batch_stats *stats)
+{
+    if (stats == NULL)
+    {
+        return -WM_E_INVAL;
+    }
+
+    (void)memcpy((void *)stats, (const void *)&rx_batch_stats, sizeof(*stats));
+    stats->posts_per_10k_frames =
+        (stats->frames != 0U) ? (uint32_t)(((t_u64)stats->posts * 10000U) / stats->frames) : 0U;
+
+    return WM_SUCCESS;
+}
+
+void net_reset_rx_batch_stats(void)
+{
+    (void)memset((void *)&rx_batch_stats, 0, sizeof(rx_batch_stats));
+}
+#endif /* CONFIG_WIFI_RX_BATCH */
+
+static int rx_handoff_enqueue(struct pbuf *p, t_u8 recv_interface, t_u8 prio)
+{
+#ifdef CONFIG_WIFI_RX_PRIO
+    t_u8 q = rx_prio_up_to_ac[prio & 0x7U];
+#else
+    t_u8 q = 0;
+#endif
+    rx_handoff_queue_t *queue = &rx_handoff_q[q];
+    rx_handoff_entry_t *entry;
+    bool post = false;
+#ifdef CONFIG_WIFI_RX_BATCH
+    bool arm = false;
+#endif
+    SYS_ARCH_DECL_PROTECT(lev);
+
+#ifndef CONFIG_WIFI_RX_PRIO
+    (void)prio;
+#endif
+
+    SYS_ARCH_PROTECT(lev);
+    if (queue->count >= RX_HANDOFF_QUEUE_LEN)
+    {
+#ifdef CONFIG_WIFI_RX_PRIO
+        rx_prio_stats.ac[q].dropped++;
+#endif
+        SYS_ARCH_UNPROTECT(lev);
+        return -WM_FAIL;
+    }
+    entry            = &queue->ring[(queue->head + queue->count) % RX_HANDOFF_QUEUE_LEN];
+    entry->p         = p;
+    entry->interface = recv_interface;
+    entry->enq_ms    = os_ticks_to_msec(os_ticks_get());
+    queue->count++;
+#ifdef CONFIG_WIFI_RX_PRIO
+    rx_prio_stats.ac[q].enqueued++;
+    rx_prio_stats.ac[q].depth = queue->count;
+    if (queue->count > rx_prio_stats.ac[q].max_depth)
+    {
+        rx_prio_stats.ac[q].max_depth = queue->count;
+    }
+#endif
+#ifdef CONFIG_WIFI_RX_BATCH
+    rx_batch_stats.frames++;
+#endif
+    /* Frames arriving while a drain is pending ride along with it */
+    if (!rx_handoff_pending)
+    {
+#ifdef CONFIG_WIFI_RX_BATCH
+        rx_batch_count++;
+        arm = (rx_batch_count == 1U);
+        if (rx_batch_count >= rx_batch_cfg.max_frames)
+        {
+            rx_batch_stats.flush_full++;
+            if (rx_batch_count > rx_batch_stats.max_batch)
+            {
+                rx_batch_stats.max_batch = rx_batch_count;
+            }
+            rx_batch_count     = 0;
+            rx_handoff_pending = true;
+            post               = true;
+            arm                = false;
+        }
+#else
+        rx_handoff_pending = true;
+        post               = true;
+#endif
+    }
+    SYS_ARCH_UNPROTECT(lev);
+
+#ifdef CONFIG_WIFI_RX_BATCH
+    if (post)
+    {
+        if (rx_batch_timer != NULL)
+        {
+            (void)os_timer_deactivate(&rx_batch_timer);
+        }
+    }
+    else if (arm && (rx_batch_cfg.max_latency_ms == 0U || rx_batch_timer == NULL ||
+                     os_timer_change(&rx_batch_timer, os_msec_to_ticks(rx_batch_cfg.max_latency_ms), 0) != WM_SUCCESS ||
+                     os_timer_activate(&rx_batch_timer) != WM_SUCCESS))
+    {
+        /* Without the latency bound, do not hold the frame back */
+        rx_batch_flush(&rx_batch_stats.flush_timer);
+    }
+    else
+    {
+        /* Do nothing */
+    }
+#endif
+
+    if (post)
+    {
+        rx_handoff_post();
+    }
+
+    return WM_SUCCESS;
+}
+
+#ifdef CONFIG_WIFI_RX_PRIO
+int net_get_rx_prio_stats(struct net_rx_prio_stats *stats)
+{
+    t_u8 ac;
+
+    if (stats == NULL)
+    {
+        return -WM_E_INVAL;
+    }
+
+    (void)memcpy((void *)stats, (const void *)&rx_prio_stats, sizeof(*stats));
+    for (ac = 0; ac < NET_RX_PRIO_NUM_AC; ac++)
+    {
+        stats->ac[ac].avg_latency_ms =
+            (stats->ac[ac].delivered != 0U) ? (uint32_t)(rx_prio_lat_sum[ac] / stats->ac[ac].delivered) : 0U;
+    }
+
+    return WM_SUCCESS;
+}
+
+void net_reset_rx_prio_stats(void)
+{
+    t_u8 ac;
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    SYS_ARCH_PROTECT(lev);
+    (void)memset((void *)&rx_prio_stats, 0, sizeof(rx_prio_stats));
+    (void)memset((void *)rx_prio_lat_sum, 0, sizeof(rx_prio_lat_sum));
+    for (ac = 0; ac < NET_RX_PRIO_NUM_AC; ac++)
+    {
+        rx_prio_stats.ac[ac].depth = rx_handoff_q[ac].count;
+    }
+    SYS_ARCH_UNPROTECT(lev);
+}
+#endif /* CONFIG_WIFI_RX_PRIO */
+#endif /* CONFIG_WIFI_RX_PRIO || CONFIG_WIFI_RX_BATCH */
+
+#ifdef CONFIG_WIFI_MAX_MTU
+/*
+ * The netif MTU may be raised up to MLAN_MAX_MTU for links between our own
+ * devices. A peer is assumed to take NET_MTU_DEFAULT unless it was set up
+ * with net_set_peer_mtu() or has sent us a larger IP packet. Larger IPv4
+ * datagrams to other peers are fragmented again at the peer MTU, other
+ * oversized frames are dropped. TCP keeps to the MSS the peer advertised.
+ * IPv6 cannot be fragmented on the way, so its MTU stays at NET_MTU_DEFAULT.
+ */
+#if (PBUF_POOL_BUFSIZE < (SIZEOF_ETH_HDR + SIZEOF_ETH_LLC_HDR + MLAN_MAX_MTU))
+#error "PBUF_POOL_BUFSIZE must hold a CONFIG_WIFI_MAX_MTU frame, raise TCP_MSS or PBUF_POOL_BUFSIZE in lwipopts.h"
+#endif
+#if defined(CONFIG_IPV6) && !LWIP_ND6_ALLOW_RA_UPDATES
+#error "CONFIG_WIFI_MAX_MTU with CONFIG_IPV6 needs LWIP_ND6_ALLOW_RA_UPDATES for a separate IPv6 MTU"
+#endif
+
+#ifndef CONFIG_WIFI_MTU_PEER_NUM
+#define MTU_PEER_NUM 8U
+#else
+#define MTU_PEER_NUM CONFIG_WIFI_MTU_PEER_NUM
+#endif
+
+typedef struct
+{
+    t_u8 mac[MLAN_MAC_ADDR_LENGTH];
+    /* 0 marks a free slot */
+    t_u16 mtu;
+} mtu_peer_t;
+
+static mtu_peer_t mtu_peers[MTU_PEER_NUM];
+/* Slot reused next once the table is full */
+static t_u8 mtu_peer_next;
+
+static err_t low_level_output(struct netif *netif, struct pbuf *p);
+
+static mtu_peer_t *mtu_peer_find(const t_u8 *mac)
+{
+    t_u8 i;
+
+    for (i = 0; i < MTU_PEER_NUM; i++)
+    {
+        if (mtu_peers[i].mtu != 0U && memcmp(mtu_peers[i].mac, mac, MLAN_MAC_ADDR_LENGTH) == 0)
+        {
+            return &mtu_peers[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* called with the TCP/IP core locked */
+static void mtu_peer_set(const t_u8 *mac, t_u16 mtu)
+{
+    mtu_peer_t *peer = mtu_peer_find(mac);
+
+    if (peer == NULL)
+    {
+        if (mtu == NET_MTU_DEFAULT)
+        {
+            return;
+        }
+        peer          = &mtu_peers[mtu_peer_next];
+        mtu_peer_next = (t_u8)((mtu_peer_next + 1U) % MTU_PEER_NUM);
+        (void)memcpy(peer->mac, mac, MLAN_MAC_ADDR_LENGTH);
+    }
+
+    peer->mtu = (mtu == NET_MTU_DEFAULT) ? 0U : mtu;
+}
+
+/* Largest IP packet the station at mac takes */
+static u16_t mtu_peer_get(const t_u8 *mac)
+{
+    const mtu_peer_t *peer;
+
+    if ((mac[0] & 0x01U) != 0U)
+    {
+        return NET_MTU_DEFAULT;
+    }
+
+    peer = mtu_peer_find(mac);
+
+    return (peer != NULL) ? peer->mtu : NET_MTU_DEFAULT;
+}
+
+/* Remember a peer that sent an IP packet above the default MTU */
+static void mtu_peer_learn(const struct pbuf *p, u16_t type)
+{
+    const struct eth_hdr *ethhdr = p->payload;
+    const t_u8 *ip               = (const t_u8 *)p->payload + SIZEOF_ETH_HDR;
+    const mtu_peer_t *peer;
+    t_u32 len;
+
+    if (p->len < (SIZEOF_ETH_HDR + 6U))
+    {
+        return;
+    }
+
+    if (type == ETHTYPE_IP)
+    {
+        len = ((t_u32)ip[2] << 8) | ip[3];
+    }
+#ifdef CONFIG_IPV6
+    else if (type == ETHTYPE_IPV6)
+    {
+        len = IP6_HLEN + (((t_u32)ip[4] << 8) | ip[5]);
+    }
+#endif
+    else
+    {
+        return;
+    }
+
+    if (len <= NET_MTU_DEFAULT || len > MLAN_MAX_MTU)
+    {
+        return;
+    }
+
+    peer = mtu_peer_find(ethhdr->src.addr);
+    if (peer != NULL && peer->mtu >= len)
+    {
+        return;
+    }
+
+    LOCK_TCPIP_CORE();
+    mtu_peer_set(ethhdr->src.addr, (t_u16)len);
+    UNLOCK_TCPIP_CORE();
+    wifi_stats_inc(WIFI_STAT_MTU_PEERS_LEARNED);
+}
+
+/* linkoutput: keep frames within the MTU of their destination */
+static err_t mtu_output(struct netif *netif, struct pbuf *p)
+{
+    const struct eth_hdr *ethhdr = p->payload;
+    u16_t peer_mtu;
+
+    if (p->tot_len <= (SIZEOF_ETH_HDR + NET_MTU_DEFAULT))
+    {
+        return low_level_output(netif, p);
+    }
+
+    peer_mtu = MIN(mtu_peer_get(ethhdr->dest.addr), netif->mtu);
+    if (p->tot_len <= (SIZEOF_ETH_HDR + peer_mtu))
+    {
+        wifi_stats_inc(WIFI_STAT_MTU_TX_LARGE);
+        return low_level_output(netif, p);
+    }
+
+#if LWIP_IPV4 && IP_FRAG
+    if (ethhdr->type == PP_HTONS(ETHTYPE_IP))
+    {
+        const struct ip_hdr *iphdr = (const struct ip_hdr *)(const void *)((const t_u8 *)p->payload + SIZEOF_ETH_HDR);
+        u16_t mtu                  = netif->mtu;
+        ip4_addr_t dest;
+        err_t ret;
+
+        if ((IPH_OFFSET(iphdr) & PP_HTONS(IP_DF)) == 0U)
+        {
+            ip4_addr_copy(dest, iphdr->dest);
+            (void)pbuf_header(p, -(s16_t)SIZEOF_ETH_HDR);
+
+            /* ip4_frag() sizes the fragments by the netif MTU */
+            netif->mtu = peer_mtu;
+            ret        = ip4_frag(p, netif, &dest);
+            netif->mtu = mtu;
+
+            (void)pbuf_header(p, (s16_t)SIZEOF_ETH_HDR);
+            wifi_stats_inc(WIFI_STAT_MTU_TX_REFRAG);
+            return ret;
+        }
+    }
+#endif
+
+    wifi_stats_inc(WIFI_STAT_MTU_TX_DROP);
+    WIFI_LINK_STATS_INC(drop, WIFI_STAT_LINK_DROP);
+    return ERR_MEM;
+}
+
+int net_set_mtu(enum wlan_bss_type bss_type, uint16_t mtu)
+{
+    if ((t_u32)bss_type >= MAX_INTERFACES_SUPPORTED || netif_arr[bss_type] == NULL || mtu < NET_MTU_DEFAULT ||
+        mtu > MLAN_MAX_MTU)
+    {
+        return -WM_E_INVAL;
+    }
+
+    LOCK_TCPIP_CORE();
+    netif_arr[bss_type]->mtu = mtu;
+#ifdef CONFIG_IPV6
+    if (netif_arr[bss_type]->mtu6 > NET_MTU_DEFAULT)
+    {
+        netif_arr[bss_type]->mtu6 = NET_MTU_DEFAULT;
+    }
+#endif
+    UNLOCK_TCPIP_CORE();
+
+    return WM_SUCCESS;
+}
+
+int net_get_mtu(enum wlan_bss_type bss_type, uint16_t *mtu)
+{
+    if ((t_u32)bss_type >= MAX_INTERFACES_SUPPORTED || netif_arr[bss_type] == NULL || mtu == NULL)
+    {
+        return -WM_E_INVAL;
+    }
+
+    *mtu = netif_arr[bss_type]->mtu;
+
+    return WM_SUCCESS;
+}
+
+int net_set_peer_mtu(const uint8_t *mac, uint16_t mtu)
+{
+    if (mac == NULL || (mac[0] & 0x01U) != 0U || mtu < NET_MTU_DEFAULT || mtu > MLAN_MAX_MTU)
+    {
+        return -WM_E_INVAL;
+    }
+
+    LOCK_TCPIP_CORE();
+    mtu_peer_set(mac, mtu);
+    UNLOCK_TCPIP_CORE();
+
+    return WM_SUCCESS;
+}
+
+int net_get_mtu_stats(struct net_mtu_stats *stats)
+{
+    wifi_stats_snapshot_t snap;
+
+    if (stats == NULL)
+    {
+        return -WM_E_INVAL;
+    }
+
+    (void)wifi_stats_snapshot(&snap);
+
+    stats->tx_large      = snap.cnt[WIFI_STAT_MTU_TX_LARGE];
+    stats->tx_refrag     = snap.cnt[WIFI_STAT_MTU_TX_REFRAG];
+    stats->tx_drop       = snap.cnt[WIFI_STAT_MTU_TX_DROP];
+    stats->peers_learned = snap.cnt[WIFI_STAT_MTU_PEERS_LEARNED];
+
+    return WM_SUCCESS;
+}
+#endif /* CONFIG_WIFI_MAX_MTU */
+
+static void deliver_packet_above(struct pbuf *p, int recv_interface, t_u8 prio)
 {
     err_t lwiperr = ERR_OK;
     /* points to packet payload, which starts with an Ethernet header */
@@ -94,7 +830,13 @@ static void deliver_packet_above(struct pbuf *p, int recv_interface)
         case ETHTYPE_IPV6:
 #endif
         case ETHTYPE_ARP:
-            LINK_STATS_INC(link.recv);
+            WIFI_LINK_STATS_INC(recv, WIFI_STAT_LINK_RECV);
+#ifdef CONFIG_WIFI_MAX_MTU
+            if (p->tot_len > (SIZEOF_ETH_HDR + NET_MTU_DEFAULT))
+            {
+                mtu_peer_learn(p, htons(ethhdr->type));
+            }
+#endif
 
             if ((unsigned)recv_interface >= MAX_INTERFACES_SUPPORTED)
             {
@@ -103,18 +845,29 @@ static void deliver_packet_above(struct pbuf *p, int recv_interface)
                     ;
                 }
             }
+#if defined(CONFIG_WIFI_RX_PRIO) || defined(CONFIG_WIFI_RX_BATCH)
+            if (rx_handoff_enqueue(p, (t_u8)recv_interface, prio) != WM_SUCCESS)
+            {
+                WIFI_LINK_STATS_INC(drop, WIFI_STAT_LINK_DROP);
+                (void)pbuf_free(p);
+                p = NULL;
+            }
+            break;
+#else
+            (void)prio;
+#endif
             /* full packet send to tcpip_thread to process */
             lwiperr = netif_arr[recv_interface]->input(p, netif_arr[recv_interface]);
             if (lwiperr != (s8_t)ERR_OK)
             {
-                LINK_STATS_INC(link.proterr);
+                WIFI_LINK_STATS_INC(proterr, WIFI_STAT_LINK_PROTERR);
                 LWIP_DEBUGF(NETIF_DEBUG, ("ethernetif_input: IP input error\n"));
                 (void)pbuf_free(p);
                 p = NULL;
             }
             break;
         case ETHTYPE_EAPOL:
-            LINK_STATS_INC(link.recv);
+            WIFI_LINK_STATS_INC(recv, WIFI_STAT_LINK_RECV);
 
 #ifdef CONFIG_WPA_SUPP
             if (l2_packet_rx_callback)
@@ -128,7 +881,7 @@ static void deliver_packet_above(struct pbuf *p, int recv_interface)
             break;
         default:
             /* drop the packet */
-            LINK_STATS_INC(link.drop);
+            WIFI_LINK_STATS_INC(drop, WIFI_STAT_LINK_DROP);
             (void)pbuf_free(p);
             p = NULL;
             break;
@@ -137,6 +890,9 @@ static void deliver_packet_above(struct pbuf *p, int recv_interface)
 
 static struct pbuf *gen_pbuf_from_data(t_u8 *payload, t_u16 datalen)
 {
+    struct pbuf *q;
+    t_u16 copied = 0;
+
     /* We allocate a pbuf chain of pbufs from the pool. */
     struct pbuf *p = pbuf_alloc(PBUF_RAW, datalen, PBUF_POOL);
     if (p == NULL)
@@ -144,15 +900,30 @@ static struct pbuf *gen_pbuf_from_data(t_u8 *payload, t_u16 datalen)
         return NULL;
     }
 
-    if (pbuf_take(p, payload, datalen) != 0)
+    for (q = p; q != NULL && copied < datalen; q = q->next)
     {
-        (void)pbuf_free(p);
-        p = NULL;
+        wifi_dp_copy(q->payload, payload + copied, q->len);
+        copied += q->len;
     }
 
     return p;
 }
 
+/* copy a whole pbuf chain into a flat buffer */
+static u16_t copy_pbuf_to_buf(struct pbuf *p, t_u8 *buf)
+{
+    struct pbuf *q;
+    u16_t copied = 0;
+
+    for (q = p; q != NULL && copied < p->tot_len; q = q->next)
+    {
+        wifi_dp_copy(buf + copied, q->payload, q->len);
+        copied += q->len;
+    }
+
+    return copied;
+}
+
 static void process_data_packet(const t_u8 *rcvdata, const t_u16 datalen)
 {
     RxPD *rxpd                   = (RxPD *)(void *)((t_u8 *)rcvdata + INTF_HEADER_LEN);
@@ -193,6 +964,19 @@ static void process_data_packet(const t_u8 *rcvdata, const t_u16 datalen)
     {
         g_data_nf_last  = rxpd->nf;
         g_data_snr_last = rxpd->snr;
+
+        if (rxpd->rx_pkt_type != PKT_TYPE_MGMT_FRAME)
+        {
+            const Eth803Hdr_t *eth = (const Eth803Hdr_t *)((t_u8 *)rxpd + rxpd->rx_pkt_offset);
+
+            wifi_link_mon_rx((t_u8)recv_interface, eth->src_addr, rxpd->snr, rxpd->nf, rxpd->rx_rate,
+#ifdef SD8801
+                             rxpd->ht_info
+#else
+                             rxpd->rate_info
+#endif
+            );
+        }
     }
 
 #ifndef CONFIG_WPA_SUPP
@@ -230,8 +1014,8 @@ static void process_data_packet(const t_u8 *rcvdata, const t_u16 datalen)
        lost. We have to go back and read the other ports */
     if (p == NULL)
     {
-        LINK_STATS_INC(link.memerr);
-        LINK_STATS_INC(link.drop);
+        WIFI_LINK_STATS_INC(memerr, WIFI_STAT_LINK_MEMERR);
+        WIFI_LINK_STATS_INC(drop, WIFI_STAT_LINK_DROP);
         return;
     }
 
@@ -313,7 +1097,7 @@ static void process_data_packet(const t_u8 *rcvdata, const t_u16 datalen)
 #endif
         /* Unicast ARP also need do rx reorder */
         case ETHTYPE_ARP:
-            LINK_STATS_INC(link.recv);
+            WIFI_LINK_STATS_INC(recv, WIFI_STAT_LINK_RECV);
             if (recv_interface == MLAN_BSS_TYPE_STA)
             {
                 int rv = wrapper_wlan_handle_rx_packet(datalen, rxpd, p, payload);
@@ -321,24 +1105,24 @@ static void process_data_packet(const t_u8 *rcvdata, const t_u16 datalen)
                 {
                     /* mlan was unsuccessful in delivering the
                        packet */
-                    LINK_STATS_INC(link.drop);
+                    WIFI_LINK_STATS_INC(drop, WIFI_STAT_LINK_DROP);
                     (void)pbuf_free(p);
                 }
             }
             else
             {
                 wrapper_wlan_update_uap_rxrate_info(rxpd);
-                deliver_packet_above(p, recv_interface);
+                deliver_packet_above(p, recv_interface, rxpd->priority);
             }
             p = NULL;
             break;
         case ETHTYPE_EAPOL:
-            LINK_STATS_INC(link.recv);
-            deliver_packet_above(p, recv_interface);
+            WIFI_LINK_STATS_INC(recv, WIFI_STAT_LINK_RECV);
+            deliver_packet_above(p, recv_interface, rxpd->priority);
             break;
         default:
             /* fixme: avoid pbuf allocation in this case */
-            LINK_STATS_INC(link.drop);
+            WIFI_LINK_STATS_INC(drop, WIFI_STAT_LINK_DROP);
             (void)pbuf_free(p);
             p = NULL;
             break;
@@ -354,27 +1138,27 @@ void handle_data_packet(const t_u8 interface, const t_u8 *rcvdata, const t_u16 d
     }
 }
 
-void handle_amsdu_data_packet(t_u8 interface, t_u8 *rcvdata, t_u16 datalen)
+void handle_amsdu_data_packet(t_u8 interface, t_u8 *rcvdata, t_u16 datalen, t_u8 priority)
 {
 
     struct pbuf *p = gen_pbuf_from_data(rcvdata, datalen);
     if (p == NULL)
     {
         w_pkt_e("[amsdu] No pbuf available. Dropping packet");
-        LINK_STATS_INC(link.memerr);
-        LINK_STATS_INC(link.drop);
+        WIFI_LINK_STATS_INC(memerr, WIFI_STAT_LINK_MEMERR);
+        WIFI_LINK_STATS_INC(drop, WIFI_STAT_LINK_DROP);
         return;
     }
-    LINK_STATS_INC(link.recv);
-    deliver_packet_above(p, interface);
+    WIFI_LINK_STATS_INC(recv, WIFI_STAT_LINK_RECV);
+    /* all subframes carry the priority of the A-MSDU's RxPD */
+    deliver_packet_above(p, interface, priority);
 }
 
 void handle_deliver_packet_above(t_void *rxpd, t_u8 interface, t_void *lwip_pbuf)
 {
     struct pbuf *p = (struct pbuf *)lwip_pbuf;
 
-    (void)rxpd;
-    deliver_packet_above(p, interface);
+    deliver_packet_above(p, interface, ((RxPD *)rxpd)->priority);
 }
 
 bool wrapper_net_is_ip_or_ipv6(const t_u8 *buffer)
@@ -397,8 +1181,8 @@ static void low_level_init(struct netif *netif)
     /* set MAC hardware address length */
     netif->hwaddr_len = ETHARP_HWADDR_LEN;
 
-    /* maximum transfer unit */
-    netif->mtu = 1500;
+    /* maximum transfer unit, raised only by net_set_mtu() */
+    netif->mtu = NET_MTU_DEFAULT;
 
     /* device capabilities */
     /* don't set NETIF_FLAG_ETHARP if this device is not an ethernet one */
@@ -537,7 +1321,7 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
     {
         memset(wmm_outbuf, 0x00, pkt_len);
 
-        uCopied = pbuf_copy_partial(p, wmm_outbuf + pkt_len, p->tot_len, 0);
+        uCopied = copy_pbuf_to_buf(p, wmm_outbuf + pkt_len);
 
         LWIP_ASSERT("uCopied != p->tot_len", uCopied == p->tot_len);
         pkt_len += p->tot_len;
@@ -560,18 +1344,18 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
 
     if (ret == WM_SUCCESS)
     {
-        LINK_STATS_INC(link.xmit);
+        WIFI_LINK_STATS_INC(xmit, WIFI_STAT_LINK_XMIT);
         return ERR_OK;
     }
 
     if (ret == -WM_E_NOMEM)
     {
-        LINK_STATS_INC(link.err);
+        WIFI_LINK_STATS_INC(err, WIFI_STAT_LINK_ERR);
         ret = ERR_MEM;
     }
     else if (ret == -WM_E_BUSY)
     {
-        LINK_STATS_INC(link.err);
+        WIFI_LINK_STATS_INC(err, WIFI_STAT_LINK_ERR);
         ret = ERR_TIMEOUT;
     }
     else
@@ -837,6 +1621,30 @@ err_t lwip_netif_init(struct netif *netif)
      */
     NETIF_INIT_SNMP(netif, snmp_ifType_ethernet_csmacd, LINK_SPEED_OF_YOUR_NETIF_IN_BPS);
 
+#if defined(CONFIG_WIFI_RX_PRIO) || defined(CONFIG_WIFI_RX_BATCH)
+    if (rx_handoff_retry_timer == NULL)
+    {
+        if (os_timer_create(&rx_handoff_retry_timer, "rx-handoff-retry", 1, rx_handoff_retry_cb, NULL,
+                            OS_TIMER_ONE_SHOT, OS_TIMER_NO_ACTIVATE) != WM_SUCCESS)
+        {
+            /* Failed posts are then retried by the next arrival only */
+            rx_handoff_retry_timer = NULL;
+        }
+    }
+#endif
+
+#ifdef CONFIG_WIFI_RX_BATCH
+    if (rx_batch_timer == NULL)
+    {
+        if (os_timer_create(&rx_batch_timer, "rx-batch-timer", os_msec_to_ticks(RX_BATCH_LATENCY_MS),
+                            rx_batch_timer_cb, NULL, OS_TIMER_ONE_SHOT, OS_TIMER_NO_ACTIVATE) != WM_SUCCESS)
+        {
+            /* Batches are then flushed at the end of each read cycle only */
+            rx_batch_timer = NULL;
+        }
+    }
+#endif
+
     ethernetif->interface = MLAN_BSS_TYPE_STA;
     netif->state          = ethernetif;
     netif->name[0]        = IFNAME0;
@@ -845,8 +1653,12 @@ err_t lwip_netif_init(struct netif *netif)
      * You can instead declare your own function an call etharp_output()
      * from it if you have to do some checks before sending (e.g. if link
      * is available...) */
-    netif->output     = etharp_output;
+    netif->output = etharp_output;
+#ifdef CONFIG_WIFI_MAX_MTU
+    netif->linkoutput = mtu_output;
+#else
     netif->linkoutput = low_level_output;
+#endif
 #ifdef CONFIG_IPV6
     netif->output_ip6 = ethip6_output;
 #endif
@@ -884,8 +1696,12 @@ err_t lwip_netif_uap_init(struct netif *netif)
      * You can instead declare your own function an call etharp_output()
      * from it if you have to do some checks before sending (e.g. if link
      * is available...) */
-    netif->output     = etharp_output;
+    netif->output = etharp_output;
+#ifdef CONFIG_WIFI_MAX_MTU
+    netif->linkoutput = mtu_output;
+#else
     netif->linkoutput = low_level_output;
+#endif
 #ifdef CONFIG_IPV6
     netif->output_ip6 = ethip6_output;
 #endif
@@ -47,6 +47,59 @@ static void wlan_card_fw_status(t_u16 *dat)
     *dat |= (t_u16)((resp & 0xffU) << 8);
 }
 
+bool wlan_card_fw_running(void)
+{
+    t_u16 dat = 0U;
+
+    wlan_card_fw_status(&dat);
+
+    return (dat == FIRMWARE_READY) ? true : false;
+}
+
+#ifdef CONFIG_WIFI_WARM_START
+/*
+ * Put a running firmware back into download mode, e.g. after only the
+ * host was reset. Cards without a firmware reset register get an SDIO
+ * I/O reset and are set up again.
+ */
+int32_t wlan_card_fw_reset(void)
+{
+    uint32_t resp = 0;
+    t_u32 i;
+
+#ifdef CARD_FW_RESET_REG
+    if (sdio_drv_creg_write(CARD_FW_RESET_REG, 1, (uint8_t)CARD_FW_RESET_VAL, &resp) == false)
+    {
+        return FWDNLD_STATUS_FAILURE;
+    }
+#else
+    if (sdio_drv_creg_write(SDIO_CCCR_IO_ABORT_REG, 0, (uint8_t)SDIO_CCCR_IO_ABORT_RES, &resp) == false)
+    {
+        return FWDNLD_STATUS_FAILURE;
+    }
+
+    sdio_drv_deinit();
+    if (sdio_init() != 0 || sdio_ioport_init() != 0)
+    {
+        return FWDNLD_STATUS_FAILURE;
+    }
+#endif
+
+    for (i = 0; i < MAX_POLL_TRIES; i++)
+    {
+        if (wlan_card_fw_running() == false)
+        {
+            fwdnld_io_d("Firmware reset done");
+            return FWDNLD_STATUS_SUCCESS;
+        }
+        OSA_TimeDelay(10U);
+    }
+
+    fwdnld_io_e("Firmware still running after reset");
+    return FWDNLD_STATUS_FAILURE;
+}
+#endif
+
 static bool wlan_card_ready_wait(t_u32 card_poll)
 {
     t_u16 dat = 0U;
@@ -10,12 +10,19 @@
 #ifndef _FIMRWARE_DNLD_H_
 #define _FIMRWARE_DNLD_H_
 
+#include "type_decls.h"
+
 /** Card Control Registers : Function 1 Block size 0 */
 #define FN1_BLOCK_SIZE_0 0x110
 /** Card Control Registers : Function 1 Block size 1 */
 #define FN1_BLOCK_SIZE_1 0x111
 
+/* A frame above 2048 bytes takes a fifth SDIO block */
+#if (MLAN_MAX_DATA_FRAME_LEN > 2048U)
+#define SDIO_OUTBUF_LEN 2560U
+#else
 #define SDIO_OUTBUF_LEN 2048U
+#endif
 
 /** The number of times to try when polling for status bits */
 #define MAX_POLL_TRIES 100U
@@ -36,4 +43,12 @@ extern t_u32 ioport_g;
 
 int32_t firmware_download(const uint8_t *fw_start_addr, const size_t size);
 
+/* True if the card reports a running firmware */
+bool wlan_card_fw_running(void);
+
+#ifdef CONFIG_WIFI_WARM_START
+/* Put a running firmware back into download mode, 0 on success */
+int32_t wlan_card_fw_reset(void);
+#endif
+
 #endif //_FIMRWARE_DNLD_H_
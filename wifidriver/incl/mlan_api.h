@@ -189,7 +189,7 @@ static inline mlan_status wifi_check_bss_entry_wpa2_entp_only(BSSDescriptor_t *p
 {
     if (element_id == RSN_IE)
     {
-        (void)check_for_wpa2_entp_ie(&pbss_entry->wpa2_entp_IE_exist, pbss_entry->rsn_ie_buff + 8,
+        (void)check_for_wpa2_entp_ie(&pbss_entry->wpa2_entp_IE_exist, (t_u8 *)pbss_entry->prsn_ie + 8,
                                      pbss_entry->rsn_ie_buff_len - 10);
     }
     return MLAN_STATUS_SUCCESS;
@@ -400,6 +400,8 @@ int wrapper_bssdesc_second_set(int bss_index,
 #endif
 );
 
+int wrapper_bssdesc_view(int bss_index, wifi_scan_view_t *view);
+
 int wifi_get_mgmt_ie2(mlan_bss_type bss_type, void *buf, unsigned int *buf_len);
 int wifi_set_mgmt_ie2(mlan_bss_type bss_type, unsigned short mask, void *buf, unsigned int buf_len);
 int wifi_clear_mgmt_ie2(mlan_bss_type bss_type, int mgmt_bitmap_index);
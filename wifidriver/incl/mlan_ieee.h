@@ -1834,6 +1834,46 @@ typedef MLAN_PACK_START struct _IEEEtypes_MobilityDomain_t
 } MLAN_PACK_END IEEEtypes_MobilityDomain_t;
 #endif
 
+/** BSSDescriptorIEs_t
+ *    IE copies retained from a beacon/probe response
+ *
+ *  Since we do not save the beacon buffer because it is too huge for us
+ *  we need to save selected IEs for later perusal. The IE pointers in
+ *  BSSDescriptor_t point into this storage.
+ */
+typedef struct _BSSDescriptorIEs_t
+{
+    IEEEtypes_HTCap_t ht_cap_saved;
+    IEEEtypes_HTInfo_t ht_info_saved;
+    IEEEtypes_2040BSSCo_t bss_co_2040_saved;
+#ifdef CONFIG_11AC
+    IEEEtypes_VHTCap_t vht_cap_saved;
+    IEEEtypes_VHTOprat_t vht_oprat_saved;
+    IEEEtypes_VHTtxpower_t vht_txpower_saved;
+    IEEEtypes_OperModeNtf_t poper_mode_saved;
+#endif
+    IEEEtypes_ExtCap_t ext_cap_saved;
+    /*
+      fixme: The legacy code used IEEEtypes_RSN_IE_t which is of 24
+      bytes. There seems to be confusion about the exact structure to
+      use in this situation. Seems that 256 bytes are used by
+      mlan_private (wpa_ie). We cannot use that much here. Lets take a
+      reasonable amount.
+    */
+    unsigned char wpa_ie_buff[MLAN_WMSDK_MAX_WPA_IE_LEN];
+    unsigned char rsn_ie_buff[MLAN_WMSDK_MAX_WPA_IE_LEN];
+    IEEEtypes_Rsnx_t rsnx_ie_saved;
+#if defined(CONFIG_11R) || defined(CONFIG_11K)
+    unsigned char md_ie_buff[MLAN_MAX_MDIE_LEN];
+#endif
+#ifdef CONFIG_11K
+    IEEEtypes_RrmElement_t rm_cap_saved;
+    unsigned char vendor_ie_buff[MLAN_MAX_VENDOR_IE_LEN];
+#endif
+    /** Country information set */
+    IEEEtypes_CountryInfoFullSet_t country_info;
+} BSSDescriptorIEs_t;
+
 /** BSSDescriptor_t
  *    Structure used to store information for beacon/probe response
  */
@@ -1967,7 +2007,7 @@ typedef struct _BSSDescriptor_t
     t_u16 overlap_bss_offset;
 
     /** Country information set */
-    IEEEtypes_CountryInfoFullSet_t country_info;
+    IEEEtypes_CountryInfoFullSet_t *pcountry_info;
 
     /** WPA IE */
     IEEEtypes_VendorSpecific_t *pwpa_ie;
@@ -1998,33 +2038,19 @@ typedef struct _BSSDescriptor_t
 
     /* Added for WMSDK */
 
-    /*
-     * Since we do not save the beacon buffer because it is too huge
-     * for us we need to save selected data structures for later
-     * perusal.
-     */
-    IEEEtypes_HTCap_t ht_cap_saved;
-    IEEEtypes_HTInfo_t ht_info_saved;
-    IEEEtypes_2040BSSCo_t bss_co_2040_saved;
-
-#ifdef CONFIG_11AC
-    IEEEtypes_VHTCap_t vht_cap_saved;
-    IEEEtypes_VHTOprat_t vht_oprat_saved;
-    IEEEtypes_VHTtxpower_t vht_txpower_saved;
-    IEEEtypes_OperModeNtf_t poper_mode_saved;
+#ifdef CONFIG_COMPACT_SCAN_TABLE
+    /** Retained IEs packed in the shared scan IE arena */
+    t_u8 *ie_blob;
+    /** Bytes of ie_blob in use */
+    t_u16 ie_blob_len;
+    /** Bytes of ie_blob used by IEs other than the security ones */
+    t_u16 ie_opt_len;
+#else
+    /** Retained IEs */
+    BSSDescriptorIEs_t saved;
 #endif
-    IEEEtypes_ExtCap_t ext_cap_saved;
     bool ext_cap_exist;
-    /*
-      fixme: The legacy code used IEEEtypes_RSN_IE_t which is of 24
-      bytes. There seems to be confusion about the exact structure to
-      use in this situation. Seems that 256 bytes are used by
-      mlan_private (wpa_ie). We cannot use that much here. Lets take a
-      reasonable amount.
-    */
-    unsigned char wpa_ie_buff[MLAN_WMSDK_MAX_WPA_IE_LEN];
     size_t wpa_ie_buff_len;
-    unsigned char rsn_ie_buff[MLAN_WMSDK_MAX_WPA_IE_LEN];
     size_t rsn_ie_buff_len;
 
     bool wps_IE_exist;
@@ -2033,11 +2059,9 @@ typedef struct _BSSDescriptor_t
     bool wpa2_entp_IE_exist;
     /** RSNX IE */
     IEEEtypes_Rsnx_t *prsnx_ie;
-    IEEEtypes_Rsnx_t rsnx_ie_saved;
     /** RSNX IE offset in the beacon buffer */
     t_u16 rsnx_offset;
 #if defined(CONFIG_11R) || defined(CONFIG_11K)
-    unsigned char md_ie_buff[MLAN_MAX_MDIE_LEN];
     size_t md_ie_buff_len;
     /* Mobility domain IE */
     IEEEtypes_MobilityDomain_t *pmd_ie;
@@ -2045,8 +2069,10 @@ typedef struct _BSSDescriptor_t
 #endif
 #ifdef CONFIG_11K
     bool rm_cap_exist;
-    IEEEtypes_RrmElement_t rm_cap_saved;
-    unsigned char vendor_ie_buff[MLAN_MAX_VENDOR_IE_LEN];
+    /** RRM Enabled Capabilities IE */
+    IEEEtypes_RrmElement_t *prm_cap;
+    /** Vendor specific IEs not parsed above, concatenated */
+    t_u8 *pvendor_ie;
     t_u8 vendor_ie_len;
     bool neighbor_report_supported;
 #endif
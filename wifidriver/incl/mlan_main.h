@@ -396,6 +396,30 @@ extern t_void (*assert_callback)(IN t_void *pmoal_handle, IN t_u32 cond);
 #define MRVDRV_MAX_MULTICAST_LIST_SIZE 32
 /** Maximum size of channel */
 #define MRVDRV_MAX_CHANNEL_SIZE 14
+
+#ifdef CONFIG_COMPACT_SCAN_TABLE
+/** Alignment of each IE packed in the scan IE arena */
+#define BSS_IE_ALIGN(x) (((x) + 3U) & ~3U)
+/** Stored RSNX IE length, sizeof(IEEEtypes_Rsnx_t) spelled out for the
+ *  preprocessor check of CONFIG_BSS_IE_ARENA_SIZE */
+#define BSS_IE_RSNX_LEN 3U
+/** Worst case security IE bytes (WPA, RSN, RSNX, MD) of one BSS */
+#define BSS_IE_SEC_MAX                                                                     \
+    ((2U * BSS_IE_ALIGN(MLAN_WMSDK_MAX_WPA_IE_LEN)) + BSS_IE_ALIGN(BSS_IE_RSNX_LEN) + \
+     BSS_IE_ALIGN(MLAN_MAX_MDIE_LEN))
+/** Largest IE blob a single BSS can need */
+#define BSS_IE_BLOB_MAX (sizeof(BSSDescriptorIEs_t) + (16U * 3U))
+/** Shared scan IE arena size. Security IEs of every table entry are
+ *  always guaranteed to fit, the rest is shared by the other IEs. */
+#ifndef CONFIG_BSS_IE_ARENA_SIZE
+#define BSS_IE_ARENA_SIZE (MRVDRV_MAX_BSSID_LIST * 288U)
+#else
+#if (CONFIG_BSS_IE_ARENA_SIZE) < (MRVDRV_MAX_BSSID_LIST * BSS_IE_SEC_MAX)
+#error "CONFIG_BSS_IE_ARENA_SIZE must hold the security IEs of every scan table entry (MRVDRV_MAX_BSSID_LIST * BSS_IE_SEC_MAX)"
+#endif
+#define BSS_IE_ARENA_SIZE CONFIG_BSS_IE_ARENA_SIZE
+#endif
+#endif
 /** Maximum length of SSID */
 #define MRVDRV_MAX_SSID_LENGTH 32U
 /** WEP list macros & data structures */
@@ -713,6 +737,44 @@ typedef struct _txAggr_t
     t_u32 txba_thresh;
 } tx_aggr_t;
 
+#ifdef CONFIG_WMM
+/** TX aggregation tuner favours latency */
+#define AGGR_TUNE_MODE_LATENCY 0
+/** TX aggregation tuner favours throughput */
+#define AGGR_TUNE_MODE_BULK 1
+
+/** TX aggregation tuner state of an RA list */
+typedef struct _aggr_tune_t
+{
+    /** time in msec at which the current window started */
+    t_u32 win_start;
+    /** packets dequeued in the window */
+    t_u16 win_pkts;
+    /** small packets dequeued in the window */
+    t_u16 win_small;
+    /** sum of the queue depth seen at each dequeue */
+    t_u32 win_depth;
+    /** bytes dequeued in the window */
+    t_u32 win_bytes;
+    /** RA list drop_count at window start */
+    t_u16 win_drops;
+    /** consecutive windows voting for the other mode */
+    t_u8 votes;
+    /** AGGR_TUNE_MODE_LATENCY or AGGR_TUNE_MODE_BULK */
+    t_u8 mode;
+    /** A-MSDU size limit in bulk mode */
+    t_u16 amsdu_limit;
+    /** mode switches */
+    t_u16 switches;
+    /** throughput of the last window in kbps */
+    t_u32 tput_kbps;
+    /** average queue depth of the last window */
+    t_u8 last_depth;
+    /** small packet percentage of the last window */
+    t_u8 last_small_pct;
+} aggr_tune_t;
+#endif
+
 /** RA list table */
 typedef struct _raListTbl raListTbl;
 
@@ -742,6 +804,14 @@ struct _raListTbl
 #ifdef CONFIG_WMM
     /** drop packet count  */
     t_u16 drop_count;
+    /** time in msec at which the RA list was last paused */
+    t_u32 pause_start;
+    /** accumulated time in msec spent paused */
+    t_u32 pause_time;
+    /** packets queued while paused */
+    t_u32 held_count;
+    /** TX aggregation tuner state */
+    aggr_tune_t aggr_tune;
 #endif
 };
 
@@ -756,6 +826,8 @@ typedef struct _tidTbl
 
 /** Highest priority setting for a packet (uses voice AC) */
 #define WMM_HIGHEST_PRIORITY 7
+/** Max driver queue delay in ms that fits TxPD pkt_delay_2ms */
+#define WMM_DRV_DELAY_MAX 510
 /** Highest priority TID  */
 #define HIGH_PRIO_TID 7
 /** Lowest priority TID  */
@@ -787,6 +859,8 @@ typedef struct _wmm_desc
     t_u8 queue_priority[MAX_AC_QUEUES];
     /** User priority packet transmission control */
     t_u32 user_pri_pkt_tx_ctrl[WMM_HIGHEST_PRIORITY + 1]; /* UP: 0 to 7 */
+    /** User priority host queue expiry in ms, 0 for no expiry */
+    t_u16 user_pri_pkt_expiry[WMM_HIGHEST_PRIORITY + 1]; /* UP: 0 to 7 */
 
     /** Number of transmit packets queued */
     mlan_scalar tx_pkts_queued;
@@ -932,6 +1006,23 @@ typedef struct _wlan_802_11d_domain_reg
     IEEEtypes_SubbandSet_t sub_band[MRVDRV_MAX_SUBBAND_802_11D];
 } wlan_802_11d_domain_reg_t;
 
+/** 11D state remembered across associations to avoid redundant work */
+typedef struct _wlan_11d_cache
+{
+    /** Last country IE parsed */
+    IEEEtypes_CountryInfoFullSet_t country_ie;
+    /** Band country_ie was parsed for */
+    t_u16 country_band;
+    /** Result of parsing country_ie */
+    parsed_region_chan_11d_t parsed_country;
+    /** MTRUE if country_ie and parsed_country are valid */
+    t_bool country_valid;
+    /** Domain info last downloaded to FW */
+    wlan_802_11d_domain_reg_t domain_sent;
+    /** MTRUE if domain_sent reflects the FW state */
+    t_bool domain_valid;
+} wlan_11d_cache_t;
+
 /** Data for state machine */
 typedef struct _wlan_802_11d_state
 {
@@ -1014,19 +1105,126 @@ typedef struct
 #ifdef CONFIG_WMM
 typedef struct
 {
+    /** free buffers in internal RAM */
     mlan_list_head free_list;
     int free_cnt;
+    /** most internal buffers in use at once */
+    int peak_cnt;
+    /** free buffers in the external overflow region */
+    mlan_list_head ext_free_list;
+    int ext_free_cnt;
+    /** buffers carved from the external region */
+    int ext_total;
+    /** most external buffers in use at once */
+    int ext_peak_cnt;
+    /** external overflow region */
+    t_u8 *ext_start;
+    t_u8 *ext_end;
+    /** packets queued in an external buffer */
+    t_u32 ext_queued;
+    /** external buffers moved to internal RAM for transmission */
+    t_u32 promoted;
 } outbuf_pool_t;
+#endif
 
+/** Channel switch coordination state */
 typedef struct
 {
-    t_u16 tx_no_media;
-    t_u16 tx_err_mem;
-    t_u16 tx_wmm_retried_drop;
-    t_u16 tx_wmm_pause_drop;
-    t_u16 tx_wmm_pause_replaced;
-    t_u16 rx_reorder_drop;
-} wlan_pkt_stat_t;
+    /** TX scheduling held for a channel switch */
+    t_u8 active;
+    /** time in msec at which the switch started */
+    t_u32 start_ms;
+    /** frames queued during the current switch */
+    t_u16 held;
+    /** frames refused during the current switch */
+    t_u16 dropped;
+    /** completed switches */
+    t_u32 count;
+    /** switches which never got the complete event */
+    t_u32 timeouts;
+    /** channel of the last switch */
+    t_u8 last_channel;
+    /** outage of the last switch in msec */
+    t_u32 last_outage_ms;
+    /** longest outage in msec */
+    t_u32 max_outage_ms;
+    /** frames queued during the last switch */
+    t_u16 last_held;
+    /** frames refused during the last switch */
+    t_u16 last_dropped;
+} chan_switch_t;
+
+/** Off-channel (remain on channel) coordination state */
+typedef struct
+{
+    /** a remain on channel request is being served */
+    t_u8 pending;
+    /** the request may be served in slices */
+    t_u8 sliced;
+    /** radio is off the home channel and TX is held */
+    t_u8 active;
+    /** bss type the request was issued on */
+    t_u8 bss_type;
+    /** requested channel */
+    t_u8 channel;
+    /** requested band configuration */
+    t_u8 bandcfg;
+    /** requested duration in msec */
+    t_u32 duration_ms;
+    /** off-channel time not yet served in msec */
+    t_u32 remain_ms;
+    /** length of the current slice in msec */
+    t_u32 slice_ms;
+    /** time in msec at which the current slice started */
+    t_u32 slice_start_ms;
+    /** slices of the current request */
+    t_u16 slices;
+    /** off-channel time of the current request in msec */
+    t_u32 outage_ms;
+    /** longest slice of the current request in msec */
+    t_u32 max_gap_ms;
+    /** completed requests */
+    t_u32 count;
+    /** requests cancelled before their duration was served */
+    t_u32 cancelled;
+    /** slices which never got the expired event */
+    t_u32 timeouts;
+    /** requested duration of the last request in msec */
+    t_u32 last_duration_ms;
+    /** slices of the last request */
+    t_u16 last_slices;
+    /** off-channel time of the last request in msec */
+    t_u32 last_outage_ms;
+    /** longest slice of the last request in msec */
+    t_u32 last_max_gap_ms;
+    /** longest slice of all requests in msec */
+    t_u32 max_gap_ms_all;
+} roc_coord_t;
+
+#ifdef CONFIG_WPA_SUPP_AP
+/** Station setup not started */
+#define STA_SETUP_IDLE 0U
+/** Station added, waiting to be authorised */
+#define STA_SETUP_PENDING 1U
+/** Station authorised */
+#define STA_SETUP_DONE 2U
+
+/** uAP station setup statistics */
+typedef struct
+{
+    /** stations authorised */
+    t_u32 authorized;
+    /** sum of the time to authorised in msec */
+    t_u32 total_ms;
+    /** time to authorised of the last station in msec */
+    t_u32 last_ms;
+    /** longest time to authorised in msec */
+    t_u32 max_ms;
+    /** station add commands sent to firmware */
+    t_u32 cmds;
+    /** repeated station add requests not sent to firmware */
+    t_u32 skipped;
+} sta_setup_stat_t;
 #endif
 
 /** mlan_operations data structure */
@@ -1349,8 +1547,21 @@ struct _mlan_private
     t_u64 bg_scan_reqid;
     /* interface pause status */
     t_u8 tx_pause;
+    /** channel switch state */
+    chan_switch_t chan_sw;
+#ifdef CONFIG_WPA_SUPP_AP
+    /** uAP station setup statistics */
+    sta_setup_stat_t sta_setup;
+#endif
 #ifdef CONFIG_WMM
-    wlan_pkt_stat_t driver_error_cnt;
+    /** TX airtime and buffer weight relative to the other interfaces */
+    t_u8 tx_weight;
+    /** packets still allowed in the current scheduling round */
+    t_u32 tx_deficit;
+    /** packets sent by the shared TX scheduler */
+    t_u32 tx_sched_pkts;
+    /** frames refused because the buffer share was used up */
+    t_u32 tx_share_drop;
 #endif
 #ifdef CONFIG_MBO
     t_u8 enable_mbo;
@@ -1544,6 +1755,20 @@ struct _sta_node
     t_u8 wapi_key_on;
     /** tx pause status */
     t_u8 tx_pause;
+#ifdef CONFIG_WPA_SUPP_AP
+    /** station setup state */
+    t_u8 setup_state;
+    /** time in msec at which station setup started */
+    t_u32 setup_start_ms;
+    /** time to authorised in msec */
+    t_u32 setup_auth_ms;
+    /** length of the last station add request */
+    t_u32 setup_req_len;
+    /** FNV-1a hash of the last station add request */
+    t_u32 setup_req_hash;
+    /** one-at-a-time hash of the last station add request */
+    t_u32 setup_req_hash2;
+#endif
 };
 
 /** 802.11h State information kept in the 'mlan_adapter' driver structure */
@@ -1778,6 +2003,8 @@ struct _mlan_adapter
     parsed_region_chan_11d_t parsed_region_chan;
     /** 11D and Domain Regulatory Data */
     wlan_802_11d_domain_reg_t domain_reg;
+    /** Cached 11D country IE parse and last downloaded domain info */
+    wlan_11d_cache_t cache_11d;
     /** Country Code */
     t_u8 country_code[COUNTRY_CODE_LEN];
     /** FSM variable for 11h support */
@@ -1790,6 +2017,24 @@ struct _mlan_adapter
     wlan_meas_state_t state_meas;
     /** Scan table */
     BSSDescriptor_t *pscan_table;
+#ifdef CONFIG_COMPACT_SCAN_TABLE
+    /** Shared arena holding the retained IEs of the scan table entries */
+    t_u8 *pbss_ie_arena;
+    /** Bytes of the arena in use, including stale blobs */
+    t_u32 bss_ie_arena_used;
+    /** IEs of the beacon being parsed, packed into the arena on insert */
+    BSSDescriptorIEs_t *pbss_ie_stage;
+    /** IEs of the associated BSS, kept out of the arena */
+    t_u8 *pcurr_bss_ie_blob;
+    /** Optional IEs dropped because the arena was full */
+    t_u32 bss_ie_dropped;
+#endif
+    /** Beacons parsed and total parse time in microseconds */
+    t_u32 bss_parse_cnt;
+    t_u32 bss_parse_us;
+    /** Scan table entries stored and total store time in microseconds */
+    t_u32 bss_store_cnt;
+    t_u32 bss_store_us;
     /** scan age in secs */
     t_u32 age_in_secs;
     /** Active scan for hidden ssid triggered */
@@ -1918,9 +2163,13 @@ struct _mlan_adapter
     t_u16 tx_buffer_size;
 #endif
     t_u8 bgscan_reported;
+    /** remain on channel coordination state */
+    roc_coord_t roc;
 #ifdef CONFIG_WMM
     /* wmm buffer pool */
     outbuf_pool_t outbuf_pool;
+    /** TX aggregation auto tuning enabled */
+    t_u8 aggr_tune_enable;
 #endif
 };
 
@@ -2093,6 +2342,13 @@ t_s32 wlan_find_bssid_in_list(IN mlan_private *pmpriv, IN const t_u8 *bssid, IN
 /** Compare two SSIDs */
 t_s32 wlan_ssid_cmp(IN pmlan_adapter pmadapter, IN mlan_802_11_ssid *ssid1, IN mlan_802_11_ssid *ssid2);
 
+#ifdef CONFIG_COMPACT_SCAN_TABLE
+/** Forget all IE blobs, called when the scan table is cleared */
+void wlan_bss_ie_arena_reset(IN pmlan_adapter pmadapter);
+/** Move the IEs of the associated BSS copy out of the scan IE arena */
+void wlan_bss_ie_pin(IN pmlan_adapter pmadapter, IN BSSDescriptor_t *pbss_desc);
+#endif
+
 /** Associate */
 mlan_status wlan_associate(IN mlan_private *pmpriv, IN t_void *pioctl_buf, IN BSSDescriptor_t *pbss_desc);
 
@@ -265,6 +265,18 @@ Change log:
 #define READ_BASE_1_REG 0x41
 #endif
 
+/*
+ * Firmware reset register, cleared by the card once the reset is done.
+ * Define CARD_FW_RESET_REG and CARD_FW_RESET_VAL here only for cards whose
+ * register map gives them; other cards get an SDIO I/O reset through the
+ * CCCR I/O abort register instead.
+ */
+
+/** CCCR I/O abort register (function 0) */
+#define SDIO_CCCR_IO_ABORT_REG 0x06
+/** CCCR I/O abort register : reset all I/O functions */
+#define SDIO_CCCR_IO_ABORT_RES (0x1U << 3)
+
 #if defined(SD8978) || defined(SD8987) || defined(SD8997) || defined(SD9097) || defined(SD9098) || defined(IW61x)
 /** Card Control Registers : Card revision register */
 #define CARD_REVISION_REG 0xC8
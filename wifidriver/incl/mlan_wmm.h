@@ -195,8 +195,11 @@ mlan_status wlan_ret_wmm_param_config(pmlan_private pmpriv, const HostCmd_DS_COM
 #ifdef CONFIG_WMM
 /* wmm enhance buffer pool */
 #define MAX_WMM_BUF_NUM 16
-#define WMM_DATA_LEN    1580
+#define WMM_DATA_LEN    MLAN_MAX_DATA_FRAME_LEN
 #define OUTBUF_WMM_LEN  (sizeof(outbuf_t))
+/* packets a tx paused RA list may keep queued per AC, taken from free
+ * buffers only, for release when the peer resumes */
+#define WMM_PAUSED_RA_MAX_PKTS 2
 
 typedef struct
 {
@@ -204,6 +207,8 @@ typedef struct
     t_u8 intf_header[INTF_HEADER_LEN];
     TxPD tx_pd;
     t_u8 data[WMM_DATA_LEN];
+    /* os_get_timestamp() when added to the ra list */
+    t_u32 enqueue_ts;
 } outbuf_t;
 
 /* transfer destination address to receive address */
@@ -221,6 +226,20 @@ outbuf_t *wifi_wmm_buf_get(void);
 void wifi_wmm_buf_put(outbuf_t *buf);
 int wifi_wmm_buf_pool_init(uint8_t *pool);
 void wifi_wmm_buf_pool_deinit(void);
+/* add an external RAM region to the pool for deep backlog */
+int wifi_wmm_buf_pool_add_ext(uint8_t *region, uint32_t len);
+/* move a buffer to internal RAM before it is handed to SDIO */
+outbuf_t *wifi_wmm_buf_promote(outbuf_t *buf, t_u8 copied);
+
+/*
+ * With multi port aggregation every frame is copied into the SDIO
+ * aggregation buffer, which already moves it out of external RAM.
+ */
+#ifdef CONFIG_SDIO_MULTI_PORT_TX_AGGR
+#define WMM_BUF_SDIO_COPIED MTRUE
+#else
+#define WMM_BUF_SDIO_COPIED MFALSE
+#endif
 
 /* wmm enhance ralist operation */
 void wlan_ralist_add_enh(mlan_private *priv, t_u8 *ra);
@@ -229,6 +248,7 @@ void wlan_ralist_pkts_free_enh(mlan_private *priv, raListTbl *ra_list, t_u8 ac);
 void wlan_ralist_del_enh(mlan_private *priv, t_u8 *ra);
 void wlan_ralist_del_all_enh(mlan_private *priv);
 void wlan_ralist_deinit_enh(mlan_private *priv);
+void wlan_ralist_set_tx_pause(raListTbl *ra_list, t_u8 tx_pause);
 
 /* debug statistics */
 void wifi_wmm_drop_err_mem(const uint8_t interface);
@@ -236,6 +256,59 @@ void wifi_wmm_drop_no_media(const uint8_t interface);
 void wifi_wmm_drop_retried_drop(const uint8_t interface);
 void wifi_wmm_drop_pause_drop(const uint8_t interface);
 void wifi_wmm_drop_pause_replaced(const uint8_t interface);
+void wifi_wmm_drop_expired(const uint8_t interface);
+
+/* host queue delay of a buffer in TxPD pkt_delay_2ms units */
+t_u8 wlan_wmm_compute_driver_packet_delay(pmlan_private priv, const outbuf_t *buf);
+/* check if a buffer outlived the expiry of its user priority */
+t_u8 wlan_wmm_is_pkt_expired(pmlan_private priv, const outbuf_t *buf);
+
+/** Max frames accepted per interface while a channel switch holds TX */
+#define WMM_CHAN_SWITCH_MAX_PKTS (MAX_WMM_BUF_NUM / 2)
+
+/** Default TX weight of an interface */
+#define WMM_BSS_DEF_WEIGHT 1U
+/** Packets per scheduling round for each unit of weight */
+#define WMM_BSS_QUANTUM_PKTS 4U
+/** Below 1/n of the buffers free each interface is held to its weighted share */
+#define WMM_BSS_SHARE_FREE_LOW_DIV 4U
+
+/* packets queued on all ACs of an interface */
+t_u32 wifi_wmm_bss_queued(pmlan_private priv);
+
+/** TX aggregation tuner observation window in msec */
+#define AGGR_TUNE_WIN_MS 100U
+/** Packets up to this length count as small */
+#define AGGR_TUNE_SMALL_PKT_LEN 256U
+/** Consecutive windows voting for the other mode before switching */
+#define AGGR_TUNE_HYSTERESIS 3U
+/** Minimum packets in a window to vote for bulk mode */
+#define AGGR_TUNE_BULK_MIN_PKTS 16U
+/** Average queue depth at or above which a window votes for bulk mode */
+#define AGGR_TUNE_BULK_DEPTH 4U
+/** Small packet percentage at or below which a window votes for bulk mode */
+#define AGGR_TUNE_BULK_SMALL_PCT 25U
+/** Average queue depth below which a window votes for latency mode */
+#define AGGR_TUNE_LATENCY_DEPTH 2U
+/** Small packet percentage at or above which a window votes for latency mode */
+#define AGGR_TUNE_LATENCY_SMALL_PCT 60U
+/** Packets in the window before BA setup is requested in latency mode */
+#define AGGR_TUNE_BA_MIN_PKTS 8U
+/** Smallest A-MSDU size limit, keeps room for one full sized frame */
+#if (MLAN_MAX_DATA_FRAME_LEN > 2048U)
+#define AGGR_TUNE_AMSDU_MIN MLAN_TX_DATA_BUF_SIZE_4K
+#else
+#define AGGR_TUNE_AMSDU_MIN MLAN_TX_DATA_BUF_SIZE_2K
+#endif
+/** Largest A-MSDU size limit */
+#define AGGR_TUNE_AMSDU_MAX MLAN_TX_DATA_BUF_SIZE_12K
+
+/* TX aggregation auto tuning */
+void wlan_aggr_tune_reset(raListTbl *ra_list);
+void wlan_aggr_tune_sample(raListTbl *ra_list, t_u16 pkt_len);
+t_u8 wlan_aggr_tune_amsdu_allowed(const raListTbl *ra_list);
+t_u32 wlan_aggr_tune_amsdu_limit(const raListTbl *ra_list, t_u32 max_size);
+t_u8 wlan_aggr_tune_ba_allowed(const uint8_t interface, const uint8_t *buffer, uint8_t pkt_prio);
 #endif
 
 #endif /* !_MLAN_WMM_H_ */
@@ -58,4 +58,21 @@ typedef t_s32 t_sval;
 /** MLAN FALSE */
 #define MFALSE (0)
 
+/** Largest IP MTU the data path buffers are sized for */
+#ifdef CONFIG_WIFI_MAX_MTU
+#define MLAN_MAX_MTU (CONFIG_WIFI_MAX_MTU)
+#else
+#define MLAN_MAX_MTU (1500U)
+#endif
+
+/* 802.11 MSDU limit of 2304 bytes less the 8 byte LLC/SNAP header */
+#if (MLAN_MAX_MTU < 1500U) || (MLAN_MAX_MTU > 2296U)
+#error "CONFIG_WIFI_MAX_MTU must be within 1500 and 2296"
+#endif
+
+/** Interface header, TxPD/RxPD and 802.3 header room on top of the MTU */
+#define MLAN_DATA_FRAME_OVERHEAD (80U)
+/** Largest data frame exchanged with the card */
+#define MLAN_MAX_DATA_FRAME_LEN (MLAN_MAX_MTU + MLAN_DATA_FRAME_OVERHEAD)
+
 #endif /* !_TYPE_DECL_H_ */
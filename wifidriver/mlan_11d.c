@@ -467,6 +467,59 @@ static t_u8 wlan_11d_get_chan(pmlan_adapter pmadapter, t_u16 band, t_u8 first_ch
     return MFALSE;
 }
 
+/**
+ *  @brief This function parses the country IE of a BSS, reusing the result
+ *         of the previous parse when the IE and band are unchanged.
+ *
+ *  @param pmadapter            Pointer to mlan_adapter structure
+ *  @param pbss_desc            A pointer to BSSDescriptor_t
+ *  @param parsed_region_chan   Pointer to parsed_region_chan_11d_t
+ *
+ *  @return                     MLAN_STATUS_SUCCESS or MLAN_STATUS_FAILURE
+ */
+static mlan_status wlan_11d_parse_country_ie(pmlan_adapter pmadapter,
+                                             BSSDescriptor_t *pbss_desc,
+                                             parsed_region_chan_11d_t *parsed_region_chan)
+{
+    wlan_11d_cache_t *pcache                     = &pmadapter->cache_11d;
+    IEEEtypes_CountryInfoFullSet_t *country_info = pbss_desc->pcountry_info;
+    t_u32 ie_len;
+    mlan_status ret;
+
+    ENTER();
+
+    if (country_info == MNULL)
+    {
+        /* No country IE retained for this BSS: treat as no 11D info */
+        LEAVE();
+        return MLAN_STATUS_FAILURE;
+    }
+    ie_len = MIN((t_u32)country_info->len, (t_u32)COUNTRY_CODE_LEN + sizeof(country_info->sub_band));
+
+    if (pcache->country_valid == MTRUE && pcache->country_band == pbss_desc->bss_band &&
+        pcache->country_ie.len == country_info->len &&
+        __memcmp(pmadapter, pcache->country_ie.country_code, country_info->country_code, ie_len) == 0)
+    {
+        (void)__memcpy(pmadapter, parsed_region_chan, &pcache->parsed_country, sizeof(parsed_region_chan_11d_t));
+        LEAVE();
+        return MLAN_STATUS_SUCCESS;
+    }
+
+    ret = wlan_11d_parse_domain_info(pmadapter, country_info, pbss_desc->bss_band, parsed_region_chan);
+    if (ret == MLAN_STATUS_SUCCESS)
+    {
+        /* Only len + 2 bytes of the IE are retained in the scan table */
+        (void)__memset(pmadapter, &pcache->country_ie, 0x00, sizeof(IEEEtypes_CountryInfoFullSet_t));
+        (void)__memcpy(pmadapter, &pcache->country_ie, country_info, (t_u32)country_info->len + 2U);
+        (void)__memcpy(pmadapter, &pcache->parsed_country, parsed_region_chan, sizeof(parsed_region_chan_11d_t));
+        pcache->country_band  = pbss_desc->bss_band;
+        pcache->country_valid = MTRUE;
+    }
+
+    LEAVE();
+    return ret;
+}
+
 /**
  *  @brief This function processes the country info present in BSSDescriptor.
  *
@@ -487,8 +540,7 @@ static mlan_status wlan_11d_process_country_info(mlan_private *pmpriv, BSSDescri
     (void)__memset(pmadapter, &region_chan, 0, sizeof(parsed_region_chan_11d_t));
 
     /* Parse 11D country info */
-    if (wlan_11d_parse_domain_info(pmadapter, &pbss_desc->country_info, pbss_desc->bss_band, &region_chan) !=
-        MLAN_STATUS_SUCCESS)
+    if (wlan_11d_parse_country_ie(pmadapter, pbss_desc, &region_chan) != MLAN_STATUS_SUCCESS)
     {
         LEAVE();
         return MLAN_STATUS_FAILURE;
@@ -610,16 +662,35 @@ static t_void wlan_11d_sort_parsed_region_chan(parsed_region_chan_11d_t *parsed_
  */
 static mlan_status wlan_11d_send_domain_info(mlan_private *pmpriv, t_void *pioctl_buf)
 {
-    mlan_status ret = MLAN_STATUS_SUCCESS;
+    mlan_status ret          = MLAN_STATUS_SUCCESS;
+    mlan_adapter *pmadapter  = pmpriv->adapter;
+    wlan_11d_cache_t *pcache = &pmadapter->cache_11d;
 
     ENTER();
 
+    /* Internally generated domain info identical to what FW already has
+       (e.g. on a roam between APs of the same country) is not resent.
+       Explicit user requests always go out. */
+    if (pioctl_buf == MNULL && pcache->domain_valid == MTRUE &&
+        __memcmp(pmadapter, &pcache->domain_sent, &pmadapter->domain_reg, sizeof(wlan_802_11d_domain_reg_t)) == 0)
+    {
+        PRINTM(MINFO, "11D: Domain info unchanged, skip download\n");
+        LEAVE();
+        return ret;
+    }
+
     /* Send cmd to FW to set domain info */
     ret =
         wlan_prepare_cmd(pmpriv, HostCmd_CMD_802_11D_DOMAIN_INFO, HostCmd_ACT_GEN_SET, 0, (t_void *)pioctl_buf, MNULL);
     if (ret != MLAN_STATUS_SUCCESS)
     {
         PRINTM(MERROR, "11D: Failed to download domain Info\n");
+        pcache->domain_valid = MFALSE;
+    }
+    else
+    {
+        (void)__memcpy(pmadapter, &pcache->domain_sent, &pmadapter->domain_reg, sizeof(wlan_802_11d_domain_reg_t));
+        pcache->domain_valid = MTRUE;
     }
 
     LEAVE();
@@ -802,6 +873,7 @@ t_void wlan_11d_init(mlan_adapter *pmadapter)
     (void)__memset(pmadapter, &(pmadapter->parsed_region_chan), 0, sizeof(parsed_region_chan_11d_t));
     (void)__memset(pmadapter, &(pmadapter->universal_channel), 0, sizeof(region_chan_t));
     (void)__memset(pmadapter, &(pmadapter->domain_reg), 0, sizeof(wlan_802_11d_domain_reg_t));
+    (void)__memset(pmadapter, &(pmadapter->cache_11d), 0, sizeof(wlan_11d_cache_t));
 
     LEAVE();
     return;
@@ -840,6 +912,10 @@ mlan_status wlan_cmd_802_11d_domain_info(mlan_private *pmpriv, HostCmd_DS_COMMAN
         return MLAN_STATUS_SUCCESS;
     }
 
+    /* Every download, STA or uAP, replaces the domain the cache records.
+       wlan_11d_send_domain_info() marks it valid again after its own. */
+    pmadapter->cache_11d.domain_valid = MFALSE;
+
     /* Set domain info fields */
     domain->header.type = wlan_cpu_to_le16(TLV_TYPE_DOMAIN);
     (void)__memcpy(pmadapter, domain->country_code, pmadapter->domain_reg.country_code, sizeof(domain->country_code));
@@ -1142,7 +1218,11 @@ mlan_status wlan_11d_clear_parsedtable(mlan_private *pmpriv)
 
 /**
  *  @brief This function generates 11D info from user specified regioncode
- *         and download to FW
+ *
+ *  The domain info is not downloaded here: on association this is always
+ *  followed by wlan_11d_parse_dnld_countryinfo(), which regenerates and
+ *  downloads the effective table, so sending this intermediate one would
+ *  only cost a redundant command per (re)association.
  *
  *  @param pmpriv       A pointer to mlan_private structure
  *  @param band         Band to create
@@ -1245,13 +1325,6 @@ mlan_status wlan_11d_create_dnld_countryinfo(mlan_private *pmpriv, t_u16 band)
 
         /* Generate domain info from parsed region channel info */
         (void)wlan_11d_generate_domain_info(pmadapter, &parsed_region_chan);
-
-        /* Set domain info */
-        ret = wlan_11d_send_domain_info(pmpriv, MNULL);
-        if (ret != MLAN_STATUS_SUCCESS)
-        {
-            PRINTM(MERROR, "11D: Error sending domain info to FW\n");
-        }
     }
 
     LEAVE();
@@ -1288,8 +1361,7 @@ mlan_status wlan_11d_parse_dnld_countryinfo(mlan_private *pmpriv, BSSDescriptor_
         if (pbss_desc != MNULL)
         {
             /* Parse domain info if available */
-            ret = wlan_11d_parse_domain_info(pmadapter, &pbss_desc->country_info, pbss_desc->bss_band,
-                                             &bssdesc_region_chan);
+            ret = wlan_11d_parse_country_ie(pmadapter, pbss_desc, &bssdesc_region_chan);
 
             if (ret == MLAN_STATUS_SUCCESS)
             {
@@ -1352,11 +1424,12 @@ mlan_status wlan_11d_prepare_dnld_domain_info_cmd(mlan_private *pmpriv)
     {
         for (idx = 0; idx < pmadapter->num_in_scan_table; idx++)
         {
-            pcountry_full = &pmadapter->pscan_table[idx].country_info;
+            pcountry_full = pmadapter->pscan_table[idx].pcountry_info;
 
             ret = wlan_11d_update_chan_pwr_table(pmpriv, &pmadapter->pscan_table[idx]);
 
-            if (*(pcountry_full->country_code) != 0U && (pcountry_full->len > COUNTRY_CODE_LEN))
+            if ((pcountry_full != MNULL) && *(pcountry_full->country_code) != 0U &&
+                (pcountry_full->len > COUNTRY_CODE_LEN))
             {
                 /* Country info found in the BSS Descriptor */
                 ret = wlan_11d_process_country_info(pmpriv, &pmadapter->pscan_table[idx]);
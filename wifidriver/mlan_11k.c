@@ -529,7 +529,7 @@ void wlan_add_rm_beacon_report(wlan_rrm_beacon_report_data *rep_data,
                 goto part_subelem;
             }
 
-            (void)memcpy(pos, bss_entry->rsn_ie_buff, bss_entry->rsn_ie_buff_len);
+            (void)memcpy(pos, bss_entry->prsn_ie, bss_entry->rsn_ie_buff_len);
             pos += bss_entry->rsn_ie_buff_len;
         }
     }
@@ -542,9 +542,9 @@ void wlan_add_rm_beacon_report(wlan_rrm_beacon_report_data *rep_data,
             goto part_subelem;
         }
 
-        if (bss_entry->mob_domain_exist)
+        if ((bss_entry->mob_domain_exist) && (bss_entry->pmd_ie != MNULL))
         {
-            (void)memcpy((void *)pos, (const void *)bss_entry->md_ie_buff, sizeof(IEEEtypes_MobilityDomain_t));
+            (void)memcpy((void *)pos, (const void *)bss_entry->pmd_ie, sizeof(IEEEtypes_MobilityDomain_t));
             pos += sizeof(IEEEtypes_MobilityDomain_t);
         }
     }
@@ -552,15 +552,15 @@ void wlan_add_rm_beacon_report(wlan_rrm_beacon_report_data *rep_data,
     if (rep_data->report_detail == WLAN_RRM_REPORTING_DETAIL_ALL_FIELDS_AND_ELEMENTS ||
         wlan_rrm_bit_field_is_set(rep_data->bits_field, (t_u8)RRM_ENABLED_CAP))
     {
-        if (pos + sizeof(bss_entry->rm_cap_saved) - *buf_pos > remained_len)
+        if (pos + sizeof(IEEEtypes_RrmElement_t) - *buf_pos > remained_len)
         {
             goto part_subelem;
         }
 
-        if (bss_entry->rm_cap_exist)
+        if ((bss_entry->rm_cap_exist) && (bss_entry->prm_cap != MNULL))
         {
-            (void)memcpy((void *)pos, (const void *)&bss_entry->rm_cap_saved, sizeof(bss_entry->rm_cap_saved));
-            pos += sizeof(bss_entry->rm_cap_saved);
+            (void)memcpy((void *)pos, (const void *)bss_entry->prm_cap, sizeof(IEEEtypes_RrmElement_t));
+            pos += sizeof(IEEEtypes_RrmElement_t);
         }
     }
     /* Vendor Specific tag */
@@ -575,7 +575,7 @@ void wlan_add_rm_beacon_report(wlan_rrm_beacon_report_data *rep_data,
                 goto part_subelem;
             }
 
-            (void)memcpy(pos, bss_entry->wpa_ie_buff, bss_entry->wpa_ie_buff_len);
+            (void)memcpy(pos, bss_entry->pwpa_ie, bss_entry->wpa_ie_buff_len);
             pos += bss_entry->wpa_ie_buff_len;
         }
         /* wmm */
@@ -597,7 +597,7 @@ void wlan_add_rm_beacon_report(wlan_rrm_beacon_report_data *rep_data,
                 goto part_subelem;
             }
 
-            (void)memcpy(pos, bss_entry->vendor_ie_buff, bss_entry->vendor_ie_len);
+            (void)memcpy(pos, bss_entry->pvendor_ie, bss_entry->vendor_ie_len);
             pos += bss_entry->vendor_ie_len;
         }
     }
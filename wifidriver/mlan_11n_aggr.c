@@ -180,11 +180,7 @@ int wlan_11n_form_amsdu_pkt(t_u8 *amsdu_buf, t_u8 *data, int pkt_len, int *pad)
     amsdu_buf_offset += sizeof(t_u16);
     memcpy(amsdu_buf + amsdu_buf_offset, &snap, LLC_SNAP_LEN);
     amsdu_buf_offset += LLC_SNAP_LEN;
-#ifdef CONFIG_IMU_GDMA
-    HAL_ImuGdmaCopyData(amsdu_buf + amsdu_buf_offset, data + dt_offset, pkt_len - dt_offset);
-#else
-    memcpy(amsdu_buf + amsdu_buf_offset, data + dt_offset, pkt_len - dt_offset);
-#endif
+    wifi_dp_copy(amsdu_buf + amsdu_buf_offset, data + dt_offset, pkt_len - dt_offset);
     *pad = (((pkt_len + LLC_SNAP_LEN) & 3)) ? (4 - (((pkt_len + LLC_SNAP_LEN)) & 3)) : 0;
     if (*pad)
         memset(amsdu_buf + pkt_len + LLC_SNAP_LEN, 0, *pad);
@@ -1151,6 +1151,45 @@ void wlan_11n_cleanup_reorder_tbl(mlan_private *priv)
     LEAVE();
 }
 
+/**
+ *  @brief This function hands up all packets pending in the reorder
+ *         tables in sequence order, without waiting for the holes to be
+ *         filled or for the reorder timer
+ *
+ *  @param priv    	A pointer to mlan_private
+ *
+ *  @return 	   	N/A
+ */
+void wlan_11n_flush_rxreorder_tbl(mlan_private *priv)
+{
+    RxReorderTbl *rx_reor_tbl_ptr;
+    t_s16 startWin;
+
+    ENTER();
+    rx_reor_tbl_ptr = (RxReorderTbl *)(void *)util_peek_list(priv->adapter->pmoal_handle, &priv->rx_reorder_tbl_ptr,
+                                                             priv->adapter->callbacks.moal_spin_lock,
+                                                             priv->adapter->callbacks.moal_spin_unlock);
+    if (rx_reor_tbl_ptr == MNULL)
+    {
+        LEAVE();
+        return;
+    }
+
+    while (rx_reor_tbl_ptr != (RxReorderTbl *)(void *)&priv->rx_reorder_tbl_ptr)
+    {
+        startWin = wlan_11n_find_last_seqnum(rx_reor_tbl_ptr);
+        if (startWin >= 0)
+        {
+            (void)wlan_11n_dispatch_pkt_until_start_win(
+                priv, rx_reor_tbl_ptr, ((rx_reor_tbl_ptr->start_win + (t_u16)startWin + 1U) & (MAX_TID_VALUE - 1)));
+        }
+        rx_reor_tbl_ptr = rx_reor_tbl_ptr->pnext;
+    }
+
+    LEAVE();
+    return;
+}
+
 /**
  *  @brief This function cleans up reorder tbl for specific station
  *
@@ -178,9 +178,10 @@ int wifi_mem_access(uint16_t action, uint32_t addr, uint32_t *value)
 }
 
 
-int wifi_get_tsf(uint32_t *tsf_high, uint32_t *tsf_low)
+static int wifi_get_tsf_timed(wifi_tsf_sample_t *sample)
 {
-    t_u64 tsf = 0x00;
+    sample->tsf   = 0;
+    sample->rx_us = 0;
 
     (void)wifi_get_command_lock();
     HostCmd_DS_COMMAND *cmd = wifi_get_command_buffer();
@@ -197,14 +198,30 @@ int wifi_get_tsf(uint32_t *tsf_high, uint32_t *tsf_low)
         return -WM_FAIL;
     }
 
-    (void)wifi_wait_for_cmdresp(&tsf);
-
-    *tsf_high = tsf >> 32;
-    *tsf_low  = (t_u32)tsf;
+    sample->tx_us = os_get_timestamp();
+    (void)wifi_wait_for_cmdresp(sample);
 
     return wm_wifi.cmd_resp_status;
 }
 
+int wifi_get_tsf(uint32_t *tsf_high, uint32_t *tsf_low)
+{
+    wifi_tsf_sample_t sample;
+    int ret = wifi_get_tsf_timed(&sample);
+
+    *tsf_high = sample.tsf >> 32;
+    *tsf_low  = (t_u32)sample.tsf;
+
+    return ret;
+}
+
+#ifdef CONFIG_WIFI_CLOCKSYNC
+int wifi_get_tsf_sample(wifi_tsf_sample_t *sample)
+{
+    return wifi_get_tsf_timed(sample);
+}
+#endif /* CONFIG_WIFI_CLOCKSYNC */
+
 
 int wifi_send_rssi_info_cmd(wifi_rssi_info_t *rssi_info)
 {
@@ -3784,6 +3801,9 @@ int wifi_get_bgscan_results(mlan_private *pmpriv)
 
     memset(pmadapter->pscan_table, 0x00, sizeof(BSSDescriptor_t) * MRVDRV_MAX_BSSID_LIST);
     pmadapter->num_in_scan_table = 0;
+#ifdef CONFIG_COMPACT_SCAN_TABLE
+    wlan_bss_ie_arena_reset(pmadapter);
+#endif
     ret                          = wifi_request_bgscan_query(pmpriv);
     pmadapter->bgscan_reported   = MFALSE;
     LEAVE();
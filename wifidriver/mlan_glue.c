@@ -145,7 +145,7 @@ void wrapper_deliver_amsdu_subframe(pmlan_buffer amsdu_pmbuf, t_u8 *data, t_u16
 {
     RxPD *prx_pd = (RxPD *)(void *)amsdu_pmbuf->pbuf;
     w_pkt_d("[amsdu] [push]: BSS Type: %d L: %d", prx_pd->bss_type, pkt_len);
-    wm_wifi.amsdu_data_intput_callback(prx_pd->bss_type, data, pkt_len);
+    wm_wifi.amsdu_data_intput_callback(prx_pd->bss_type, data, pkt_len, prx_pd->priority);
 }
 
 static mlan_status wrapper_moal_recv_packet(IN t_void *pmoal_handle, IN pmlan_buffer pmbuf)
@@ -1447,6 +1447,23 @@ int wifi_get_txratecfg(wifi_ds_rate *ds_rate, mlan_bss_type bss_type)
     return ret;
 }
 
+int wifi_set_tx_ctrl_policy(mlan_bss_type bss_type, t_u8 user_prio, t_u32 tx_control, t_u16 expiry_ms)
+{
+    mlan_private *pmpriv;
+
+    if ((bss_type != MLAN_BSS_TYPE_STA && bss_type != MLAN_BSS_TYPE_UAP) || user_prio > WMM_HIGHEST_PRIORITY)
+    {
+        return -WM_E_INVAL;
+    }
+
+    pmpriv = (mlan_private *)mlan_adap->priv[bss_type];
+
+    pmpriv->wmm.user_pri_pkt_tx_ctrl[user_prio] = tx_control;
+    pmpriv->wmm.user_pri_pkt_expiry[user_prio]  = expiry_ms;
+
+    return WM_SUCCESS;
+}
+
 bool wrapper_wlan_11d_support_is_enabled(void)
 {
     mlan_private *pmpriv = (mlan_private *)mlan_adap->priv[0];
@@ -1514,7 +1531,7 @@ int wrapper_wifi_assoc(
         priv->sec_info.wpa2_enabled = true;
         if (d->rsn_ie_buff_len <= sizeof(priv->wpa_ie))
         {
-            (void)memcpy((void *)priv->wpa_ie, (const void *)d->rsn_ie_buff, d->rsn_ie_buff_len);
+            (void)memcpy((void *)priv->wpa_ie, (const void *)d->prsn_ie, d->rsn_ie_buff_len);
             priv->wpa_ie_len = (t_u8)d->rsn_ie_buff_len;
         }
         else
@@ -1530,7 +1547,7 @@ int wrapper_wifi_assoc(
         priv->sec_info.wpa_enabled = true;
         if (d->wpa_ie_buff_len <= sizeof(priv->wpa_ie))
         {
-            (void)memcpy((void *)priv->wpa_ie, (const void *)d->wpa_ie_buff, d->wpa_ie_buff_len);
+            (void)memcpy((void *)priv->wpa_ie, (const void *)d->pwpa_ie, d->wpa_ie_buff_len);
             priv->wpa_ie_len = (t_u8)d->wpa_ie_buff_len;
         }
         else
@@ -1558,7 +1575,7 @@ int wrapper_wifi_assoc(
         priv->sec_info.wpa2_enabled = true;
         if (d->rsn_ie_buff_len <= sizeof(priv->wpa_ie))
         {
-            (void)memcpy((void *)priv->wpa_ie, (const void *)d->rsn_ie_buff, d->rsn_ie_buff_len);
+            (void)memcpy((void *)priv->wpa_ie, (const void *)d->prsn_ie, d->rsn_ie_buff_len);
             priv->wpa_ie_len = (t_u8)d->rsn_ie_buff_len;
         }
         else
@@ -1570,9 +1587,9 @@ int wrapper_wifi_assoc(
         if ((!is_ft) && (wlan_security == WLAN_SECURITY_WPA2 || wlan_security == WLAN_SECURITY_WPA3_SAE ||
                          wlan_security == WLAN_SECURITY_WPA2_WPA3_SAE_MIXED))
         {
-            if (d->md_ie_buff_len <= sizeof(priv->md_ie))
+            if ((d->pmd_ie != MNULL) && (d->md_ie_buff_len <= sizeof(priv->md_ie)))
             {
-                (void)memcpy((void *)priv->md_ie, (const void *)d->md_ie_buff, (size_t)d->md_ie_buff_len);
+                (void)memcpy((void *)priv->md_ie, (const void *)d->pmd_ie, (size_t)d->md_ie_buff_len);
                 priv->md_ie_len = d->md_ie_buff_len;
             }
         }
@@ -3220,9 +3237,10 @@ int wifi_process_cmd_response(HostCmd_DS_COMMAND *resp)
                 {
                     if (wm_wifi.cmd_resp_priv != NULL)
                     {
-                        t_u64 *tsf = (t_u64 *)(wm_wifi.cmd_resp_priv);
+                        wifi_tsf_sample_t *sample = (wifi_tsf_sample_t *)(wm_wifi.cmd_resp_priv);
 
-                        *tsf = tsf_pointer->tsf;
+                        sample->rx_us = os_get_timestamp();
+                        sample->tsf   = tsf_pointer->tsf;
 
                         wm_wifi.cmd_resp_status = WM_SUCCESS;
                     }
@@ -3737,7 +3755,7 @@ static void wifi_sta_handle_event_data_pause(mlan_private *priv, MrvlIEtypes_tx_
                 continue;
             }
 
-            ra_list->tx_pause = priv->tx_pause;
+            wlan_ralist_set_tx_pause(ra_list, priv->tx_pause);
 
             wifi_wmm_queue_unlock(priv, i);
         }
@@ -3774,7 +3792,7 @@ static void wifi_uap_handle_event_data_pause(mlan_private *priv_uap, MrvlIEtypes
                 continue;
             }
 
-            ra_list->tx_pause = (tx_pause_tlv->tx_pause) ? MTRUE : MFALSE;
+            wlan_ralist_set_tx_pause(ra_list, (tx_pause_tlv->tx_pause) ? MTRUE : MFALSE);
 
             wifi_wmm_queue_unlock(priv_uap, i);
         }
@@ -3828,6 +3846,510 @@ void wifi_handle_event_data_pause(void *data)
 }
 #endif
 
+/*
+ *  Channel switch coordination.
+ *
+ *  From the channel switch announcement (or a planned switch) until the
+ *  switch complete event, the TX scheduler leaves the interface alone so
+ *  that queued frames stay in the ralists instead of failing on the old
+ *  channel, and new frames are queued up to WMM_CHAN_SWITCH_MAX_PKTS.
+ *  Pending RX reorder windows are handed up at both ends so that nothing
+ *  waits for the reorder timer across the outage.
+ *
+ *  The state is changed from the event thread, the TX thread and the
+ *  expiry timer, so it is only touched inside a critical section.
+ */
+static os_timer_t chan_sw_timer[MLAN_MAX_BSS_NUM];
+
+static void wifi_chan_switch_end(mlan_private *priv, t_u8 channel, t_u8 timed_out)
+{
+    chan_switch_t *chan_sw = &priv->chan_sw;
+    t_u32 now_ms           = os_ticks_to_msec(os_ticks_get());
+    t_u32 outage_ms        = 0;
+    unsigned long sta;
+
+    sta = os_enter_critical_section();
+    /* the complete event and the timer may race, only one ends the hold */
+    if (timed_out == MTRUE && chan_sw->active == MFALSE)
+    {
+        os_exit_critical_section(sta);
+        return;
+    }
+
+    /* a switch nobody announced had no TX hold */
+    if (chan_sw->active == MFALSE)
+    {
+        chan_sw->start_ms = now_ms;
+        chan_sw->held     = 0;
+        chan_sw->dropped  = 0;
+    }
+
+    outage_ms = now_ms - chan_sw->start_ms;
+
+    chan_sw->active         = MFALSE;
+    chan_sw->last_channel   = channel;
+    chan_sw->last_outage_ms = outage_ms;
+    chan_sw->max_outage_ms  = MAX(chan_sw->max_outage_ms, outage_ms);
+    chan_sw->last_held      = chan_sw->held;
+    chan_sw->last_dropped   = chan_sw->dropped;
+    if (timed_out == MTRUE)
+        chan_sw->timeouts++;
+    else
+        chan_sw->count++;
+    os_exit_critical_section(sta);
+
+    if (chan_sw_timer[priv->bss_index] != MNULL)
+        (void)os_timer_deactivate(&chan_sw_timer[priv->bss_index]);
+
+    wlan_11n_flush_rxreorder_tbl(priv);
+
+#ifdef CONFIG_WMM
+    /* release the frames held across the switch */
+    (void)send_wifi_driver_tx_data_event(priv->bss_type);
+#endif
+}
+
+static void wifi_chan_switch_timer_cb(os_timer_arg_t arg)
+{
+    mlan_private *priv = (mlan_private *)os_timer_get_context(&arg);
+
+    if (priv->chan_sw.active == MFALSE)
+        return;
+
+    wifi_w("channel switch on bss_type %d did not complete, resuming tx", priv->bss_type);
+    wifi_chan_switch_end(priv, priv->chan_sw.last_channel, MTRUE);
+}
+
+static void wifi_chan_switch_begin(mlan_private *priv)
+{
+    chan_switch_t *chan_sw = &priv->chan_sw;
+    os_timer_t *timer      = &chan_sw_timer[priv->bss_index];
+    unsigned long sta;
+
+    sta = os_enter_critical_section();
+    if (chan_sw->active == MTRUE)
+    {
+        os_exit_critical_section(sta);
+        return;
+    }
+
+    chan_sw->start_ms = os_ticks_to_msec(os_ticks_get());
+    chan_sw->held     = 0;
+    chan_sw->dropped  = 0;
+    chan_sw->active   = MTRUE;
+    os_exit_critical_section(sta);
+
+    wlan_11n_flush_rxreorder_tbl(priv);
+
+    /* resume even if the link stays idle and nothing runs the scheduler */
+    if (*timer == MNULL && os_timer_create(timer, "chan-sw-timer", os_msec_to_ticks(WIFI_CHAN_SWITCH_TIMEOUT_MS),
+                                           wifi_chan_switch_timer_cb, priv, OS_TIMER_ONE_SHOT,
+                                           OS_TIMER_NO_ACTIVATE) != WM_SUCCESS)
+    {
+        wifi_w("Unable to create channel switch timer");
+        return;
+    }
+
+    (void)os_timer_change(timer, os_msec_to_ticks(WIFI_CHAN_SWITCH_TIMEOUT_MS), 0);
+    (void)os_timer_activate(timer);
+}
+
+void wifi_chan_switch_check_timeout(mlan_private *priv)
+{
+    if (priv->chan_sw.active == MFALSE)
+        return;
+
+    if (priv->media_connected == MFALSE ||
+        (os_ticks_to_msec(os_ticks_get()) - priv->chan_sw.start_ms) >= WIFI_CHAN_SWITCH_TIMEOUT_MS)
+    {
+        wifi_w("channel switch on bss_type %d did not complete, resuming tx", priv->bss_type);
+        wifi_chan_switch_end(priv, priv->chan_sw.last_channel, MTRUE);
+    }
+}
+
+int wifi_chan_switch_prepare(mlan_bss_type bss_type)
+{
+    if (bss_type == MLAN_BSS_TYPE_STA)
+        wifi_chan_switch_begin(mlan_adap->priv[0]);
+    else if (bss_type == MLAN_BSS_TYPE_UAP)
+        wifi_chan_switch_begin(mlan_adap->priv[1]);
+    else
+        return -WM_E_INVAL;
+
+    return WM_SUCCESS;
+}
+
+int wifi_get_chan_switch_stats(mlan_bss_type bss_type, wifi_chan_switch_stats_t *stats)
+{
+    const chan_switch_t *chan_sw;
+    unsigned long sta;
+
+    if (stats == MNULL)
+        return -WM_E_INVAL;
+
+    if (bss_type == MLAN_BSS_TYPE_STA)
+        chan_sw = &mlan_adap->priv[0]->chan_sw;
+    else if (bss_type == MLAN_BSS_TYPE_UAP)
+        chan_sw = &mlan_adap->priv[1]->chan_sw;
+    else
+        return -WM_E_INVAL;
+
+    sta                   = os_enter_critical_section();
+    stats->in_progress    = (chan_sw->active == MTRUE) ? true : false;
+    stats->count          = chan_sw->count;
+    stats->timeouts       = chan_sw->timeouts;
+    stats->last_channel   = chan_sw->last_channel;
+    stats->last_outage_ms = chan_sw->last_outage_ms;
+    stats->max_outage_ms  = chan_sw->max_outage_ms;
+    stats->last_retained  = chan_sw->last_held;
+    stats->last_dropped   = chan_sw->last_dropped;
+    os_exit_critical_section(sta);
+
+    return WM_SUCCESS;
+}
+
+/*
+ *  Remain on channel coordination.
+ *
+ *  While the radio is off the home channel the TX scheduler holds all
+ *  interfaces so that queued frames wait in the ralists instead of being
+ *  pushed to firmware and failing. While connected, application requests
+ *  longer than max_slice_ms are served in slices with home_ms on the home
+ *  channel in between. Requests from the supplicant are never sliced, as
+ *  it expects the radio to stay on the channel for its frame exchanges.
+ *  The expired event of a slice resumes TX and arms the home timer, whose
+ *  expiry has the connection manager thread send the next slice, since
+ *  commands cannot be issued from the event context. A slice whose
+ *  expired event never arrives is ended by the expiry timer.
+ *
+ *  The state is changed from the connection manager, event, TX and timer
+ *  contexts, always under roc_mutex. The mutex is never held across a
+ *  firmware command.
+ */
+#define WIFI_ROC_MAX_SLICE_MS 100U
+#define WIFI_ROC_HOME_MS      50U
+
+static wifi_roc_config_t roc_cfg = {WIFI_ROC_MAX_SLICE_MS, WIFI_ROC_HOME_MS};
+static os_timer_t roc_home_timer;
+static os_timer_t roc_expiry_timer;
+
+static void wifi_roc_lock(void)
+{
+    (void)os_mutex_get(&wm_wifi.roc_mutex, OS_WAIT_FOREVER);
+}
+
+static void wifi_roc_unlock(void)
+{
+    (void)os_mutex_put(&wm_wifi.roc_mutex);
+}
+
+static bool wifi_roc_home_busy(void)
+{
+    int i;
+
+    for (i = 0; i < MLAN_MAX_BSS_NUM; i++)
+    {
+        if (mlan_adap->priv[i]->media_connected == MTRUE)
+            return true;
+    }
+
+    return false;
+}
+
+static void wifi_roc_slice_end(t_u8 timed_out)
+{
+    roc_coord_t *roc = &mlan_adap->roc;
+    t_u32 gap_ms     = os_ticks_to_msec(os_ticks_get()) - roc->slice_start_ms;
+
+    (void)os_timer_deactivate(&roc_expiry_timer);
+
+    roc->active     = MFALSE;
+    roc->outage_ms += gap_ms;
+    roc->max_gap_ms = MAX(roc->max_gap_ms, gap_ms);
+    if (timed_out == MTRUE)
+        roc->timeouts++;
+
+#ifdef CONFIG_WMM
+    /* release the frames held while off channel */
+    (void)send_wifi_driver_tx_data_event(MLAN_BSS_TYPE_STA);
+    (void)send_wifi_driver_tx_data_event(MLAN_BSS_TYPE_UAP);
+#endif
+}
+
+static void wifi_roc_finish(t_u8 cancelled)
+{
+    roc_coord_t *roc = &mlan_adap->roc;
+
+    roc->pending          = MFALSE;
+    roc->last_duration_ms = roc->duration_ms;
+    roc->last_slices      = roc->slices;
+    roc->last_outage_ms   = roc->outage_ms;
+    roc->last_max_gap_ms  = roc->max_gap_ms;
+    roc->max_gap_ms_all   = MAX(roc->max_gap_ms_all, roc->max_gap_ms);
+    if (cancelled == MTRUE)
+        roc->cancelled++;
+    else
+        roc->count++;
+
+    wifi_d("remain on channel %d done: %d slices, outage %d ms, longest %d ms", roc->channel, roc->slices,
+           roc->outage_ms, roc->max_gap_ms);
+}
+
+/* Called with roc_mutex held, returns with it held */
+static int wifi_roc_send_slice(void)
+{
+    roc_coord_t *roc = &mlan_adap->roc;
+    wifi_remain_on_channel_t cmd;
+    int ret;
+
+    roc->slice_ms = roc->remain_ms;
+    if (roc->sliced == MTRUE && roc_cfg.max_slice_ms != 0U && roc->slice_ms > roc_cfg.max_slice_ms &&
+        wifi_roc_home_busy())
+        roc->slice_ms = roc_cfg.max_slice_ms;
+
+    (void)memset(&cmd, 0x00, sizeof(cmd));
+    cmd.channel       = roc->channel;
+    cmd.bandcfg       = roc->bandcfg;
+    cmd.remain_period = roc->slice_ms;
+
+    /* hold TX before the radio leaves */
+    roc->slice_start_ms = os_ticks_to_msec(os_ticks_get());
+    roc->active         = MTRUE;
+    roc->remain_ms     -= roc->slice_ms;
+    roc->slices++;
+
+    wifi_roc_unlock();
+    ret = wifi_send_remain_on_channel_cmd(roc->bss_type, &cmd);
+    wifi_roc_lock();
+
+    if (ret != WM_SUCCESS)
+    {
+        /* unless cancelled meanwhile */
+        if (roc->active == MTRUE)
+            wifi_roc_slice_end(MFALSE);
+        return ret;
+    }
+
+    /* resume even if the expired event never comes and nothing is sent */
+    if (roc->active == MTRUE &&
+        (os_timer_change(&roc_expiry_timer, os_msec_to_ticks(roc->slice_ms + WIFI_ROC_EXPIRY_MARGIN_MS), 0) !=
+             WM_SUCCESS ||
+         os_timer_activate(&roc_expiry_timer) != WM_SUCCESS))
+    {
+        wifi_w("remain on channel %d: expiry timer not armed", roc->channel);
+    }
+
+    return WM_SUCCESS;
+}
+
+static void wifi_roc_home_timer_cb(os_timer_arg_t arg)
+{
+    (void)wifi_event_completion(WIFI_EVENT_REMAIN_ON_CHANNEL_SLICE, WIFI_EVENT_REASON_SUCCESS, NULL);
+}
+
+/* Called with roc_mutex held */
+static void wifi_roc_expired(t_u8 timed_out)
+{
+    roc_coord_t *roc = &mlan_adap->roc;
+
+    /* cancelled, or a request this driver did not track */
+    if (roc->active == MFALSE)
+        return;
+
+    wifi_roc_slice_end(timed_out);
+
+    if (roc->remain_ms == 0U)
+    {
+        wifi_roc_finish(MFALSE);
+        return;
+    }
+
+    /* serve the home channel before the next slice */
+    if (roc_cfg.home_ms == 0U || os_timer_change(&roc_home_timer, os_msec_to_ticks(roc_cfg.home_ms), 0) != WM_SUCCESS ||
+        os_timer_activate(&roc_home_timer) != WM_SUCCESS)
+    {
+        wifi_roc_home_timer_cb(MNULL);
+    }
+}
+
+static void wifi_roc_timeout(t_u32 margin_ms)
+{
+    const roc_coord_t *roc = &mlan_adap->roc;
+
+    wifi_roc_lock();
+
+    /* a slice started after the timer fired is not late */
+    if (roc->active == MTRUE &&
+        (os_ticks_to_msec(os_ticks_get()) - roc->slice_start_ms) >= (roc->slice_ms + margin_ms))
+    {
+        wifi_w("remain on channel %d did not expire, resuming tx", roc->channel);
+        wifi_roc_expired(MTRUE);
+    }
+
+    wifi_roc_unlock();
+}
+
+static void wifi_roc_expiry_timer_cb(os_timer_arg_t arg)
+{
+    wifi_roc_timeout(0U);
+}
+
+void wifi_roc_check_timeout(void)
+{
+    if (mlan_adap->roc.active == MFALSE)
+        return;
+
+    wifi_roc_timeout(WIFI_ROC_EXPIRY_MARGIN_MS);
+}
+
+static void wifi_roc_event_expired(void)
+{
+    wifi_roc_lock();
+    wifi_roc_expired(MFALSE);
+    wifi_roc_unlock();
+}
+
+void wifi_roc_next_slice(void)
+{
+    roc_coord_t *roc = &mlan_adap->roc;
+
+    wifi_roc_lock();
+
+    /* cancelled while on the home channel */
+    if (roc->pending == MFALSE || roc->active == MTRUE)
+    {
+        wifi_roc_unlock();
+        return;
+    }
+
+    if (wifi_roc_send_slice() != WM_SUCCESS)
+    {
+        wifi_w("remain on channel %d: next slice failed", roc->channel);
+        if (roc->pending == MTRUE)
+            wifi_roc_finish(MTRUE);
+    }
+
+    wifi_roc_unlock();
+}
+
+void wifi_roc_wait_home(void)
+{
+    const roc_coord_t *roc = &mlan_adap->roc;
+    t_u32 start_ms         = os_ticks_to_msec(os_ticks_get());
+
+    /* between slices the radio is back on the home channel only briefly */
+    while (roc->pending == MTRUE && roc->active == MFALSE && roc->sliced == MTRUE &&
+           (os_ticks_to_msec(os_ticks_get()) - start_ms) < (roc_cfg.home_ms + WIFI_ROC_EXPIRY_MARGIN_MS))
+    {
+        os_thread_sleep(os_msec_to_ticks(1));
+    }
+}
+
+int wifi_roc_request(unsigned int bss_type, const wifi_remain_on_channel_t *roc_req, bool sliced)
+{
+    roc_coord_t *roc = &mlan_adap->roc;
+    wifi_remain_on_channel_t cmd;
+    int ret;
+
+    if (roc_req == MNULL)
+        return -WM_E_INVAL;
+
+    wifi_roc_lock();
+
+    if (roc_home_timer == MNULL)
+    {
+        ret = os_timer_create(&roc_home_timer, "roc-home-timer", os_msec_to_ticks(WIFI_ROC_HOME_MS),
+                              wifi_roc_home_timer_cb, NULL, OS_TIMER_ONE_SHOT, OS_TIMER_NO_ACTIVATE);
+        if (ret != WM_SUCCESS)
+        {
+            wifi_roc_unlock();
+            wifi_e("Unable to create remain on channel timer");
+            return ret;
+        }
+    }
+
+    if (roc_expiry_timer == MNULL)
+    {
+        ret = os_timer_create(&roc_expiry_timer, "roc-expiry-timer", os_msec_to_ticks(WIFI_ROC_EXPIRY_MARGIN_MS),
+                              wifi_roc_expiry_timer_cb, NULL, OS_TIMER_ONE_SHOT, OS_TIMER_NO_ACTIVATE);
+        if (ret != WM_SUCCESS)
+        {
+            wifi_roc_unlock();
+            wifi_e("Unable to create remain on channel expiry timer");
+            return ret;
+        }
+    }
+
+    (void)os_timer_deactivate(&roc_home_timer);
+
+    if (roc->pending == MTRUE)
+    {
+        if (roc->active == MTRUE)
+            wifi_roc_slice_end(MFALSE);
+        wifi_roc_finish(MTRUE);
+    }
+
+    if (roc_req->remove != 0U)
+    {
+        wifi_roc_unlock();
+        (void)memcpy(&cmd, roc_req, sizeof(cmd));
+        return wifi_send_remain_on_channel_cmd(bss_type, &cmd);
+    }
+
+    roc->pending     = MTRUE;
+    roc->sliced      = (sliced == true) ? MTRUE : MFALSE;
+    roc->bss_type    = (t_u8)bss_type;
+    roc->channel     = roc_req->channel;
+    roc->bandcfg     = roc_req->bandcfg;
+    roc->duration_ms = roc_req->remain_period;
+    roc->remain_ms   = roc_req->remain_period;
+    roc->slices      = 0;
+    roc->outage_ms   = 0;
+    roc->max_gap_ms  = 0;
+
+    ret = wifi_roc_send_slice();
+    if (ret != WM_SUCCESS)
+    {
+        roc->pending = MFALSE;
+    }
+
+    wifi_roc_unlock();
+
+    return ret;
+}
+
+int wifi_set_roc_config(const wifi_roc_config_t *cfg)
+{
+    if (cfg == MNULL)
+        return -WM_E_INVAL;
+
+    (void)memcpy(&roc_cfg, cfg, sizeof(roc_cfg));
+
+    return WM_SUCCESS;
+}
+
+int wifi_get_roc_stats(wifi_roc_stats_t *stats)
+{
+    const roc_coord_t *roc = &mlan_adap->roc;
+
+    if (stats == MNULL)
+        return -WM_E_INVAL;
+
+    wifi_roc_lock();
+    stats->in_progress      = (roc->pending == MTRUE) ? true : false;
+    stats->count            = roc->count;
+    stats->cancelled        = roc->cancelled;
+    stats->timeouts         = roc->timeouts;
+    stats->last_duration_ms = roc->last_duration_ms;
+    stats->last_slices      = roc->last_slices;
+    stats->last_outage_ms   = roc->last_outage_ms;
+    stats->last_max_gap_ms  = roc->last_max_gap_ms;
+    stats->max_gap_ms       = roc->max_gap_ms_all;
+    wifi_roc_unlock();
+
+    return WM_SUCCESS;
+}
+
 static void wifi_handle_event_tx_status_report(Event_Ext_t *evt)
 {
 #ifdef CONFIG_WPA_SUPP
@@ -4156,12 +4678,35 @@ int wifi_handle_fw_event(struct bus_message *msg)
             (void)wifi_event_completion(WIFI_EVENT_11N_AGGR_CTRL, WIFI_EVENT_REASON_SUCCESS, NULL);
             break;
         case EVENT_CHANNEL_SWITCH_ANN:
+            if (evt->bss_type == MLAN_BSS_TYPE_UAP)
+            {
+                /* the uAP announced a switch to its clients */
+                if (pmpriv_uap->uap_bss_started == MTRUE)
+                    wifi_chan_switch_begin(pmpriv_uap);
+            }
+            /* without ECSA the connection manager drops the link instead */
+            else if (mlan_adap->ecsa_enable == MTRUE && pmpriv->media_connected == MTRUE)
+            {
+                wifi_chan_switch_begin(pmpriv);
+                /* a uAP set up for ECSA follows the station to the new channel */
+                if (wm_wifi.chan_sw_count != 0U && pmpriv_uap->uap_bss_started == MTRUE)
+                    wifi_chan_switch_begin(pmpriv_uap);
+            }
+            else
+            {
+                /* Do Nothing */
+            }
             (void)wifi_event_completion(WIFI_EVENT_CHAN_SWITCH_ANN, WIFI_EVENT_REASON_SUCCESS, NULL);
             break;
         case EVENT_CHANNEL_SWITCH:
         {
             MrvlIEtypes_channel_band_t *tlv = (MrvlIEtypes_channel_band_t *)(void *)&evt->reason_code;
 
+            wifi_chan_switch_end((evt->bss_type == MLAN_BSS_TYPE_UAP) ? pmpriv_uap : pmpriv, tlv->channel, MFALSE);
+            /* a uAP which followed the station is on the new channel as well */
+            if (evt->bss_type != MLAN_BSS_TYPE_UAP && pmpriv_uap->chan_sw.active == MTRUE)
+                wifi_chan_switch_end(pmpriv_uap, tlv->channel, MFALSE);
+
             new_channel = os_mem_alloc(sizeof(t_u8));
             if (new_channel == MNULL)
             {
@@ -4385,6 +4930,9 @@ int wifi_handle_fw_event(struct bus_message *msg)
 
             break;
 #endif
+        case EVENT_REMAIN_ON_CHANNEL_EXPIRED:
+            wifi_roc_event_expired();
+            break;
 #ifdef CONFIG_CLOUD_KEEP_ALIVE
         case EVENT_CLOUD_KEEP_ALIVE_RETRY_FAIL:
             wevt_d("EVENT: EVENT_CLOUD_KEEP_ALIVE_RETRY_FAIL received\n\r");
@@ -4768,12 +5316,12 @@ int wrapper_bssdesc_first_set(int bss_index,
         {
             WPA_WPA2_WEP->wpa = 1;
 
-            process_wpa_ie(d->wpa_ie_buff, wpa_mcstCipher, wpa_ucstCipher, ap_mfpc, ap_mfpr, WPA_WPA2_WEP);
+            process_wpa_ie((t_u8 *)d->pwpa_ie, wpa_mcstCipher, wpa_ucstCipher, ap_mfpc, ap_mfpr, WPA_WPA2_WEP);
         }
 
         if (d->prsn_ie != MNULL)
         {
-            process_rsn_ie(d->rsn_ie_buff, rsn_mcstCipher, rsn_ucstCipher, ap_mfpc, ap_mfpr, WPA_WPA2_WEP);
+            process_rsn_ie((t_u8 *)d->prsn_ie, rsn_mcstCipher, rsn_ucstCipher, ap_mfpc, ap_mfpr, WPA_WPA2_WEP);
         }
     }
     else
@@ -4887,20 +5435,21 @@ int wrapper_bssdesc_second_set(int bss_index,
 #ifdef CONFIG_11R
     if (mdid != NULL)
     {
-        pmd_ie = (IEEEtypes_MobilityDomain_t *)d->md_ie_buff;
-        *mdid  = pmd_ie->mdid;
+        pmd_ie = d->pmd_ie;
+        *mdid  = (pmd_ie != MNULL) ? pmd_ie->mdid : 0U;
     }
 #endif
 #ifdef CONFIG_11K
     if (neighbor_report_supported != NULL)
     {
-        *neighbor_report_supported = (bool)d->rm_cap_saved.RrmEnabledCapabilities.NborRpt;
+        *neighbor_report_supported =
+            (d->prm_cap != MNULL) ? (bool)d->prm_cap->RrmEnabledCapabilities.NborRpt : false;
     }
 #endif
 #ifdef CONFIG_11V
     if (bss_transition_supported != NULL)
     {
-        *bss_transition_supported = (bool)d->ext_cap_saved.ext_cap.BSS_Transition;
+        *bss_transition_supported = (d->pext_cap != MNULL) ? (bool)d->pext_cap->ext_cap.BSS_Transition : false;
     }
 #endif
 
@@ -4918,6 +5467,121 @@ int wrapper_bssdesc_second_set(int bss_index,
     return WM_SUCCESS;
 }
 
+int wrapper_bssdesc_view(int bss_index, wifi_scan_view_t *view)
+{
+    if (bss_index >= (int)mlan_adap->num_in_scan_table)
+    {
+        return -WM_FAIL;
+    }
+
+    const BSSDescriptor_t *d = &mlan_adap->pscan_table[bss_index];
+
+    view->index           = (unsigned int)bss_index;
+    view->bssid           = d->mac_address;
+    view->ssid            = d->ssid.ssid;
+    view->ssid_len        = (uint8_t)MIN(d->ssid.ssid_len, MLAN_MAX_SSID_LENGTH);
+    view->channel         = d->channel;
+    view->rssi            = (uint8_t)d->rssi;
+    view->is_ibss_bit_set = (d->cap_info.ibss != 0U) ? true : false;
+    view->band            = d->bss_band;
+    view->beacon_period   = d->beacon_period;
+    view->bss             = (const void *)d;
+
+    return WM_SUCCESS;
+}
+
+int wifi_scan_view_get_security(const wifi_scan_view_t *view, wifi_scan_security_t *security)
+{
+    _Cipher_t mcstCipher;
+    _Cipher_t ucstCipher;
+    /* process_wpa_ie() may trim the IE it decodes, so it works on a copy
+     * and the scan table entry stays untouched */
+    t_u8 ie[sizeof(IEEEtypes_Header_t) + 255U];
+
+    if ((view == MNULL) || (view->bss == MNULL) || (security == MNULL))
+    {
+        return -WM_E_INVAL;
+    }
+
+    const BSSDescriptor_t *d = (const BSSDescriptor_t *)view->bss;
+
+    (void)memset(security, 0x00, sizeof(wifi_scan_security_t));
+
+    if (d->pwpa_ie != MNULL || d->prsn_ie != MNULL)
+    {
+        if (d->pwpa_ie != MNULL)
+        {
+            security->sec.wpa = 1;
+            (void)memset(&mcstCipher, 0x00, sizeof(mcstCipher));
+            (void)memset(&ucstCipher, 0x00, sizeof(ucstCipher));
+            (void)memcpy(ie, (const void *)d->pwpa_ie, sizeof(IEEEtypes_Header_t) + d->pwpa_ie->vend_hdr.len);
+            process_wpa_ie(ie, &mcstCipher, &ucstCipher, &security->ap_mfpc, &security->ap_mfpr, &security->sec);
+        }
+
+        if (d->prsn_ie != MNULL)
+        {
+            (void)memset(&mcstCipher, 0x00, sizeof(mcstCipher));
+            (void)memset(&ucstCipher, 0x00, sizeof(ucstCipher));
+            (void)memcpy(ie, (const void *)d->prsn_ie, sizeof(IEEEtypes_Header_t) + d->prsn_ie->ieee_hdr.len);
+            process_rsn_ie(ie, &mcstCipher, &ucstCipher, &security->ap_mfpc, &security->ap_mfpr, &security->sec);
+        }
+    }
+    else
+    {
+        /* Check if WEP */
+        if (d->cap_info.privacy != 0U)
+        {
+            security->sec.wepStatic = 1;
+        }
+    }
+
+    return WM_SUCCESS;
+}
+
+int wifi_scan_view_get_caps(const wifi_scan_view_t *view, wifi_scan_caps_t *caps)
+{
+    if ((view == MNULL) || (view->bss == MNULL) || (caps == MNULL))
+    {
+        return -WM_E_INVAL;
+    }
+
+    const BSSDescriptor_t *d = (const BSSDescriptor_t *)view->bss;
+
+    (void)memset(caps, 0x00, sizeof(wifi_scan_caps_t));
+
+    caps->ht      = (d->pht_cap != NULL) ? true : false;
+    caps->ht_info = (d->pht_info != NULL) ? true : false;
+#ifdef CONFIG_11AC
+    caps->vht = (d->pvht_cap != NULL) ? true : false;
+#endif
+    caps->wmm = (d->wmm_ie.vend_hdr.element_id == WMM_IE) ? true : false;
+    caps->wps = d->wps_IE_exist;
+#if defined(CONFIG_11R) || defined(CONFIG_11K)
+    if ((d->mob_domain_exist) && (d->pmd_ie != MNULL))
+    {
+        caps->mobility_domain = true;
+        caps->mdid            = d->pmd_ie->mdid;
+    }
+#endif
+#ifdef CONFIG_11K
+    if (d->prm_cap != MNULL)
+    {
+        caps->neighbor_report_supported = (bool)d->prm_cap->RrmEnabledCapabilities.NborRpt;
+    }
+#endif
+#ifdef CONFIG_11V
+    if (d->pext_cap != MNULL)
+    {
+        caps->bss_transition_supported = (bool)d->pext_cap->ext_cap.BSS_Transition;
+    }
+#endif
+#ifdef CONFIG_MBO
+    caps->mbo_assoc_disallowed = d->mbo_assoc_disallowed;
+#endif
+
+    return WM_SUCCESS;
+}
+
 int wifi_get_scan_result_count(unsigned *count)
 {
     if (count == MNULL)
@@ -4929,6 +5593,30 @@ int wifi_get_scan_result_count(unsigned *count)
     return WM_SUCCESS;
 }
 
+int wifi_get_scan_mem_stats(wifi_scan_mem_stats_t *stats)
+{
+    if (stats == MNULL)
+    {
+        return -WM_E_INVAL;
+    }
+
+    (void)memset(stats, 0, sizeof(*stats));
+    stats->entries         = mlan_adap->num_in_scan_table;
+    stats->slot_bytes      = sizeof(BSSDescriptor_t);
+    stats->inline_ie_bytes = sizeof(BSSDescriptorIEs_t);
+#ifdef CONFIG_COMPACT_SCAN_TABLE
+    stats->arena_bytes = BSS_IE_ARENA_SIZE;
+    stats->arena_used  = mlan_adap->bss_ie_arena_used;
+    stats->ie_dropped  = mlan_adap->bss_ie_dropped;
+#endif
+    stats->parse_cnt = mlan_adap->bss_parse_cnt;
+    stats->parse_us  = mlan_adap->bss_parse_us;
+    stats->store_cnt = mlan_adap->bss_store_cnt;
+    stats->store_us  = mlan_adap->bss_store_us;
+
+    return WM_SUCCESS;
+}
+
 int wrapper_wlan_set_regiontable(t_u8 region, t_u16 band)
 {
     mlan_private *pmpriv = (mlan_private *)mlan_adap->priv[0];
@@ -5439,17 +6127,132 @@ static void wifi_wmm_tx_stats_dump_ralist(mlan_list_head *ra_list_head)
     ra_list = (raListTbl *)util_peek_list(mlan_adap->pmoal_handle, ra_list_head, MNULL, MNULL);
     while (ra_list && ra_list != (raListTbl *)ra_list_head)
     {
-        wifi_w("    [%02X:XX:XX:XX:%02X:%02X] drop_cnt[%d] total_pkts[%d]", ra_list->ra[0], ra_list->ra[4],
-               ra_list->ra[5], ra_list->drop_count, ra_list->total_pkts);
+        wifi_w("    [%02X:XX:XX:XX:%02X:%02X] drop_cnt[%d] total_pkts[%d] tx_pause[%d] pause_ms[%u] held[%u]",
+               ra_list->ra[0], ra_list->ra[4], ra_list->ra[5], ra_list->drop_count, ra_list->total_pkts,
+               ra_list->tx_pause, ra_list->pause_time, ra_list->held_count);
+        if (mlan_adap->aggr_tune_enable == MTRUE)
+        {
+            wifi_w("        aggr_tune: mode[%s] amsdu_limit[%hu] switches[%hu] tput_kbps[%u] depth[%d] small_pct[%d]",
+                   ra_list->aggr_tune.mode == AGGR_TUNE_MODE_BULK ? "bulk" : "latency", ra_list->aggr_tune.amsdu_limit,
+                   ra_list->aggr_tune.switches, ra_list->aggr_tune.tput_kbps, ra_list->aggr_tune.last_depth,
+                   ra_list->aggr_tune.last_small_pct);
+        }
 
         ra_list = ra_list->pnext;
     }
 }
 
+void wifi_set_aggr_auto_tune(bool enable)
+{
+    mlan_adap->aggr_tune_enable = enable ? MTRUE : MFALSE;
+}
+
+int wifi_get_aggr_tune_stats(int bss_type, const t_u8 *mac, t_u8 ac, wifi_aggr_tune_stats_t *stats)
+{
+    mlan_private *priv            = MNULL;
+    raListTbl *ra_list            = MNULL;
+    t_u8 ra[MLAN_MAC_ADDR_LENGTH] = {0x0};
+
+    if (mac == MNULL || stats == MNULL || ac >= MAX_AC_QUEUES)
+        return -WM_E_INVAL;
+
+    if (bss_type == MLAN_BSS_TYPE_STA)
+        priv = mlan_adap->priv[0];
+    else if (bss_type == MLAN_BSS_TYPE_UAP)
+        priv = mlan_adap->priv[1];
+    else
+        return -WM_E_INVAL;
+
+    wifi_wmm_da_to_ra((uint8_t *)mac, ra);
+
+    mlan_adap->callbacks.moal_semaphore_get(mlan_adap->pmoal_handle, &priv->wmm.tid_tbl_ptr[ac].ra_list.plock);
+
+    ra_list = wlan_wmm_get_ralist_node(priv, ac, ra);
+    if (ra_list == MNULL)
+    {
+        mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &priv->wmm.tid_tbl_ptr[ac].ra_list.plock);
+        return -WM_FAIL;
+    }
+
+    stats->bulk          = (ra_list->aggr_tune.mode == AGGR_TUNE_MODE_BULK) ? true : false;
+    stats->amsdu_allowed = (bool)wlan_aggr_tune_amsdu_allowed(ra_list);
+    stats->amsdu_limit   = (uint16_t)wlan_aggr_tune_amsdu_limit(ra_list, AGGR_TUNE_AMSDU_MAX);
+    stats->ba_allowed    = true;
+    stats->switches      = ra_list->aggr_tune.switches;
+    stats->tput_kbps     = ra_list->aggr_tune.tput_kbps;
+    stats->queue_depth   = ra_list->aggr_tune.last_depth;
+    stats->small_pct     = ra_list->aggr_tune.last_small_pct;
+    stats->drop_count    = ra_list->drop_count;
+
+    if (mlan_adap->aggr_tune_enable == MTRUE && !stats->bulk && ra_list->aggr_tune.win_pkts < AGGR_TUNE_BA_MIN_PKTS)
+        stats->ba_allowed = false;
+
+    mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &priv->wmm.tid_tbl_ptr[ac].ra_list.plock);
+
+    return WM_SUCCESS;
+}
+
+int wifi_set_tx_ext_buf_region(uint8_t *region, uint32_t len)
+{
+    return wifi_wmm_buf_pool_add_ext(region, len);
+}
+
+int wifi_get_tx_buf_pool_stats(wifi_tx_buf_pool_stats_t *stats)
+{
+    outbuf_pool_t *pool = &mlan_adap->outbuf_pool;
+
+    if (stats == MNULL)
+        return -WM_E_INVAL;
+
+    mlan_adap->callbacks.moal_semaphore_get(mlan_adap->pmoal_handle, &pool->free_list.plock);
+    stats->int_total  = MAX_WMM_BUF_NUM;
+    stats->int_used   = (uint16_t)(MAX_WMM_BUF_NUM - pool->free_cnt);
+    stats->int_peak   = (uint16_t)pool->peak_cnt;
+    stats->ext_total  = (uint16_t)pool->ext_total;
+    stats->ext_used   = (uint16_t)(pool->ext_total - pool->ext_free_cnt);
+    stats->ext_peak   = (uint16_t)pool->ext_peak_cnt;
+    stats->ext_queued = pool->ext_queued;
+    stats->promoted   = pool->promoted;
+    mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &pool->free_list.plock);
+
+    return WM_SUCCESS;
+}
+
+int wifi_get_wmm_load(int bss_type, t_u32 *queued, t_u32 *dropped)
+{
+    int i;
+    t_u32 pkts         = 0;
+    mlan_private *priv = MNULL;
+
+    if (queued == MNULL || dropped == MNULL)
+        return -WM_E_INVAL;
+
+    if (bss_type == MLAN_BSS_TYPE_STA)
+        priv = mlan_adap->priv[0];
+    else if (bss_type == MLAN_BSS_TYPE_UAP)
+        priv = mlan_adap->priv[1];
+    else
+        return -WM_E_INVAL;
+
+    for (i = 0; i < MAX_AC_QUEUES; i++)
+    {
+        pkts += priv->wmm.pkts_queued[i];
+    }
+
+    *queued  = pkts;
+    *dropped = wifi_stats_cnt[WIFI_STAT_BSS(bss_type, WIFI_STAT_TX_ERR_MEM)] +
+               wifi_stats_cnt[WIFI_STAT_BSS(bss_type, WIFI_STAT_TX_WMM_RETRIED_DROP)] +
+               wifi_stats_cnt[WIFI_STAT_BSS(bss_type, WIFI_STAT_TX_WMM_PAUSE_DROP)] +
+               wifi_stats_cnt[WIFI_STAT_BSS(bss_type, WIFI_STAT_TX_WMM_EXPIRED_DROP)];
+
+    return WM_SUCCESS;
+}
+
 void wifi_wmm_tx_stats_dump(int bss_type)
 {
     int i;
     mlan_private *priv = MNULL;
+    wifi_stats_snapshot_t snap;
 
     if (bss_type == MLAN_BSS_TYPE_STA)
         priv = mlan_adap->priv[0];
@@ -5464,13 +6267,12 @@ void wifi_wmm_tx_stats_dump(int bss_type)
         wifi_wmm_tx_stats_dump_ralist(&priv->wmm.tid_tbl_ptr[i].ra_list);
     }
 
+    (void)wifi_stats_snapshot(&snap);
     wifi_w("Dump priv[%d] driver_error_cnt:", bss_type);
-    wifi_w("    tx_no_media[%hu]", priv->driver_error_cnt.tx_no_media);
-    wifi_w("    tx_err_mem[%hu]", priv->driver_error_cnt.tx_err_mem);
-    wifi_w("    tx_wmm_retried_drop[%hu]", priv->driver_error_cnt.tx_wmm_retried_drop);
-    wifi_w("    tx_wmm_pause_drop[%hu]", priv->driver_error_cnt.tx_wmm_pause_drop);
-    wifi_w("    tx_wmm_pause_replaced[%hu]", priv->driver_error_cnt.tx_wmm_pause_replaced);
-    wifi_w("    rx_reorder_drop[%hu]", priv->driver_error_cnt.rx_reorder_drop);
+    for (i = (int)WIFI_STAT_TX_NO_MEDIA; i < (int)WIFI_STAT_UAP_BASE; i++)
+    {
+        wifi_w("    %s[%u]", wifi_stats_name(WIFI_STAT_BSS(bss_type, i)), snap.cnt[WIFI_STAT_BSS(bss_type, i)]);
+    }
 
     int free_cnt_real   = 0;
     int free_cnt_stat   = 0;
@@ -5488,6 +6290,9 @@ void wifi_wmm_tx_stats_dump(int bss_type)
 
     mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &mlan_adap->outbuf_pool.free_list.plock);
     wifi_w("TX buffer pool: free_cnt[%d] real_free_cnt[%d]", free_cnt_stat, free_cnt_real);
+    wifi_w("TX buffer pool: peak[%d] ext_total[%d] ext_free[%d] ext_peak[%d] ext_queued[%u] promoted[%u]",
+           mlan_adap->outbuf_pool.peak_cnt, mlan_adap->outbuf_pool.ext_total, mlan_adap->outbuf_pool.ext_free_cnt,
+           mlan_adap->outbuf_pool.ext_peak_cnt, mlan_adap->outbuf_pool.ext_queued, mlan_adap->outbuf_pool.promoted);
 
 #ifdef CONFIG_WMM_DEBUG
     for (i = 0; i < MAX_AC_QUEUES; i++)
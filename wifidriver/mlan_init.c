@@ -29,6 +29,14 @@ Change log:
 
 /* We are allocating BSS list globally as we need heap for other purposes */
 static BSSDescriptor_t BSS_List[MRVDRV_MAX_BSSID_LIST];
+#ifdef CONFIG_COMPACT_SCAN_TABLE
+/* Retained IEs of the BSS list entries, packed back to back */
+static t_u8 BSS_IE_Arena[BSS_IE_ARENA_SIZE];
+/* IEs of the beacon being parsed */
+static BSSDescriptorIEs_t BSS_IE_Stage;
+/* IEs of the associated BSS */
+static t_u8 BSS_IE_Curr[BSS_IE_BLOB_MAX];
+#endif
 
 //_IOBUFS_ALIGNED(SDIO_DMA_ALIGNMENT)
 #if defined(SD8978) || defined(SD8987) || defined(SD8997) || defined(SD9097) || defined(SD9098) || defined(IW61x)
@@ -65,6 +73,12 @@ mlan_status wlan_allocate_adapter(pmlan_adapter pmadapter)
     t_u32 buf_size;
 
     pmadapter->pscan_table = BSS_List;
+#ifdef CONFIG_COMPACT_SCAN_TABLE
+    pmadapter->pbss_ie_arena     = BSS_IE_Arena;
+    pmadapter->bss_ie_arena_used = 0;
+    pmadapter->pbss_ie_stage     = &BSS_IE_Stage;
+    pmadapter->pcurr_bss_ie_blob = BSS_IE_Curr;
+#endif
     pmadapter->num_in_chan_stats = chan_2g_size;
 #ifdef CONFIG_5GHz_SUPPORT
     pmadapter->num_in_chan_stats += chan_5g_size;
@@ -172,6 +186,9 @@ mlan_status wlan_init_priv(pmlan_private priv)
         priv->addba_reject[i] = ADDBA_RSP_STATUS_ACCEPT;
     }
     priv->max_amsdu = 0;
+#ifdef CONFIG_WMM
+    priv->tx_weight = WMM_BSS_DEF_WEIGHT;
+#endif
 
     priv->scan_block = MFALSE;
 
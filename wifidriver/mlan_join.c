@@ -1258,6 +1258,9 @@ mlan_status wlan_ret_802_11_associate(IN mlan_private *pmpriv, IN HostCmd_DS_COM
 
     /* Make a copy of current BSSID descriptor */
     (void)__memcpy(pmpriv->adapter, &pmpriv->curr_bss_params.bss_descriptor, pbss_desc, sizeof(BSSDescriptor_t));
+#ifdef CONFIG_COMPACT_SCAN_TABLE
+    wlan_bss_ie_pin(pmpriv->adapter, &pmpriv->curr_bss_params.bss_descriptor);
+#endif
 
     /* Update curr_bss_params */
     pmpriv->curr_bss_params.bss_descriptor.channel = pbss_desc->phy_param_set.ds_param_set.current_chan;
@@ -167,6 +167,7 @@ sta_node *wlan_add_station_entry(mlan_private *priv, t_u8 *mac)
                                              (t_u8 **)&sta_ptr))
     {
         PRINTM(MERROR, "Failed to allocate memory for station node\n");
+        pmadapter->callbacks.moal_spin_unlock(pmadapter->pmoal_handle, priv->wmm.ra_list_spinlock);
         LEAVE();
         return MNULL;
     }
@@ -1420,9 +1420,18 @@ static mlan_status wlan_interpret_bss_desc_with_ie(IN pmlan_adapter pmadapter,
 #endif
 
     IEEEtypes_CountryInfoSet_t *pcountry_info;
+#ifdef CONFIG_COMPACT_SCAN_TABLE
+    BSSDescriptorIEs_t *pies = pmadapter->pbss_ie_stage;
+#else
+    BSSDescriptorIEs_t *pies = &pbss_entry->saved;
+#endif
 
     ENTER();
 
+#ifdef CONFIG_COMPACT_SCAN_TABLE
+    (void)__memset(pmadapter, pies, 0x00, sizeof(BSSDescriptorIEs_t));
+#endif
+
     found_data_rate_ie = MFALSE;
     rate_size          = 0;
     beacon_size        = 0;
@@ -1662,7 +1671,8 @@ static mlan_status wlan_interpret_bss_desc_with_ie(IN pmlan_adapter pmadapter,
                     return MLAN_STATUS_FAILURE;
                 }
 
-                (void)__memcpy(pmadapter, &pbss_entry->country_info, pcountry_info, pcountry_info->len + 2);
+                (void)__memcpy(pmadapter, &pies->country_info, pcountry_info, pcountry_info->len + 2);
+                pbss_entry->pcountry_info = &pies->country_info;
                 HEXDUMP("InterpretIE: 11D- country_info:", (t_u8 *)pcountry_info, (t_u32)(pcountry_info->len + 2));
                 break;
             case POWER_CONSTRAINT:
@@ -1716,11 +1726,11 @@ static mlan_status wlan_interpret_bss_desc_with_ie(IN pmlan_adapter pmadapter,
                     /* fixme : Verify if this is the right approach. This had to be
                        done because IEEEtypes_Rsn_t was not the correct data
                        structure to map here  */
-                    if (element_len <= (sizeof(pbss_entry->wpa_ie_buff) - sizeof(IEEEtypes_Header_t)))
+                    if (element_len <= (sizeof(pies->wpa_ie_buff) - sizeof(IEEEtypes_Header_t)))
                     {
-                        (void)__memcpy(NULL, pbss_entry->wpa_ie_buff, pcurrent_ptr,
+                        (void)__memcpy(NULL, pies->wpa_ie_buff, pcurrent_ptr,
                                        element_len + sizeof(IEEEtypes_Header_t));
-                        pbss_entry->pwpa_ie         = (IEEEtypes_VendorSpecific_t *)(void *)pbss_entry->wpa_ie_buff;
+                        pbss_entry->pwpa_ie         = (IEEEtypes_VendorSpecific_t *)(void *)pies->wpa_ie_buff;
                         pbss_entry->wpa_ie_buff_len = element_len + sizeof(IEEEtypes_Header_t);
 
                         if (wifi_check_bss_entry_wpa2_entp_only(pbss_entry, VENDOR_SPECIFIC_221) != MLAN_STATUS_SUCCESS)
@@ -1821,11 +1831,12 @@ static mlan_status wlan_interpret_bss_desc_with_ie(IN pmlan_adapter pmadapter,
                 else
                 {
                     if (pbss_entry->vendor_ie_len + element_len + (t_u8)sizeof(IEEEtypes_Header_t) <
-                        (t_u8)sizeof(pbss_entry->vendor_ie_buff))
+                        (t_u8)sizeof(pies->vendor_ie_buff))
                     {
-                        (void)__memcpy(pmadapter, pbss_entry->vendor_ie_buff + pbss_entry->vendor_ie_len, pcurrent_ptr,
+                        (void)__memcpy(pmadapter, pies->vendor_ie_buff + pbss_entry->vendor_ie_len, pcurrent_ptr,
                                        element_len + sizeof(IEEEtypes_Header_t));
                         pbss_entry->vendor_ie_len += element_len + (t_u8)sizeof(IEEEtypes_Header_t);
+                        pbss_entry->pvendor_ie = pies->vendor_ie_buff;
                     }
                 }
 #else
@@ -1847,12 +1858,12 @@ static mlan_status wlan_interpret_bss_desc_with_ie(IN pmlan_adapter pmadapter,
                 /* fixme : Verify if this is the right approach. This had to be
                    done because IEEEtypes_Rsn_t was not the correct data
                    structure to map here  */
-                if (element_len <= (sizeof(pbss_entry->rsn_ie_buff) - sizeof(IEEEtypes_Header_t)))
+                if (element_len <= (sizeof(pies->rsn_ie_buff) - sizeof(IEEEtypes_Header_t)))
                 {
-                    (void)__memcpy(NULL, pbss_entry->rsn_ie_buff, pcurrent_ptr,
+                    (void)__memcpy(NULL, pies->rsn_ie_buff, pcurrent_ptr,
                                    element_len + sizeof(IEEEtypes_Header_t));
                     pbss_entry->rsn_ie_buff_len = element_len + sizeof(IEEEtypes_Header_t);
-                    pbss_entry->prsn_ie         = (IEEEtypes_Generic_t *)(void *)pbss_entry->rsn_ie_buff;
+                    pbss_entry->prsn_ie         = (IEEEtypes_Generic_t *)(void *)pies->rsn_ie_buff;
 
                     if (wifi_check_bss_entry_wpa2_entp_only(pbss_entry, RSN_IE) != MLAN_STATUS_SUCCESS)
                     {
@@ -1872,12 +1883,12 @@ static mlan_status wlan_interpret_bss_desc_with_ie(IN pmlan_adapter pmadapter,
                 break;
 #if defined(CONFIG_11R) || defined(CONFIG_11K)
             case MOBILITY_DOMAIN:
-                if (element_len <= (sizeof(pbss_entry->md_ie_buff) - sizeof(IEEEtypes_Header_t)))
+                if (element_len <= (sizeof(pies->md_ie_buff) - sizeof(IEEEtypes_Header_t)))
                 {
-                    (void)__memcpy(NULL, pbss_entry->md_ie_buff, pcurrent_ptr,
+                    (void)__memcpy(NULL, pies->md_ie_buff, pcurrent_ptr,
                                    element_len + sizeof(IEEEtypes_Header_t));
                     pbss_entry->md_ie_buff_len   = element_len + sizeof(IEEEtypes_Header_t);
-                    pbss_entry->pmd_ie           = (IEEEtypes_MobilityDomain_t *)(void *)pbss_entry->md_ie_buff;
+                    pbss_entry->pmd_ie           = (IEEEtypes_MobilityDomain_t *)(void *)pies->md_ie_buff;
                     pbss_entry->mob_domain_exist = 1;
                     /* dump_hex(pbss_entry->pmd_ie, pbss_entry->md_ie_buff_len); */
                 }
@@ -1890,7 +1901,8 @@ static mlan_status wlan_interpret_bss_desc_with_ie(IN pmlan_adapter pmadapter,
 #ifdef CONFIG_11K
             case RRM_ENABLED_CAP:
                 /* Save it here since we do not have beacon buffer */
-                (void)__memcpy(NULL, &pbss_entry->rm_cap_saved, pcurrent_ptr, sizeof(IEEEtypes_RrmElement_t));
+                (void)__memcpy(NULL, &pies->rm_cap_saved, pcurrent_ptr, sizeof(IEEEtypes_RrmElement_t));
+                pbss_entry->prm_cap      = &pies->rm_cap_saved;
                 pbss_entry->rm_cap_exist = 1;
                 break;
 #endif
@@ -1898,8 +1910,8 @@ static mlan_status wlan_interpret_bss_desc_with_ie(IN pmlan_adapter pmadapter,
                 break;
             case HT_CAPABILITY:
                 /* Save it here since we do not have beacon buffer */
-                (void)__memcpy(NULL, &pbss_entry->ht_cap_saved, pcurrent_ptr, sizeof(IEEEtypes_HTCap_t));
-                pbss_entry->pht_cap = &pbss_entry->ht_cap_saved;
+                (void)__memcpy(NULL, &pies->ht_cap_saved, pcurrent_ptr, sizeof(IEEEtypes_HTCap_t));
+                pbss_entry->pht_cap = &pies->ht_cap_saved;
                 /* pbss_entry->pht_cap = (IEEEtypes_HTCap_t *) pcurrent_ptr; */
                 /* pbss_entry->ht_cap_offset = */
                 /*     (t_u16) (pcurrent_ptr - pbss_entry->pbeacon_buf); */
@@ -1908,8 +1920,8 @@ static mlan_status wlan_interpret_bss_desc_with_ie(IN pmlan_adapter pmadapter,
                 break;
             case HT_OPERATION:
                 /* Save it here since we do not have beacon buffer */
-                (void)__memcpy(NULL, &pbss_entry->ht_info_saved, pcurrent_ptr, sizeof(IEEEtypes_HTInfo_t));
-                pbss_entry->pht_info = &pbss_entry->ht_info_saved;
+                (void)__memcpy(NULL, &pies->ht_info_saved, pcurrent_ptr, sizeof(IEEEtypes_HTInfo_t));
+                pbss_entry->pht_info = &pies->ht_info_saved;
                 /* pbss_entry->pht_info = (IEEEtypes_HTInfo_t *) pcurrent_ptr; */
                 /* pbss_entry->ht_info_offset = */
                 /*     (t_u16) (pcurrent_ptr - pbss_entry->pbeacon_buf); */
@@ -1918,8 +1930,8 @@ static mlan_status wlan_interpret_bss_desc_with_ie(IN pmlan_adapter pmadapter,
                 break;
             case BSSCO_2040:
                 /* Save it here since we do not have beacon buffer */
-                (void)__memcpy(NULL, &pbss_entry->bss_co_2040_saved, pcurrent_ptr, sizeof(IEEEtypes_2040BSSCo_t));
-                pbss_entry->pbss_co_2040 = &pbss_entry->bss_co_2040_saved;
+                (void)__memcpy(NULL, &pies->bss_co_2040_saved, pcurrent_ptr, sizeof(IEEEtypes_2040BSSCo_t));
+                pbss_entry->pbss_co_2040 = &pies->bss_co_2040_saved;
                 /* pbss_entry->pbss_co_2040 = (IEEEtypes_2040BSSCo_t *) pcurrent_ptr; */
                 /* pbss_entry->bss_co_2040_offset = */
                 /*     (t_u16) (pcurrent_ptr - pbss_entry->pbeacon_buf); */
@@ -1929,33 +1941,33 @@ static mlan_status wlan_interpret_bss_desc_with_ie(IN pmlan_adapter pmadapter,
 #ifdef CONFIG_11AC
             case VHT_CAPABILITY:
                 /* Save it here since we do not have beacon buffer */
-                (void)__memcpy(NULL, &pbss_entry->vht_cap_saved, pcurrent_ptr, sizeof(IEEEtypes_VHTCap_t));
-                pbss_entry->pvht_cap = &pbss_entry->vht_cap_saved;
+                (void)__memcpy(NULL, &pies->vht_cap_saved, pcurrent_ptr, sizeof(IEEEtypes_VHTCap_t));
+                pbss_entry->pvht_cap = &pies->vht_cap_saved;
                 break;
             case VHT_OPERATION:
                 /* Save it here since we do not have beacon buffer */
-                (void)__memcpy(NULL, &pbss_entry->vht_oprat_saved, pcurrent_ptr, sizeof(IEEEtypes_VHTOprat_t));
-                pbss_entry->pvht_oprat = &pbss_entry->vht_oprat_saved;
+                (void)__memcpy(NULL, &pies->vht_oprat_saved, pcurrent_ptr, sizeof(IEEEtypes_VHTOprat_t));
+                pbss_entry->pvht_oprat = &pies->vht_oprat_saved;
                 break;
             case VHT_TX_POWER_ENV:
                 /* Save it here since we do not have beacon buffer */
-                (void)__memcpy(NULL, &pbss_entry->vht_txpower_saved, pcurrent_ptr, sizeof(IEEEtypes_VHTtxpower_t));
-                pbss_entry->pvht_txpower = &pbss_entry->vht_txpower_saved;
+                (void)__memcpy(NULL, &pies->vht_txpower_saved, pcurrent_ptr, sizeof(IEEEtypes_VHTtxpower_t));
+                pbss_entry->pvht_txpower = &pies->vht_txpower_saved;
                 break;
             case OPER_MODE_NTF:
                 /* Save it here since we do not have beacon buffer */
-                (void)__memcpy(NULL, &pbss_entry->poper_mode_saved, pcurrent_ptr, sizeof(IEEEtypes_OperModeNtf_t));
-                pbss_entry->ppoper_mode = &pbss_entry->poper_mode_saved;
+                (void)__memcpy(NULL, &pies->poper_mode_saved, pcurrent_ptr, sizeof(IEEEtypes_OperModeNtf_t));
+                pbss_entry->ppoper_mode = &pies->poper_mode_saved;
                 break;
 #endif
             case EXT_CAPABILITY:
                 /* Save it here since we do not have beacon buffer */
-                (void)__memcpy(NULL, &pbss_entry->ext_cap_saved, pcurrent_ptr, sizeof(IEEEtypes_ExtCap_t));
-                pbss_entry->pext_cap = &pbss_entry->ext_cap_saved;
+                (void)__memcpy(NULL, &pies->ext_cap_saved, pcurrent_ptr, sizeof(IEEEtypes_ExtCap_t));
+                pbss_entry->pext_cap = &pies->ext_cap_saved;
                 break;
             case RSNX_IE:
-                (void)__memcpy(NULL, &pbss_entry->rsnx_ie_saved, pcurrent_ptr, sizeof(pbss_entry->rsnx_ie_saved));
-                pbss_entry->prsnx_ie = &pbss_entry->rsnx_ie_saved;
+                (void)__memcpy(NULL, &pies->rsnx_ie_saved, pcurrent_ptr, sizeof(pies->rsnx_ie_saved));
+                pbss_entry->prsnx_ie = &pies->rsnx_ie_saved;
                 wscan_d("RSNX_IE: tag len %d data 0x%02x", pbss_entry->prsnx_ie->ieee_hdr.len,
                         pbss_entry->prsnx_ie->data[0]);
                 break;
@@ -1981,6 +1993,22 @@ static mlan_status wlan_interpret_bss_desc_with_ie(IN pmlan_adapter pmadapter,
     return ret;
 }
 
+/* Parse one BSS, accounting the time for wifi_get_scan_mem_stats() */
+static mlan_status wlan_interpret_bss_desc_timed(IN pmlan_adapter pmadapter,
+                                                 OUT BSSDescriptor_t *pbss_entry,
+                                                 IN t_u8 **pbeacon_info,
+                                                 IN t_u32 *bytes_left,
+                                                 IN t_u8 ext_scan)
+{
+    t_u32 start_us  = os_get_timestamp();
+    mlan_status ret = wlan_interpret_bss_desc_with_ie(pmadapter, pbss_entry, pbeacon_info, bytes_left, ext_scan);
+
+    pmadapter->bss_parse_cnt++;
+    pmadapter->bss_parse_us += os_get_timestamp() - start_us;
+
+    return ret;
+}
+
 
 /**
  *  @brief get the chan load from chan stats.
@@ -2483,6 +2511,9 @@ mlan_status wlan_scan_networks(IN mlan_private *pmpriv,
     {
         (void)__memset(pmadapter, pmadapter->pscan_table, 0x00, sizeof(BSSDescriptor_t) * MRVDRV_MAX_BSSID_LIST);
         pmadapter->num_in_scan_table = 0;
+#ifdef CONFIG_COMPACT_SCAN_TABLE
+        wlan_bss_ie_arena_reset(pmadapter);
+#endif
     }
 
     pmadapter->idx_chan_stats = 0;
@@ -2560,60 +2591,402 @@ mlan_status wlan_cmd_802_11_scan(IN mlan_private *pmpriv, IN HostCmd_DS_COMMAND
  * pointers still point to buffer addresses in the separate structure. We
  * will update them here.
  */
-static void adjust_pointers_to_internal_buffers(BSSDescriptor_t *pbss_entry, BSSDescriptor_t *pbss_new_entry)
+#ifdef CONFIG_COMPACT_SCAN_TABLE
+/** Most IEs a single BSS can keep in the scan IE arena */
+#define BSS_IE_MAX_REFS 16U
+
+/*
+ * Groups of IEs which are kept or dropped together. Readers take one IE
+ * of a group as a sign that the others are there too, e.g. the VHT
+ * capability join code reads the HT capability.
+ */
+typedef enum _bss_ie_group_e
+{
+    BSS_IE_GROUP_SEC = 0,
+    BSS_IE_GROUP_HT,
+    BSS_IE_GROUP_VHT,
+    BSS_IE_GROUP_COUNTRY,
+    BSS_IE_GROUP_EXT_CAP,
+    BSS_IE_GROUP_RRM,
+    BSS_IE_GROUP_VENDOR,
+} bss_ie_group_e;
+
+/** A retained IE: the descriptor pointer referring to it, its size and group */
+typedef struct _bss_ie_ref_t
+{
+    void **pptr;
+    t_u32 len;
+    t_u8 group;
+} bss_ie_ref_t;
+
+static void wlan_bss_ie_ref_add(bss_ie_ref_t *refs, t_u8 *pnum, void **pptr, t_u32 len, bss_ie_group_e group)
+{
+    if ((*pptr != MNULL) && (len != 0U) && (*pnum < BSS_IE_MAX_REFS))
+    {
+        refs[*pnum].pptr  = pptr;
+        refs[*pnum].len   = len;
+        refs[*pnum].group = (t_u8)group;
+        (*pnum)++;
+    }
+}
+
+/*
+ * Lists the IEs retained by a scan table entry, the IEs of a group next
+ * to each other. The security IEs come first and their count is returned
+ * in pnum_sec, they are never dropped as association cannot work without
+ * them.
+ */
+static t_u8 wlan_bss_ie_refs(BSSDescriptor_t *pbss_entry, bss_ie_ref_t *refs, t_u8 *pnum_sec)
+{
+    t_u8 num = 0;
+
+    wlan_bss_ie_ref_add(refs, &num, (void **)(void *)&pbss_entry->prsn_ie, (t_u32)pbss_entry->rsn_ie_buff_len,
+                        BSS_IE_GROUP_SEC);
+    wlan_bss_ie_ref_add(refs, &num, (void **)(void *)&pbss_entry->pwpa_ie, (t_u32)pbss_entry->wpa_ie_buff_len,
+                        BSS_IE_GROUP_SEC);
+    wlan_bss_ie_ref_add(refs, &num, (void **)(void *)&pbss_entry->prsnx_ie, BSS_IE_RSNX_LEN, BSS_IE_GROUP_SEC);
+#if defined(CONFIG_11R) || defined(CONFIG_11K)
+    wlan_bss_ie_ref_add(refs, &num, (void **)(void *)&pbss_entry->pmd_ie, (t_u32)pbss_entry->md_ie_buff_len,
+                        BSS_IE_GROUP_SEC);
+#endif
+    *pnum_sec = num;
+
+    wlan_bss_ie_ref_add(refs, &num, (void **)(void *)&pbss_entry->pht_cap, sizeof(IEEEtypes_HTCap_t), BSS_IE_GROUP_HT);
+    wlan_bss_ie_ref_add(refs, &num, (void **)(void *)&pbss_entry->pht_info, sizeof(IEEEtypes_HTInfo_t), BSS_IE_GROUP_HT);
+    wlan_bss_ie_ref_add(refs, &num, (void **)(void *)&pbss_entry->pbss_co_2040, sizeof(IEEEtypes_2040BSSCo_t),
+                        BSS_IE_GROUP_HT);
+#ifdef CONFIG_11AC
+    wlan_bss_ie_ref_add(refs, &num, (void **)(void *)&pbss_entry->pvht_cap, sizeof(IEEEtypes_VHTCap_t),
+                        BSS_IE_GROUP_VHT);
+    wlan_bss_ie_ref_add(refs, &num, (void **)(void *)&pbss_entry->pvht_oprat, sizeof(IEEEtypes_VHTOprat_t),
+                        BSS_IE_GROUP_VHT);
+    wlan_bss_ie_ref_add(refs, &num, (void **)(void *)&pbss_entry->pvht_txpower, sizeof(IEEEtypes_VHTtxpower_t),
+                        BSS_IE_GROUP_VHT);
+    wlan_bss_ie_ref_add(refs, &num, (void **)(void *)&pbss_entry->ppoper_mode, sizeof(IEEEtypes_OperModeNtf_t),
+                        BSS_IE_GROUP_VHT);
+#endif
+    if (pbss_entry->pcountry_info != MNULL)
+    {
+        wlan_bss_ie_ref_add(refs, &num, (void **)(void *)&pbss_entry->pcountry_info,
+                            (t_u32)pbss_entry->pcountry_info->len + 2U, BSS_IE_GROUP_COUNTRY);
+    }
+    wlan_bss_ie_ref_add(refs, &num, (void **)(void *)&pbss_entry->pext_cap, sizeof(IEEEtypes_ExtCap_t),
+                        BSS_IE_GROUP_EXT_CAP);
+#ifdef CONFIG_11K
+    wlan_bss_ie_ref_add(refs, &num, (void **)(void *)&pbss_entry->prm_cap, sizeof(IEEEtypes_RrmElement_t),
+                        BSS_IE_GROUP_RRM);
+    wlan_bss_ie_ref_add(refs, &num, (void **)(void *)&pbss_entry->pvendor_ie, pbss_entry->vendor_ie_len,
+                        BSS_IE_GROUP_VENDOR);
+#endif
+
+    return num;
+}
+
+/* Moves every IE pointer of an entry along with its blob */
+static void wlan_bss_ie_rebase(bss_ie_ref_t *refs, t_u8 num, t_u8 *pold, t_u8 *pnew)
+{
+    t_u8 i;
+
+    for (i = 0; i < num; i++)
+    {
+        *refs[i].pptr = (void *)(pnew + ((t_u8 *)*refs[i].pptr - pold));
+    }
+}
+
+/*
+ * Squeezes out the blobs of entries that were replaced. Live blobs are
+ * slid down in address order so each move only goes towards the start
+ * of the arena and never overwrites a blob not yet moved. All slots are
+ * walked as entries appended by the response being processed are not
+ * yet counted in num_in_scan_table.
+ */
+static void wlan_bss_ie_arena_compact(pmlan_adapter pmadapter)
+{
+    bss_ie_ref_t refs[BSS_IE_MAX_REFS];
+    BSSDescriptor_t *pnext;
+    t_u8 *pdst;
+    t_u8 num, num_sec;
+    t_u32 i;
+
+    pmadapter->bss_ie_arena_used = 0;
+
+    while (true)
+    {
+        pdst  = pmadapter->pbss_ie_arena + pmadapter->bss_ie_arena_used;
+        pnext = MNULL;
+        for (i = 0; i < MRVDRV_MAX_BSSID_LIST; i++)
+        {
+            if ((pmadapter->pscan_table[i].ie_blob != MNULL) && (pmadapter->pscan_table[i].ie_blob >= pdst) &&
+                ((pnext == MNULL) || (pmadapter->pscan_table[i].ie_blob < pnext->ie_blob)))
+            {
+                pnext = &pmadapter->pscan_table[i];
+            }
+        }
+        if (pnext == MNULL)
+        {
+            break;
+        }
+
+        if (pnext->ie_blob != pdst)
+        {
+            num = wlan_bss_ie_refs(pnext, refs, &num_sec);
+            (void)__memmove(pmadapter, pdst, pnext->ie_blob, pnext->ie_blob_len);
+            wlan_bss_ie_rebase(refs, num, pnext->ie_blob, pdst);
+            pnext->ie_blob = pdst;
+        }
+        pmadapter->bss_ie_arena_used += pnext->ie_blob_len;
+    }
+}
+
+/*
+ * Packs the IEs parsed into the staging area into the shared arena. The
+ * arena always has room for the security IEs of every entry, the other
+ * IEs share what is left. When that runs out a group of IEs is dropped
+ * as a whole, and the VHT IEs go with the HT IEs, so that an entry never
+ * keeps an IE without the ones readers expect next to it.
+ */
+static void wlan_bss_ie_store(pmlan_adapter pmadapter, BSSDescriptor_t *pbss_entry)
+{
+    bss_ie_ref_t refs[BSS_IE_MAX_REFS];
+    t_u8 num, num_sec, i, k;
+    t_u32 opt_budget = 0;
+    t_u32 opt_len    = 0;
+    t_u32 need       = 0;
+    t_u32 reserved   = MRVDRV_MAX_BSSID_LIST * BSS_IE_SEC_MAX;
+    t_u32 len;
+    t_u32 j;
+    t_u8 *pos;
+    t_u8 ht_dropped = MFALSE;
+
+    pbss_entry->ie_blob     = MNULL;
+    pbss_entry->ie_blob_len = 0;
+    pbss_entry->ie_opt_len  = 0;
+
+    if (BSS_IE_ARENA_SIZE > reserved)
+    {
+        opt_budget = BSS_IE_ARENA_SIZE - reserved;
+    }
+    for (j = 0; j < MRVDRV_MAX_BSSID_LIST; j++)
+    {
+        if (&pmadapter->pscan_table[j] != pbss_entry)
+        {
+            opt_budget -= MIN(opt_budget, pmadapter->pscan_table[j].ie_opt_len);
+        }
+    }
+
+    num = wlan_bss_ie_refs(pbss_entry, refs, &num_sec);
+    for (i = 0; i < num; i = k)
+    {
+        len = 0;
+        for (k = i; (k < num) && (refs[k].group == refs[i].group); k++)
+        {
+            len += BSS_IE_ALIGN(refs[k].len);
+        }
+
+        if ((i >= num_sec) &&
+            (((opt_len + len) > opt_budget) || ((refs[i].group == (t_u8)BSS_IE_GROUP_VHT) && (ht_dropped == MTRUE))))
+        {
+            if (refs[i].group == (t_u8)BSS_IE_GROUP_HT)
+            {
+                ht_dropped = MTRUE;
+            }
+            for (j = i; j < k; j++)
+            {
+                *refs[j].pptr = MNULL;
+                pmadapter->bss_ie_dropped++;
+            }
+            continue;
+        }
+        if (i >= num_sec)
+        {
+            opt_len += len;
+        }
+        need += len;
+    }
+#ifdef CONFIG_11K
+    if (pbss_entry->pvendor_ie == MNULL)
+    {
+        pbss_entry->vendor_ie_len = 0;
+    }
+    if (pbss_entry->prm_cap == MNULL)
+    {
+        pbss_entry->rm_cap_exist = false;
+    }
+#endif
+    if (pbss_entry->pext_cap == MNULL)
+    {
+        pbss_entry->ext_cap_exist = false;
+    }
+
+    if (need == 0U)
+    {
+        return;
+    }
+
+    if ((pmadapter->bss_ie_arena_used + need) > BSS_IE_ARENA_SIZE)
+    {
+        wlan_bss_ie_arena_compact(pmadapter);
+    }
+
+    pos                     = pmadapter->pbss_ie_arena + pmadapter->bss_ie_arena_used;
+    pbss_entry->ie_blob     = pos;
+    pbss_entry->ie_blob_len = (t_u16)need;
+    pbss_entry->ie_opt_len  = (t_u16)opt_len;
+    pmadapter->bss_ie_arena_used += need;
+
+    for (i = 0; i < num; i++)
+    {
+        if (*refs[i].pptr != MNULL)
+        {
+            (void)__memcpy(pmadapter, pos, *refs[i].pptr, refs[i].len);
+            *refs[i].pptr = (void *)pos;
+            pos += BSS_IE_ALIGN(refs[i].len);
+        }
+    }
+}
+
+/**
+ *  @brief Forget all IE blobs of the scan table
+ *
+ *  @param pmadapter    A pointer to mlan_adapter structure
+ *
+ *  @return             N/A
+ */
+void wlan_bss_ie_arena_reset(IN pmlan_adapter pmadapter)
+{
+    pmadapter->bss_ie_arena_used = 0;
+}
+
+/**
+ *  @brief Copy the IEs of the associated BSS out of the scan IE arena
+ *
+ *  The scan table may be rebuilt at any time while connected, the
+ *  copy kept for the association must not refer to the arena.
+ *
+ *  @param pmadapter    A pointer to mlan_adapter structure
+ *  @param pbss_desc    A pointer to the copy of the associated BSS entry
+ *
+ *  @return             N/A
+ */
+void wlan_bss_ie_pin(IN pmlan_adapter pmadapter, IN BSSDescriptor_t *pbss_desc)
 {
+    bss_ie_ref_t refs[BSS_IE_MAX_REFS];
+    t_u8 num, num_sec;
+
+    if ((pbss_desc->ie_blob == MNULL) || (pbss_desc->ie_blob == pmadapter->pcurr_bss_ie_blob))
+    {
+        return;
+    }
+
+    num = wlan_bss_ie_refs(pbss_desc, refs, &num_sec);
+    (void)__memcpy(pmadapter, pmadapter->pcurr_bss_ie_blob, pbss_desc->ie_blob, pbss_desc->ie_blob_len);
+    wlan_bss_ie_rebase(refs, num, pbss_desc->ie_blob, pmadapter->pcurr_bss_ie_blob);
+    pbss_desc->ie_blob = pmadapter->pcurr_bss_ie_blob;
+}
+#endif
+
+/*
+ * Fills the pointer variables with correct address.
+ *
+ * Original mlan stores the entire beacon. We cannot do that as it would
+ * take approx 4K RAM per entry. Instead we keep the IEs needed later in
+ * BSSDescriptorIEs_t. The pointers in this structure which would
+ * (ideally) point to addresses in beacon buffer now point to these
+ * saved copies.
+ *
+ * Due beacon parsing a separate structure was used. That is mem-copied
+ * into an entry in the static BSS_List. After this copy the internal
+ * pointers still point to buffer addresses in the separate structure. We
+ * will update them here. With CONFIG_COMPACT_SCAN_TABLE the IEs are
+ * packed into the shared scan IE arena instead.
+ */
+static void adjust_pointers_to_internal_buffers(pmlan_adapter pmadapter,
+                                                BSSDescriptor_t *pbss_entry,
+                                                BSSDescriptor_t *pbss_new_entry)
+{
+    t_u32 start_us = os_get_timestamp();
+
+#ifdef CONFIG_COMPACT_SCAN_TABLE
+    wlan_bss_ie_store(pmadapter, pbss_entry);
+#else
+    BSSDescriptorIEs_t *pies = &pbss_entry->saved;
+
     if (pbss_entry->pht_cap != NULL)
     {
-        pbss_entry->pht_cap = &pbss_entry->ht_cap_saved;
+        pbss_entry->pht_cap = &pies->ht_cap_saved;
     }
     if (pbss_entry->pht_info != NULL)
     {
-        pbss_entry->pht_info = &pbss_entry->ht_info_saved;
+        pbss_entry->pht_info = &pies->ht_info_saved;
     }
 #ifdef CONFIG_11AC
     if (pbss_entry->pvht_cap != NULL)
     {
-        pbss_entry->pvht_cap = &pbss_entry->vht_cap_saved;
+        pbss_entry->pvht_cap = &pies->vht_cap_saved;
     }
     if (pbss_entry->pvht_oprat != NULL)
     {
-        pbss_entry->pvht_oprat = &pbss_entry->vht_oprat_saved;
+        pbss_entry->pvht_oprat = &pies->vht_oprat_saved;
     }
     if (pbss_entry->pvht_txpower != NULL)
     {
-        pbss_entry->pvht_txpower = &pbss_entry->vht_txpower_saved;
+        pbss_entry->pvht_txpower = &pies->vht_txpower_saved;
     }
     if (pbss_entry->ppoper_mode != NULL)
     {
-        pbss_entry->ppoper_mode = &pbss_entry->poper_mode_saved;
+        pbss_entry->ppoper_mode = &pies->poper_mode_saved;
     }
+#endif
     if (pbss_entry->pext_cap != NULL)
     {
-        pbss_entry->pext_cap = &pbss_entry->ext_cap_saved;
+        pbss_entry->pext_cap = &pies->ext_cap_saved;
     }
-#endif
     if (pbss_entry->pbss_co_2040 != NULL)
     {
-        pbss_entry->pbss_co_2040 = &pbss_entry->bss_co_2040_saved;
+        pbss_entry->pbss_co_2040 = &pies->bss_co_2040_saved;
     }
     if (pbss_entry->pwpa_ie != NULL)
     {
-        pbss_entry->pwpa_ie = (IEEEtypes_VendorSpecific_t *)(void *)pbss_entry->wpa_ie_buff;
+        pbss_entry->pwpa_ie = (IEEEtypes_VendorSpecific_t *)(void *)pies->wpa_ie_buff;
     }
     if (pbss_entry->prsn_ie != NULL)
     {
-        pbss_entry->prsn_ie = (IEEEtypes_Generic_t *)(void *)pbss_entry->rsn_ie_buff;
+        pbss_entry->prsn_ie = (IEEEtypes_Generic_t *)(void *)pies->rsn_ie_buff;
     }
     if (pbss_entry->prsnx_ie != NULL)
     {
-        pbss_entry->prsnx_ie = &pbss_entry->rsnx_ie_saved;
+        pbss_entry->prsnx_ie = &pies->rsnx_ie_saved;
+    }
+#if defined(CONFIG_11R) || defined(CONFIG_11K)
+    if (pbss_entry->pmd_ie != NULL)
+    {
+        pbss_entry->pmd_ie = (IEEEtypes_MobilityDomain_t *)(void *)pies->md_ie_buff;
+    }
+#endif
+#ifdef CONFIG_11K
+    if (pbss_entry->prm_cap != NULL)
+    {
+        pbss_entry->prm_cap = &pies->rm_cap_saved;
+    }
+    if (pbss_entry->pvendor_ie != NULL)
+    {
+        pbss_entry->pvendor_ie = pies->vendor_ie_buff;
+    }
+#endif
+    if (pbss_entry->pcountry_info != NULL)
+    {
+        pbss_entry->pcountry_info = &pies->country_info;
     }
+#endif
 #ifdef CONFIG_WPA_SUPP
     if (pbss_new_entry->ies != NULL)
     {
         pbss_entry->ies = pbss_new_entry->ies;
     }
 #endif
+
+    pmadapter->bss_store_cnt++;
+    pmadapter->bss_store_us += os_get_timestamp() - start_us;
 }
 
 /**
@@ -2793,7 +3166,7 @@ mlan_status wlan_ret_802_11_scan(IN mlan_private *pmpriv, IN HostCmd_DS_COMMAND
         (void)__memset(pmadapter, bss_new_entry, 0x00, sizeof(BSSDescriptor_t));
 
         /* Process the data fields and IEs returned for this BSS */
-        if (wlan_interpret_bss_desc_with_ie(pmadapter, bss_new_entry, &pbss_info, &bytes_left, MFALSE) ==
+        if (wlan_interpret_bss_desc_timed(pmadapter, bss_new_entry, &pbss_info, &bytes_left, MFALSE) ==
             MLAN_STATUS_SUCCESS)
         {
             wscan_d("SCAN_RESP: BSSID = %02x:%02x:%02x:%02x:%02x:%02x", bss_new_entry->mac_address[0],
@@ -2939,7 +3312,7 @@ mlan_status wlan_ret_802_11_scan(IN mlan_private *pmpriv, IN HostCmd_DS_COMMAND
 #endif
                         (void)__memcpy(pmadapter, &pmadapter->pscan_table[0], bss_new_entry,
                                        sizeof(pmadapter->pscan_table[0]));
-                        adjust_pointers_to_internal_buffers(&pmadapter->pscan_table[0], bss_new_entry);
+                        adjust_pointers_to_internal_buffers(pmadapter, &pmadapter->pscan_table[0], bss_new_entry);
                     }
 #ifdef CONFIG_WPA_SUPP
                     /* If the scan table is full, free ies of the new entry with lowest rssi, which won't be added into
@@ -2972,7 +3345,7 @@ mlan_status wlan_ret_802_11_scan(IN mlan_private *pmpriv, IN HostCmd_DS_COMMAND
 #endif
                     (void)__memcpy(pmadapter, &pmadapter->pscan_table[lowest_rssi_index], bss_new_entry,
                                    sizeof(pmadapter->pscan_table[lowest_rssi_index]));
-                    adjust_pointers_to_internal_buffers(&pmadapter->pscan_table[lowest_rssi_index], bss_new_entry);
+                    adjust_pointers_to_internal_buffers(pmadapter, &pmadapter->pscan_table[lowest_rssi_index], bss_new_entry);
                 }
 #ifdef CONFIG_WPA_SUPP
                 /* If the scan table is full, free ies of the new entry with lowest rssi, which won't be added into
@@ -3001,7 +3374,7 @@ mlan_status wlan_ret_802_11_scan(IN mlan_private *pmpriv, IN HostCmd_DS_COMMAND
                 /* Copy the locally created bss_new_entry to the scan table */
                 (void)__memcpy(pmadapter, &pmadapter->pscan_table[bss_idx], bss_new_entry,
                                sizeof(pmadapter->pscan_table[bss_idx]));
-                adjust_pointers_to_internal_buffers(&pmadapter->pscan_table[bss_idx], bss_new_entry);
+                adjust_pointers_to_internal_buffers(pmadapter, &pmadapter->pscan_table[bss_idx], bss_new_entry);
             }
         }
         else
@@ -3182,6 +3555,7 @@ static mlan_status wlan_parse_ext_scan_result(IN mlan_private *pmpriv,
     mlan_adapter *pmadapter        = pmpriv->adapter;
     mlan_callbacks *pcb            = MNULL;
     BSSDescriptor_t *bss_new_entry = MNULL;
+    BSSDescriptor_t *bss_stage     = MNULL;
     t_u8 *pbss_info;
     t_u32 bytes_left;
     t_u32 bytes_left_for_tlv;
@@ -3222,15 +3596,6 @@ static mlan_status wlan_parse_ext_scan_result(IN mlan_private *pmpriv,
      *    driver scan table either as an update to an existing entry
      *    or as an addition at the end of the table
      */
-    ret = pcb->moal_malloc(pmadapter->pmoal_handle, sizeof(BSSDescriptor_t), MLAN_MEM_DEF, (t_u8 **)&bss_new_entry);
-
-    if (ret != MLAN_STATUS_SUCCESS || !bss_new_entry)
-    {
-        PRINTM(MERROR, "Memory allocation for bss_new_entry failed!\n");
-        ret = MLAN_STATUS_FAILURE;
-        goto done;
-    }
-
     for (idx = 0; idx < number_of_sets && bytes_left > sizeof(MrvlIEtypesHeader_t); idx++)
     {
         tlv_type = wlan_le16_to_cpu(ptlv->header.type);
@@ -3298,11 +3663,45 @@ static mlan_status wlan_parse_ext_scan_result(IN mlan_private *pmpriv,
         pbss_info += sizeof(t_u16);
         bytes_left -= sizeof(t_u16);
 
+        /*
+         * Parse straight into the next free scan table slot so that a new
+         *   BSS is stored without a staging copy. The slot only becomes
+         *   part of the table once num_in_table is incremented. A staging
+         *   descriptor is needed only when the table is already full.
+         */
+        if (num_in_table < MRVDRV_MAX_BSSID_LIST)
+        {
+            bss_new_entry = &pmadapter->pscan_table[num_in_table];
+#ifdef CONFIG_WPA_SUPP
+            if (bss_new_entry->ies != NULL)
+            {
+                os_mem_free(bss_new_entry->ies);
+                bss_new_entry->ies = NULL;
+            }
+#endif
+        }
+        else
+        {
+            if (bss_stage == MNULL)
+            {
+                ret = pcb->moal_malloc(pmadapter->pmoal_handle, sizeof(BSSDescriptor_t), MLAN_MEM_DEF,
+                                       (t_u8 **)&bss_stage);
+                if (ret != MLAN_STATUS_SUCCESS || !bss_stage)
+                {
+                    PRINTM(MERROR, "Memory allocation for bss_new_entry failed!\n");
+                    bss_stage = MNULL;
+                    ret       = MLAN_STATUS_FAILURE;
+                    break;
+                }
+            }
+            bss_new_entry = bss_stage;
+        }
+
         /* Zero out the bss_new_entry we are about to store info in */
         (void)__memset(pmadapter, bss_new_entry, 0x00, sizeof(BSSDescriptor_t));
 
         /* Process the data fields and IEs returned for this BSS */
-        if (wlan_interpret_bss_desc_with_ie(pmadapter, bss_new_entry, &pbss_info, &bytes_left, MTRUE) ==
+        if (wlan_interpret_bss_desc_timed(pmadapter, bss_new_entry, &pbss_info, &bytes_left, MTRUE) ==
             MLAN_STATUS_SUCCESS)
         {
             PRINTM(MINFO, "EXT_SCAN: BSSID = %02x:%02x:%02x:%02x:%02x:%02x\n", bss_new_entry->mac_address[0],
@@ -3439,7 +3838,7 @@ static mlan_status wlan_parse_ext_scan_result(IN mlan_private *pmpriv,
 #endif
                     (void)__memcpy(pmadapter, &pmadapter->pscan_table[lowest_rssi_index], bss_new_entry,
                                    sizeof(pmadapter->pscan_table[lowest_rssi_index]));
-                    adjust_pointers_to_internal_buffers(&pmadapter->pscan_table[lowest_rssi_index], bss_new_entry);
+                    adjust_pointers_to_internal_buffers(pmadapter, &pmadapter->pscan_table[lowest_rssi_index], bss_new_entry);
                 }
 #ifdef CONFIG_WPA_SUPP
                 /* If the scan table is full, free ies of the new entry with lowest rssi, which won't be added into
@@ -3454,9 +3853,9 @@ static mlan_status wlan_parse_ext_scan_result(IN mlan_private *pmpriv,
                 }
 #endif
             }
-            else
+            else if (bss_new_entry != &pmadapter->pscan_table[bss_idx])
             {
-                /* Copy the locally created bss_new_entry to the scan table */
+                /* Duplicate: move the new entry over the existing one */
 #ifdef CONFIG_WPA_SUPP
                 if (pmadapter->pscan_table[bss_idx].ies != NULL)
                 {
@@ -3466,7 +3865,15 @@ static mlan_status wlan_parse_ext_scan_result(IN mlan_private *pmpriv,
 #endif
                 (void)__memcpy(pmadapter, &pmadapter->pscan_table[bss_idx], bss_new_entry,
                                sizeof(pmadapter->pscan_table[bss_idx]));
-                adjust_pointers_to_internal_buffers(&pmadapter->pscan_table[bss_idx], bss_new_entry);
+                adjust_pointers_to_internal_buffers(pmadapter, &pmadapter->pscan_table[bss_idx], bss_new_entry);
+#ifdef CONFIG_WPA_SUPP
+                /* The ies are now owned by the table entry */
+                bss_new_entry->ies = NULL;
+#endif
+            }
+            else
+            {
+                /* New entry was parsed in place, nothing to copy */
             }
         }
         else
@@ -3490,9 +3897,9 @@ static mlan_status wlan_parse_ext_scan_result(IN mlan_private *pmpriv,
     pmadapter->num_in_scan_table = num_in_table;
     /* fixme: the following code does not seem relevant */
 done:
-    if (bss_new_entry)
+    if (bss_stage)
     {
-        pcb->moal_mfree(pmadapter->pmoal_handle, (t_u8 *)bss_new_entry);
+        pcb->moal_mfree(pmadapter->pmoal_handle, (t_u8 *)bss_stage);
     }
 
     LEAVE();
@@ -252,6 +252,7 @@ t_void wlan_wmm_init(pmlan_adapter pmadapter)
             }
             priv->add_ba_param.tx_amsdu = MTRUE;
             priv->add_ba_param.rx_amsdu = MTRUE;
+            priv->wmm.drv_pkt_delay_max = WMM_DRV_DELAY_MAX;
             (void)__memset(priv->adapter, priv->rx_seq, 0xff, sizeof(priv->rx_seq));
             wlan_wmm_default_queue_priorities(priv);
         }
@@ -514,16 +515,29 @@ void wifi_wmm_da_to_ra(uint8_t *da, uint8_t *ra)
 
 /*
  *  check ra tx_pause status
+ *  0. channel switch: hold up to WMM_CHAN_SWITCH_MAX_PKTS per interface
  *  1. STA mode: check priv->tx_pause
  *  2. UAP mode:
  *      a. broadcast/multicast ra: check in ralists
  *      b. unicast ra: check in ampdu_stat_array for quick access
  */
-static uint8_t wifi_wmm_is_tx_pause(const uint8_t interface, mlan_wmm_ac_e queue, uint8_t *ra)
+static uint8_t wifi_wmm_is_tx_pause(
+    const uint8_t interface, mlan_wmm_ac_e queue, uint8_t *ra, t_u16 *held, t_u16 *max_held)
 {
     t_u8 is_tx_pause   = MFALSE;
     raListTbl *ra_list = MNULL;
 
+    /* interface wide pause holds nothing */
+    *held     = WMM_PAUSED_RA_MAX_PKTS;
+    *max_held = WMM_PAUSED_RA_MAX_PKTS;
+
+    if (mlan_adap->priv[interface]->chan_sw.active == MTRUE)
+    {
+        *held     = mlan_adap->priv[interface]->chan_sw.held;
+        *max_held = WMM_CHAN_SWITCH_MAX_PKTS;
+        return MTRUE;
+    }
+
     if (interface == MLAN_BSS_TYPE_STA)
     {
         is_tx_pause = mlan_adap->priv[0]->tx_pause;
@@ -541,7 +555,10 @@ static uint8_t wifi_wmm_is_tx_pause(const uint8_t interface, mlan_wmm_ac_e queue
 
             ra_list = wlan_wmm_get_ralist_node(mlan_adap->priv[interface], queue, ra);
             if (ra_list != MNULL)
+            {
                 is_tx_pause = ra_list->tx_pause;
+                *held       = ra_list->total_pkts;
+            }
 
             mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle,
                                                     &mlan_adap->priv[interface]->wmm.tid_tbl_ptr[queue].ra_list.plock);
@@ -637,6 +654,62 @@ SUCC:
     return buf;
 }
 
+t_u32 wifi_wmm_bss_queued(pmlan_private priv)
+{
+    t_u32 queued = 0;
+    int ac;
+
+    for (ac = 0; ac < MAX_AC_QUEUES; ac++)
+        queued += priv->wmm.pkts_queued[ac];
+
+    return queued;
+}
+
+/* free buffers of both tiers */
+static t_u32 wifi_wmm_buf_free(void)
+{
+    return (t_u32)(mlan_adap->outbuf_pool.free_cnt + mlan_adap->outbuf_pool.ext_free_cnt);
+}
+
+/*
+ *  When free buffers run low, an interface holding at least its weighted
+ *  share of the pool gets no more of them while another interface is
+ *  connected, so that a busy BSS cannot starve the others. It may still
+ *  replace its own queued frames. The pool here is both tiers, internal
+ *  and external, as wifi_wmm_buf_get() hands out from either.
+ */
+static t_u8 wifi_wmm_bss_over_share(const uint8_t interface)
+{
+    pmlan_private priv = mlan_adap->priv[interface];
+    t_u32 pool_total   = MAX_WMM_BUF_NUM + (t_u32)mlan_adap->outbuf_pool.ext_total;
+    t_u32 total_weight = 0;
+    t_u32 share;
+    t_u8 others        = MFALSE;
+    t_u8 i;
+
+    if (wifi_wmm_buf_free() >= (pool_total / WMM_BSS_SHARE_FREE_LOW_DIV))
+        return MFALSE;
+
+    for (i = 0; i < MLAN_MAX_BSS_NUM; i++)
+    {
+        if (i == interface)
+            continue;
+        if (mlan_adap->priv[i]->media_connected == MTRUE)
+        {
+            total_weight += mlan_adap->priv[i]->tx_weight;
+            others = MTRUE;
+        }
+    }
+
+    if (others == MFALSE)
+        return MFALSE;
+
+    total_weight += priv->tx_weight;
+    share = (pool_total * (t_u32)priv->tx_weight) / total_weight;
+
+    return (wifi_wmm_bss_queued(priv) >= share) ? MTRUE : MFALSE;
+}
+
 /* wmm enhance get free buffer */
 uint8_t *wifi_wmm_get_outbuf_enh(
     uint32_t *outbuf_len, mlan_wmm_ac_e queue, const uint8_t interface, uint8_t *ra, bool *is_tx_pause)
@@ -644,20 +717,52 @@ uint8_t *wifi_wmm_get_outbuf_enh(
     t_u8 i;
     outbuf_t *buf = MNULL;
     t_u8 tx_pause;
+    t_u16 held;
+    t_u16 max_held;
+    chan_switch_t *chan_sw = &mlan_adap->priv[interface]->chan_sw;
+    unsigned long sta;
 
     /* check tx_pause */
-    tx_pause     = wifi_wmm_is_tx_pause(interface, queue, ra);
-    *is_tx_pause = (tx_pause == MTRUE) ? true : false;
+    tx_pause     = wifi_wmm_is_tx_pause(interface, queue, ra, &held, &max_held);
+    *is_tx_pause = false;
 
     if (tx_pause == MTRUE)
     {
-        *outbuf_len = 0;
+        /*
+         * A paused peer (e.g. uAP client in power save) may keep a few
+         * frames queued for release on resume, but only from the free
+         * pool so that it never takes buffers from awake peers.
+         * A channel switch holds the whole interface the same way.
+         */
+        if (held < max_held)
+        {
+            buf = wifi_wmm_buf_get();
+            if (buf != MNULL)
+            {
+                sta = os_enter_critical_section();
+                if (chan_sw->active == MTRUE)
+                    chan_sw->held++;
+                os_exit_critical_section(sta);
+                goto SUCC;
+            }
+        }
+
+        sta = os_enter_critical_section();
+        if (chan_sw->active == MTRUE)
+            chan_sw->dropped++;
+        os_exit_critical_section(sta);
+
+        *is_tx_pause = true;
+        *outbuf_len  = 0;
         return MNULL;
     }
 
-    buf = wifi_wmm_buf_get();
-    if (buf != MNULL)
-        goto SUCC;
+    if (wifi_wmm_bss_over_share(interface) == MFALSE)
+    {
+        buf = wifi_wmm_buf_get();
+        if (buf != MNULL)
+            goto SUCC;
+    }
 
     /* loop tid_tbl to find buf to replace in wmm ralists */
     for (i = 0; i < MAX_AC_QUEUES; i++)
@@ -667,6 +772,10 @@ uint8_t *wifi_wmm_get_outbuf_enh(
             goto SUCC;
     }
 
+    /* refused for its share, not for an empty pool */
+    if (wifi_wmm_buf_free() != 0U)
+        mlan_adap->priv[interface]->tx_share_drop++;
+
     *outbuf_len = 0;
     return MNULL;
 SUCC:
@@ -717,6 +826,8 @@ int wlan_wmm_add_buf_txqueue_enh(const uint8_t interface, const uint8_t *buffer,
     /* refer to low_level_output payload memcpy */
     wifi_wmm_da_to_ra(&((outbuf_t *)buffer)->data[0], ra);
 
+    ((outbuf_t *)buffer)->enqueue_ts = os_get_timestamp();
+
     mlan_adap->callbacks.moal_semaphore_get(mlan_adap->pmoal_handle, &priv->wmm.tid_tbl_ptr[pkt_prio].ra_list.plock);
 
     ralist = wlan_wmm_get_queue_raptr_enh(priv, pkt_prio, ra);
@@ -734,6 +845,8 @@ int wlan_wmm_add_buf_txqueue_enh(const uint8_t interface, const uint8_t *buffer,
     util_enqueue_list_tail(mlan_adap->pmoal_handle, &ralist->buf_head, (mlan_linked_list *)buffer, MNULL, MNULL);
     ralist->total_pkts++;
     priv->wmm.pkts_queued[pkt_prio]++;
+    if (ralist->tx_pause == MTRUE)
+        ralist->held_count++;
 
     mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &ralist->buf_head.plock);
 
@@ -743,39 +856,119 @@ int wlan_wmm_add_buf_txqueue_enh(const uint8_t interface, const uint8_t *buffer,
 }
 
 /* wmm enhance buffer pool management */
-/* return NULL if wmm free list is empty */
-outbuf_t *wifi_wmm_buf_get(void)
+static inline t_u8 wifi_wmm_buf_is_ext(const outbuf_t *buf)
 {
-    outbuf_t *buf = MNULL;
+    return ((const t_u8 *)buf >= mlan_adap->outbuf_pool.ext_start &&
+            (const t_u8 *)buf < mlan_adap->outbuf_pool.ext_end) ?
+               MTRUE :
+               MFALSE;
+}
 
-    mlan_adap->callbacks.moal_semaphore_get(mlan_adap->pmoal_handle, &mlan_adap->outbuf_pool.free_list.plock);
+/*
+ *  take a buffer from internal RAM, or from the external region
+ *  when internal RAM is exhausted and use_ext is set
+ */
+static outbuf_t *wifi_wmm_buf_get_tier(t_u8 use_ext)
+{
+    outbuf_pool_t *pool = &mlan_adap->outbuf_pool;
+    outbuf_t *buf       = MNULL;
+    int used;
+
+    mlan_adap->callbacks.moal_semaphore_get(mlan_adap->pmoal_handle, &pool->free_list.plock);
 
-    assert(mlan_adap->outbuf_pool.free_cnt >= 0);
+    assert(pool->free_cnt >= 0);
 
-    if (mlan_adap->outbuf_pool.free_cnt == 0)
+    if (pool->free_cnt != 0)
     {
-        mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &mlan_adap->outbuf_pool.free_list.plock);
-        return MNULL;
-    }
+        buf = (outbuf_t *)util_dequeue_list(mlan_adap->pmoal_handle, &pool->free_list, MNULL, MNULL);
+        assert(buf != MNULL);
+        pool->free_cnt--;
 
-    buf = (outbuf_t *)util_dequeue_list(mlan_adap->pmoal_handle, &mlan_adap->outbuf_pool.free_list, MNULL, MNULL);
-    assert(buf != MNULL);
-    mlan_adap->outbuf_pool.free_cnt--;
+        used = MAX_WMM_BUF_NUM - pool->free_cnt;
+        if (used > pool->peak_cnt)
+            pool->peak_cnt = used;
+    }
+    else if (use_ext == MTRUE && pool->ext_free_cnt != 0)
+    {
+        buf = (outbuf_t *)util_dequeue_list(mlan_adap->pmoal_handle, &pool->ext_free_list, MNULL, MNULL);
+        assert(buf != MNULL);
+        pool->ext_free_cnt--;
+        pool->ext_queued++;
+
+        used = pool->ext_total - pool->ext_free_cnt;
+        if (used > pool->ext_peak_cnt)
+            pool->ext_peak_cnt = used;
+    }
+    else
+    {
+        /* Do Nothing */
+    }
 
-    mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &mlan_adap->outbuf_pool.free_list.plock);
+    mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &pool->free_list.plock);
     return buf;
 }
 
+/* return NULL if both internal and external free lists are empty */
+outbuf_t *wifi_wmm_buf_get(void)
+{
+    return wifi_wmm_buf_get_tier(MTRUE);
+}
+
 void wifi_wmm_buf_put(outbuf_t *buf)
 {
-    mlan_adap->callbacks.moal_semaphore_get(mlan_adap->pmoal_handle, &mlan_adap->outbuf_pool.free_list.plock);
+    outbuf_pool_t *pool = &mlan_adap->outbuf_pool;
 
-    assert(mlan_adap->outbuf_pool.free_cnt < MAX_WMM_BUF_NUM);
+    mlan_adap->callbacks.moal_semaphore_get(mlan_adap->pmoal_handle, &pool->free_list.plock);
 
-    util_enqueue_list_tail(mlan_adap->pmoal_handle, &mlan_adap->outbuf_pool.free_list, &buf->entry, MNULL, MNULL);
-    mlan_adap->outbuf_pool.free_cnt++;
+    if (wifi_wmm_buf_is_ext(buf) == MTRUE)
+    {
+        assert(pool->ext_free_cnt < pool->ext_total);
 
-    mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &mlan_adap->outbuf_pool.free_list.plock);
+        util_enqueue_list_tail(mlan_adap->pmoal_handle, &pool->ext_free_list, &buf->entry, MNULL, MNULL);
+        pool->ext_free_cnt++;
+    }
+    else
+    {
+        assert(pool->free_cnt < MAX_WMM_BUF_NUM);
+
+        util_enqueue_list_tail(mlan_adap->pmoal_handle, &pool->free_list, &buf->entry, MNULL, MNULL);
+        pool->free_cnt++;
+    }
+
+    mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &pool->free_list.plock);
+}
+
+/*
+ *  move a buffer taken from a ralist out of the external region,
+ *  copied: MTRUE when the caller copies the frame into internal RAM
+ *          itself, only account for it then
+ *  return the buffer to transmit from
+ */
+outbuf_t *wifi_wmm_buf_promote(outbuf_t *buf, t_u8 copied)
+{
+    outbuf_t *hot = MNULL;
+
+    if (wifi_wmm_buf_is_ext(buf) == MFALSE)
+        return buf;
+
+    if (copied == MTRUE)
+    {
+        mlan_adap->outbuf_pool.promoted++;
+        return buf;
+    }
+
+    /* no internal buffer free, transmit from the external region */
+    hot = wifi_wmm_buf_get_tier(MFALSE);
+    if (hot == MNULL)
+        return buf;
+
+    (void)__memcpy(mlan_adap, &hot->intf_header[0], &buf->intf_header[0],
+                   INTF_HEADER_LEN + sizeof(TxPD) + buf->tx_pd.tx_pkt_length);
+    hot->enqueue_ts = buf->enqueue_ts;
+    wifi_wmm_buf_put(buf);
+
+    mlan_adap->outbuf_pool.promoted++;
+    return hot;
 }
 
 /* init free list, insert all buffers to free list */
@@ -787,6 +980,7 @@ int wifi_wmm_buf_pool_init(uint8_t *pool)
     __memset(mlan_adap, &mlan_adap->outbuf_pool, 0x00, sizeof(outbuf_pool_t));
 
     util_init_list_head(mlan_adap->pmoal_handle, &mlan_adap->outbuf_pool.free_list, MFALSE, MNULL);
+    util_init_list_head(mlan_adap->pmoal_handle, &mlan_adap->outbuf_pool.ext_free_list, MFALSE, MNULL);
 
     if (mlan_adap->callbacks.moal_init_semaphore(mlan_adap->pmoal_handle, "wmm_buf_pool_sem",
                                                  &mlan_adap->outbuf_pool.free_list.plock) != MLAN_STATUS_SUCCESS)
@@ -805,14 +999,62 @@ int wifi_wmm_buf_pool_init(uint8_t *pool)
     return WM_SUCCESS;
 }
 
+/*
+ *  carve buffers out of an external RAM region and add them to the
+ *  external free list, only one region is supported
+ */
+int wifi_wmm_buf_pool_add_ext(uint8_t *region, uint32_t len)
+{
+    outbuf_pool_t *pool = &mlan_adap->outbuf_pool;
+    outbuf_t *buf       = MNULL;
+    t_u8 *start         = MNULL;
+    t_u32 pad;
+    t_u32 num;
+    t_u32 i;
+
+    if (region == MNULL)
+        return -WM_E_INVAL;
+
+    pad   = OFFSET_ALIGN_ADDR(region, DMA_ALIGNMENT);
+    start = region + pad;
+    num   = (len > pad) ? ((len - pad) / OUTBUF_WMM_LEN) : 0U;
+    if (num == 0U)
+        return -WM_E_INVAL;
+
+    mlan_adap->callbacks.moal_semaphore_get(mlan_adap->pmoal_handle, &pool->free_list.plock);
+
+    if (pool->ext_total != 0)
+    {
+        mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &pool->free_list.plock);
+        return -WM_FAIL;
+    }
+
+    for (i = 0; i < num; i++)
+    {
+        buf = (outbuf_t *)(start + (i * OUTBUF_WMM_LEN));
+        util_init_list(&buf->entry);
+        util_enqueue_list_tail(mlan_adap->pmoal_handle, &pool->ext_free_list, &buf->entry, MNULL, MNULL);
+    }
+    pool->ext_start    = start;
+    pool->ext_end      = start + (num * OUTBUF_WMM_LEN);
+    pool->ext_total    = (int)num;
+    pool->ext_free_cnt = (int)num;
+
+    mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &pool->free_list.plock);
+
+    return WM_SUCCESS;
+}
+
 /* deinit free list, should be called after all buffers are put back */
 void wifi_wmm_buf_pool_deinit(void)
 {
-    mlan_adap->outbuf_pool.free_cnt = 0;
+    mlan_adap->outbuf_pool.free_cnt     = 0;
+    mlan_adap->outbuf_pool.ext_free_cnt = 0;
 
     mlan_adap->callbacks.moal_free_semaphore(mlan_adap->pmoal_handle, &mlan_adap->outbuf_pool.free_list.plock);
 
     util_free_list_head(mlan_adap->pmoal_handle, &mlan_adap->outbuf_pool.free_list, MNULL);
+    util_free_list_head(mlan_adap->pmoal_handle, &mlan_adap->outbuf_pool.ext_free_list, MNULL);
 
     __memset(mlan_adap, &mlan_adap->outbuf_pool, 0x00, sizeof(outbuf_pool_t));
 }
@@ -871,9 +1113,13 @@ static raListTbl *wlan_ralist_alloc_enh(pmlan_adapter pmadapter, t_u8 *ra)
 
     (void)__memcpy(pmadapter, ra_list->ra, ra, MLAN_MAC_ADDR_LENGTH);
 
-    ra_list->total_pkts = 0;
-    ra_list->tx_pause   = 0;
-    ra_list->drop_count = 0;
+    ra_list->total_pkts  = 0;
+    ra_list->tx_pause    = 0;
+    ra_list->drop_count  = 0;
+    ra_list->pause_start = 0;
+    ra_list->pause_time  = 0;
+    ra_list->held_count  = 0;
+    wlan_aggr_tune_reset(ra_list);
 
     wifi_d("RAList: Allocating buffers for TID %p\n", ra_list);
 
@@ -936,9 +1182,10 @@ int wlan_ralist_update_enh(mlan_private *priv, t_u8 *old_ra, t_u8 *new_ra)
         update_count++;
 
         wlan_ralist_pkts_free_enh(priv, ra_list, i);
-        ra_list->tx_pause = MFALSE;
+        wlan_ralist_set_tx_pause(ra_list, MFALSE);
 
         (void)__memcpy(priv->adapter, ra_list->ra, new_ra, MLAN_MAC_ADDR_LENGTH);
+        wlan_aggr_tune_reset(ra_list);
 
 #ifdef CONFIG_WMM_DEBUG
         hist_ra_list = wlan_ralist_alloc_enh(priv->adapter, old_ra);
@@ -1037,44 +1284,286 @@ void wlan_ralist_deinit_enh(mlan_private *priv)
     }
 }
 
+/*
+ *  update ralist tx_pause status and account pause time,
+ *  should be called inside wmm tid_tbl_ptr ra_list lock
+ */
+void wlan_ralist_set_tx_pause(raListTbl *ra_list, t_u8 tx_pause)
+{
+    t_u32 now = os_ticks_to_msec(os_ticks_get());
+
+    if (tx_pause == MTRUE && ra_list->tx_pause == MFALSE)
+        ra_list->pause_start = now;
+    else if (tx_pause == MFALSE && ra_list->tx_pause == MTRUE)
+        ra_list->pause_time += now - ra_list->pause_start;
+
+    ra_list->tx_pause = tx_pause;
+}
+
 /* debug statistics */
 void wifi_wmm_drop_err_mem(const uint8_t interface)
 {
-    if (interface == MLAN_BSS_TYPE_STA)
-        mlan_adap->priv[0]->driver_error_cnt.tx_err_mem++;
-    else if (interface == MLAN_BSS_TYPE_UAP)
-        mlan_adap->priv[1]->driver_error_cnt.tx_err_mem++;
+    wifi_stats_inc(WIFI_STAT_BSS(interface, WIFI_STAT_TX_ERR_MEM));
 }
 
 void wifi_wmm_drop_no_media(const uint8_t interface)
 {
-    if (interface == MLAN_BSS_TYPE_STA)
-        mlan_adap->priv[0]->driver_error_cnt.tx_no_media++;
-    else if (interface == MLAN_BSS_TYPE_UAP)
-        mlan_adap->priv[1]->driver_error_cnt.tx_no_media++;
+    wifi_stats_inc(WIFI_STAT_BSS(interface, WIFI_STAT_TX_NO_MEDIA));
 }
 
 void wifi_wmm_drop_retried_drop(const uint8_t interface)
 {
-    if (interface == MLAN_BSS_TYPE_STA)
-        mlan_adap->priv[0]->driver_error_cnt.tx_wmm_retried_drop++;
-    else if (interface == MLAN_BSS_TYPE_UAP)
-        mlan_adap->priv[1]->driver_error_cnt.tx_wmm_retried_drop++;
+    wifi_stats_inc(WIFI_STAT_BSS(interface, WIFI_STAT_TX_WMM_RETRIED_DROP));
 }
 
 void wifi_wmm_drop_pause_drop(const uint8_t interface)
 {
-    if (interface == MLAN_BSS_TYPE_STA)
-        mlan_adap->priv[0]->driver_error_cnt.tx_wmm_pause_drop++;
-    else if (interface == MLAN_BSS_TYPE_UAP)
-        mlan_adap->priv[1]->driver_error_cnt.tx_wmm_pause_drop++;
+    wifi_stats_inc(WIFI_STAT_BSS(interface, WIFI_STAT_TX_WMM_PAUSE_DROP));
 }
 
 void wifi_wmm_drop_pause_replaced(const uint8_t interface)
 {
+    wifi_stats_inc(WIFI_STAT_BSS(interface, WIFI_STAT_TX_WMM_PAUSE_REPLACED));
+}
+
+void wifi_wmm_drop_expired(const uint8_t interface)
+{
+    wifi_stats_inc(WIFI_STAT_BSS(interface, WIFI_STAT_TX_WMM_EXPIRED_DROP));
+}
+
+/**
+ *  @brief Compute the time a buffer spent in the host ra list
+ *
+ *  Queue delay is passed to firmware as a uint8 in units of 2ms, so the
+ *  max value is 510ms; larger delays are clamped to drv_pkt_delay_max.
+ *
+ *  @param priv     Pointer to the mlan_private driver data struct
+ *  @param buf      Pointer to the enqueued buffer
+ *
+ *  @return         Queue delay in units of 2ms
+ */
+t_u8 wlan_wmm_compute_driver_packet_delay(pmlan_private priv, const outbuf_t *buf)
+{
+    t_u32 queue_delay = (os_get_timestamp() - buf->enqueue_ts) / 1000U;
+
+    return (t_u8)(MIN(queue_delay, priv->wmm.drv_pkt_delay_max) >> 1);
+}
+
+/**
+ *  @brief Check if a buffer waited longer than the expiry configured
+ *         for its user priority
+ *
+ *  @param priv     Pointer to the mlan_private driver data struct
+ *  @param buf      Pointer to the enqueued buffer
+ *
+ *  @return         MTRUE if the buffer should be dropped, otherwise MFALSE
+ */
+t_u8 wlan_wmm_is_pkt_expired(pmlan_private priv, const outbuf_t *buf)
+{
+    t_u8 up = buf->tx_pd.priority;
+
+    if (up > WMM_HIGHEST_PRIORITY || priv->wmm.user_pri_pkt_expiry[up] == 0U)
+        return MFALSE;
+
+    return ((os_get_timestamp() - buf->enqueue_ts) / 1000U > priv->wmm.user_pri_pkt_expiry[up]) ? MTRUE : MFALSE;
+}
+
+static void wlan_aggr_tune_new_window(raListTbl *ra_list, t_u32 now)
+{
+    aggr_tune_t *tune = &ra_list->aggr_tune;
+
+    tune->win_start = now;
+    tune->win_pkts  = 0;
+    tune->win_small = 0;
+    tune->win_depth = 0;
+    tune->win_bytes = 0;
+    tune->win_drops = ra_list->drop_count;
+}
+
+/**
+ *  @brief Reset the TX aggregation tuner of an RA list
+ *
+ *  A new peer starts in latency mode and has to prove sustained bulk
+ *  traffic before aggregation is ramped up.
+ *
+ *  @param ra_list  A pointer to the RA list
+ *
+ *  @return         N/A
+ */
+void wlan_aggr_tune_reset(raListTbl *ra_list)
+{
+    aggr_tune_t *tune = &ra_list->aggr_tune;
+
+    (void)__memset(mlan_adap, tune, 0x00, sizeof(aggr_tune_t));
+    tune->mode        = AGGR_TUNE_MODE_LATENCY;
+    tune->amsdu_limit = AGGR_TUNE_AMSDU_MAX;
+
+    wlan_aggr_tune_new_window(ra_list, os_ticks_to_msec(os_ticks_get()));
+}
+
+/**
+ *  @brief Close an observation window and update the tuner decisions
+ *
+ *  A window votes for the other mode only when it is clearly on the other
+ *  side of a hysteresis band, and the mode flips after
+ *  AGGR_TUNE_HYSTERESIS consecutive votes. In bulk mode drops halve the
+ *  A-MSDU size limit and clean busy windows double it again.
+ *
+ *  @param ra_list  A pointer to the RA list
+ *  @param elapsed  Window length in msec
+ *
+ *  @return         N/A
+ */
+static void wlan_aggr_tune_eval(raListTbl *ra_list, t_u32 elapsed)
+{
+    aggr_tune_t *tune = &ra_list->aggr_tune;
+    t_u32 depth       = tune->win_depth / tune->win_pkts;
+    t_u32 small_pct   = (t_u32)tune->win_small * 100U / tune->win_pkts;
+    t_u16 drops       = (t_u16)(ra_list->drop_count - tune->win_drops);
+    t_u8 vote;
+
+    tune->tput_kbps      = tune->win_bytes * 8U / elapsed;
+    tune->last_depth     = (t_u8)MIN(depth, 0xFFU);
+    tune->last_small_pct = (t_u8)small_pct;
+
+    if (tune->mode == AGGR_TUNE_MODE_LATENCY)
+    {
+        vote = MFALSE;
+        if (tune->win_pkts >= AGGR_TUNE_BULK_MIN_PKTS && depth >= AGGR_TUNE_BULK_DEPTH &&
+            small_pct <= AGGR_TUNE_BULK_SMALL_PCT)
+            vote = MTRUE;
+    }
+    else
+    {
+        vote = (depth < AGGR_TUNE_LATENCY_DEPTH || small_pct >= AGGR_TUNE_LATENCY_SMALL_PCT) ? MTRUE : MFALSE;
+
+        if (drops != 0U)
+        {
+            tune->amsdu_limit = MAX(tune->amsdu_limit / 2U, AGGR_TUNE_AMSDU_MIN);
+        }
+        else if (depth >= AGGR_TUNE_BULK_DEPTH)
+        {
+            tune->amsdu_limit = MIN(tune->amsdu_limit * 2U, AGGR_TUNE_AMSDU_MAX);
+        }
+        else
+        { /* Do Nothing */
+        }
+    }
+
+    tune->votes = (vote == MTRUE) ? (tune->votes + 1U) : 0U;
+    if (tune->votes >= AGGR_TUNE_HYSTERESIS)
+    {
+        tune->mode        = (tune->mode == AGGR_TUNE_MODE_LATENCY) ? AGGR_TUNE_MODE_BULK : AGGR_TUNE_MODE_LATENCY;
+        tune->votes       = 0;
+        tune->amsdu_limit = AGGR_TUNE_AMSDU_MAX;
+        tune->switches++;
+    }
+}
+
+/**
+ *  @brief Account one dequeued packet in the TX aggregation tuner
+ *
+ *  Should be called from the TX scheduler with the RA list lock held.
+ *
+ *  @param ra_list  A pointer to the RA list
+ *  @param pkt_len  Length of the dequeued packet
+ *
+ *  @return         N/A
+ */
+void wlan_aggr_tune_sample(raListTbl *ra_list, t_u16 pkt_len)
+{
+    aggr_tune_t *tune = &ra_list->aggr_tune;
+    t_u32 now;
+    t_u32 elapsed;
+
+    if (mlan_adap->aggr_tune_enable == MFALSE)
+        return;
+
+    tune->win_pkts++;
+    tune->win_bytes += pkt_len;
+    /* queue depth including the packet just dequeued */
+    tune->win_depth += (t_u32)ra_list->total_pkts + 1U;
+    if (pkt_len <= AGGR_TUNE_SMALL_PKT_LEN)
+        tune->win_small++;
+
+    now     = os_ticks_to_msec(os_ticks_get());
+    elapsed = now - tune->win_start;
+    if (elapsed < AGGR_TUNE_WIN_MS && tune->win_pkts < 0xFFFFU)
+        return;
+
+    wlan_aggr_tune_eval(ra_list, MAX(elapsed, 1U));
+    wlan_aggr_tune_new_window(ra_list, now);
+}
+
+/**
+ *  @brief Check if the tuner lets the scheduler build A-MSDUs
+ *
+ *  @param ra_list  A pointer to the RA list
+ *
+ *  @return         MTRUE or MFALSE
+ */
+t_u8 wlan_aggr_tune_amsdu_allowed(const raListTbl *ra_list)
+{
+    if (mlan_adap->aggr_tune_enable == MFALSE)
+        return MTRUE;
+
+    return (ra_list->aggr_tune.mode == AGGR_TUNE_MODE_BULK) ? MTRUE : MFALSE;
+}
+
+/**
+ *  @brief Get the A-MSDU size limit picked by the tuner
+ *
+ *  @param ra_list  A pointer to the RA list
+ *  @param max_size Size limit set by the peer and the TX buffer
+ *
+ *  @return         A-MSDU size limit
+ */
+t_u32 wlan_aggr_tune_amsdu_limit(const raListTbl *ra_list, t_u32 max_size)
+{
+    if (mlan_adap->aggr_tune_enable == MFALSE)
+        return max_size;
+
+    return MIN(max_size, ra_list->aggr_tune.amsdu_limit);
+}
+
+/**
+ *  @brief Check if the tuner lets a packet trigger BA setup
+ *
+ *  In latency mode sporadic traffic does not set up a BA stream until the
+ *  RA list has carried AGGR_TUNE_BA_MIN_PKTS packets in the current window.
+ *
+ *  @param interface    interface to indicate uap or STA
+ *  @param buffer       Enqueued outbuf_t
+ *  @param pkt_prio     AC queue of the packet
+ *
+ *  @return             MTRUE or MFALSE
+ */
+t_u8 wlan_aggr_tune_ba_allowed(const uint8_t interface, const uint8_t *buffer, uint8_t pkt_prio)
+{
+    mlan_private *priv            = MNULL;
+    t_u8 ra[MLAN_MAC_ADDR_LENGTH] = {0x0};
+    raListTbl *ralist             = MNULL;
+    t_u8 allowed                  = MTRUE;
+
+    if (mlan_adap->aggr_tune_enable == MFALSE)
+        return MTRUE;
+
     if (interface == MLAN_BSS_TYPE_STA)
-        mlan_adap->priv[0]->driver_error_cnt.tx_wmm_pause_replaced++;
-    else if (interface == MLAN_BSS_TYPE_UAP)
-        mlan_adap->priv[1]->driver_error_cnt.tx_wmm_pause_replaced++;
+        priv = mlan_adap->priv[0];
+    else
+        priv = mlan_adap->priv[1];
+
+    wifi_wmm_da_to_ra(&((outbuf_t *)buffer)->data[0], ra);
+
+    mlan_adap->callbacks.moal_semaphore_get(mlan_adap->pmoal_handle, &priv->wmm.tid_tbl_ptr[pkt_prio].ra_list.plock);
+
+    ralist = wlan_wmm_get_ralist_node(priv, pkt_prio, ra);
+    if (ralist != MNULL && ralist->aggr_tune.mode == AGGR_TUNE_MODE_LATENCY &&
+        ralist->aggr_tune.win_pkts < AGGR_TUNE_BA_MIN_PKTS)
+        allowed = MFALSE;
+
+    mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &priv->wmm.tid_tbl_ptr[pkt_prio].ra_list.plock);
+
+    return allowed;
 }
 #endif /* CONFIG_WMM */
@@ -19,7 +19,11 @@
 #include "sdmmc_config.h"
 
 /*! @brief Data block count accessed in card */
+#if (MLAN_MAX_DATA_FRAME_LEN > 2048U)
+#define DATA_BLOCK_COUNT (5U)
+#else
 #define DATA_BLOCK_COUNT (4U)
+#endif
 /*! @brief Data buffer size. */
 #define DATA_BUFFER_SIZE (FSL_SDMMC_DEFAULT_BLOCK_SIZE * DATA_BLOCK_COUNT)
 
@@ -58,13 +58,18 @@ typedef struct
     os_queue_t *wlc_mgr_event_queue;
 
     void (*data_intput_callback)(const uint8_t interface, const uint8_t *buffer, const uint16_t len);
-    void (*amsdu_data_intput_callback)(uint8_t interface, uint8_t *buffer, uint16_t len);
+    void (*amsdu_data_intput_callback)(uint8_t interface, uint8_t *buffer, uint16_t len, uint8_t priority);
     void (*deliver_packet_above_callback)(void *rxpd, t_u8 interface, t_void *lwip_pbuf);
     bool (*wrapper_net_is_ip_or_ipv6_callback)(const t_u8 *buffer);
+#ifdef CONFIG_WIFI_RX_BATCH
+    void (*rx_batch_end_callback)(void);
+#endif
 
     os_mutex_t command_lock;
     os_semaphore_t command_resp_sem;
     os_mutex_t mcastf_mutex;
+    /** Mutex to protect the remain on channel state */
+    os_mutex_t roc_mutex;
 #ifdef CONFIG_WMM
     /** Semaphore to protect data parameters */
     os_semaphore_t tx_data_sem;
@@ -121,6 +126,10 @@ typedef struct
     t_u16 ht_cap_info;
     /** HTTX Cfg */
     t_u16 ht_tx_cfg;
+#ifdef CONFIG_WIFI_RECOVERY
+    /** Firmware stopped responding, commands fail until it is reloaded */
+    bool fw_hung;
+#endif
 #ifdef CONFIG_WIFI_FW_DEBUG
     /** This function mount USB device.
      *
@@ -362,6 +371,7 @@ int wifi_set_uap_rts(int rts_threshold);
 int wifi_set_uap_frag(int frag_threshold);
 int wifi_nxp_sta_add(nxp_wifi_sta_info_t *params);
 int wifi_nxp_sta_remove(const uint8_t *addr);
+void wifi_nxp_sta_key_installed(const uint8_t *addr);
 int wifi_nxp_stop_ap(void);
 int wifi_nxp_set_acl(nxp_wifi_acl_info_t *acl_params);
 int wifi_nxp_set_country(unsigned int bss_type, const char *alpha2);
@@ -371,10 +381,42 @@ int wifi_nxp_scan_res_num(void);
 int wifi_nxp_scan_res_get2(t_u32 table_idx, nxp_wifi_event_new_scan_result_t *scan_res);
 #endif /* CONFIG_WPA_SUPP */
 
+/** Time in msec after which TX held for a channel switch resumes anyway */
+#define WIFI_CHAN_SWITCH_TIMEOUT_MS 3000U
+
+/**
+ * Resume TX on \a priv if its channel switch did not complete in time.
+ */
+void wifi_chan_switch_check_timeout(mlan_private *priv);
+
+/** Time in msec past the end of a slice after which TX resumes anyway */
+#define WIFI_ROC_EXPIRY_MARGIN_MS 500U
+
+/**
+ * Resume TX if the current remain on channel slice did not report its
+ * expiry in time.
+ */
+void wifi_roc_check_timeout(void);
+
+/**
+ * Wait, for at most the home channel time, while a sliced remain on
+ * channel request is between two slices.
+ */
+void wifi_roc_wait_home(void);
 
 #ifdef CONFIG_WMM
 int send_wifi_driver_tx_data_event(t_u8 interface);
 int send_wifi_driver_tx_null_data_event(t_u8 interface);
 #endif
 
+#ifdef CONFIG_WIFI_RECOVERY
+/**
+ * Report a firmware hang to the registered recovery handler.
+ *
+ * Only the first report until the firmware is reloaded is forwarded, and
+ * further commands fail without waiting for a response.
+ */
+void wifi_hang_detected(wifi_hang_reason_t reason);
+#endif
+
 #endif /* __WIFI_INTERNAL_H__ */
@@ -78,3 +78,211 @@ mlan_status wrapper_moal_mfree(IN t_void *pmoal_handle, IN t_u8 *pbuf)
     os_mem_free(pbuf);
     return MLAN_STATUS_SUCCESS;
 }
+
+/* Data path primitives
+ *
+ * Copies and Internet checksums on the RX/TX data path go through these
+ * so that a platform can plug in an optimised or DMA based backend at
+ * run time. The built-in backend copies with memcpy() and computes the
+ * checksum 32 bits at a time, fused with the copy where both buffers
+ * share the same word alignment.
+ */
+#ifndef WIFI_DP_DMA_MIN_LEN
+/** Copies of at least this many bytes use the DMA copy when available */
+#define WIFI_DP_DMA_MIN_LEN 512U
+#endif
+
+static void wifi_dp_sw_copy(void *dst, const void *src, uint32_t len)
+{
+    (void)memcpy(dst, src, len);
+}
+
+/*
+ * One's complement sum of len bytes at src, the bytes are also copied
+ * to dst if dst is not NULL. src and dst must share the same alignment
+ * modulo 4. The result matches lwIP's lwip_standard_chksum().
+ */
+static uint16_t wifi_dp_sw_sum(t_u8 *dst, const t_u8 *src, uint32_t len)
+{
+    t_u64 sum = 0;
+    t_u16 t   = 0;
+    t_u32 w;
+    t_u16 h;
+    t_u8 odd = (t_u8)((t_ptr)src & 1U);
+
+    if (odd != 0U && len > 0U)
+    {
+        ((t_u8 *)&t)[1] = *src;
+        if (dst != NULL)
+            *dst++ = *src;
+        src++;
+        len--;
+    }
+
+    if (((t_ptr)src & 2U) != 0U && len > 1U)
+    {
+        h = *(const t_u16 *)(const void *)src;
+        if (dst != NULL)
+        {
+            *(t_u16 *)(void *)dst = h;
+            dst += 2;
+        }
+        sum += h;
+        src += 2;
+        len -= 2U;
+    }
+
+    while (len > 3U)
+    {
+        w = *(const t_u32 *)(const void *)src;
+        if (dst != NULL)
+        {
+            *(t_u32 *)(void *)dst = w;
+            dst += 4;
+        }
+        sum += w;
+        src += 4;
+        len -= 4U;
+    }
+
+    if (len > 1U)
+    {
+        h = *(const t_u16 *)(const void *)src;
+        if (dst != NULL)
+        {
+            *(t_u16 *)(void *)dst = h;
+            dst += 2;
+        }
+        sum += h;
+        src += 2;
+        len -= 2U;
+    }
+
+    if (len > 0U)
+    {
+        ((t_u8 *)&t)[0] = *src;
+        if (dst != NULL)
+            *dst = *src;
+    }
+    sum += t;
+
+    /* fold 64 bits to 16 bits with end around carry */
+    sum = (sum >> 32) + (sum & 0xffffffffU);
+    sum = (sum >> 16) + (sum & 0xffffU);
+    sum = (sum >> 16) + (sum & 0xffffU);
+    sum = (sum >> 16) + (sum & 0xffffU);
+
+    if (odd != 0U)
+        sum = ((sum & 0xffU) << 8) | ((sum >> 8) & 0xffU);
+
+    return (uint16_t)sum;
+}
+
+static uint16_t wifi_dp_sw_chksum(const void *data, uint32_t len)
+{
+    return wifi_dp_sw_sum(NULL, (const t_u8 *)data, len);
+}
+
+static uint16_t wifi_dp_sw_copy_chksum(void *dst, const void *src, uint32_t len)
+{
+    if ((((t_ptr)dst ^ (t_ptr)src) & 3U) != 0U)
+    {
+        /* alignments differ, a fused word loop cannot be used */
+        (void)memcpy(dst, src, len);
+        return wifi_dp_sw_sum(NULL, (const t_u8 *)dst, len);
+    }
+
+    return wifi_dp_sw_sum((t_u8 *)dst, (const t_u8 *)src, len);
+}
+
+#ifdef CONFIG_IMU_GDMA
+static void wifi_dp_gdma_copy(void *dst, const void *src, uint32_t len)
+{
+    HAL_ImuGdmaCopyData(dst, (void *)src, len);
+}
+#endif
+
+static wifi_dp_ops_t wifi_dp_ops = {
+    .copy        = wifi_dp_sw_copy,
+    .copy_chksum = wifi_dp_sw_copy_chksum,
+    .chksum      = wifi_dp_sw_chksum,
+#ifdef CONFIG_IMU_GDMA
+    .dma_copy = wifi_dp_gdma_copy,
+#else
+    .dma_copy = NULL,
+#endif
+    .dma_min_len = WIFI_DP_DMA_MIN_LEN,
+};
+
+/* Set while a thread owns the single DMA channel */
+static volatile bool wifi_dp_dma_busy;
+
+void wifi_dp_set_ops(const wifi_dp_ops_t *ops)
+{
+    wifi_dp_ops.copy        = wifi_dp_sw_copy;
+    wifi_dp_ops.copy_chksum = wifi_dp_sw_copy_chksum;
+    wifi_dp_ops.chksum      = wifi_dp_sw_chksum;
+#ifdef CONFIG_IMU_GDMA
+    wifi_dp_ops.dma_copy = wifi_dp_gdma_copy;
+#else
+    wifi_dp_ops.dma_copy = NULL;
+#endif
+    wifi_dp_ops.dma_min_len = WIFI_DP_DMA_MIN_LEN;
+
+    if (ops == NULL)
+    {
+        return;
+    }
+
+    if (ops->copy != NULL)
+        wifi_dp_ops.copy = ops->copy;
+    if (ops->copy_chksum != NULL)
+        wifi_dp_ops.copy_chksum = ops->copy_chksum;
+    if (ops->chksum != NULL)
+        wifi_dp_ops.chksum = ops->chksum;
+    if (ops->dma_copy != NULL)
+    {
+        wifi_dp_ops.dma_copy    = ops->dma_copy;
+        wifi_dp_ops.dma_min_len = ops->dma_min_len;
+    }
+}
+
+void wifi_dp_copy(void *dst, const void *src, uint32_t len)
+{
+    bool use_dma = false;
+    unsigned long sta;
+
+    if (wifi_dp_ops.dma_copy != NULL && len >= wifi_dp_ops.dma_min_len)
+    {
+        /* RX, TX and lwIP threads copy concurrently, only one of them
+         * drives the channel and the others copy with the CPU instead
+         * of waiting for it */
+        sta = os_enter_critical_section();
+        if (wifi_dp_dma_busy == false)
+        {
+            wifi_dp_dma_busy = true;
+            use_dma          = true;
+        }
+        os_exit_critical_section(sta);
+    }
+
+    if (use_dma == true)
+    {
+        wifi_dp_ops.dma_copy(dst, src, len);
+        wifi_dp_dma_busy = false;
+    }
+    else
+    {
+        wifi_dp_ops.copy(dst, src, len);
+    }
+}
+
+uint16_t wifi_dp_copy_chksum(void *dst, const void *src, uint32_t len)
+{
+    return wifi_dp_ops.copy_chksum(dst, src, len);
+}
+
+uint16_t wifi_dp_chksum(const void *data, uint32_t len)
+{
+    return wifi_dp_ops.chksum(data, len);
+}
@@ -48,6 +48,10 @@ void set_ioport_inmlan(t_u32 port);
 static t_u8 txportno;
 
 static t_u32 last_cmd_sent, fw_init_cfg;
+#if defined(CONFIG_WIFI_RECOVERY) && !defined(CONFIG_SDIO_MULTI_PORT_RX_AGGR)
+/* Consecutive failed reads of received data */
+static t_u32 rx_read_fail_cnt;
+#endif
 
 static os_mutex_t txrx_mutex;
 static os_semaphore_t sdio_command_resp_sem;
@@ -79,6 +83,44 @@ uint8_t dev_mac_addr[MLAN_MAC_ADDR_LENGTH];
 uint8_t dev_mac_addr_uap[MLAN_MAC_ADDR_LENGTH];
 static uint8_t dev_fw_ver_ext[MLAN_MAX_VER_STR_LEN];
 
+#ifdef CONFIG_WIFI_WARM_START
+/* Time allowed for a running firmware to answer the version query */
+#define WARM_START_CMD_WAIT_MS 1000U
+
+static bool warm_start_enabled;
+/* Expected version of a running firmware, empty accepts any */
+static char warm_fw_version[MLAN_MAX_VER_STR_LEN];
+/* Firmware was found running and its download skipped */
+static bool fw_warm;
+/* Firmware was found running but could not be reused */
+static bool fw_warm_rejected;
+static unsigned int fw_boot_start_ms;
+static wifi_fw_boot_stats_t fw_boot_stats;
+#endif
+
+#ifdef CONFIG_WIFI_SDIO_REG_CACHE
+/*
+ * Register image read per interrupt: interrupt status, port bitmaps and
+ * the read lengths of all data ports. Anything further up, such as the
+ * command port length registers, is only fetched when needed.
+ */
+#define MP_REGS_DATA_LEN (RD_LEN_P0_L + (MAX_PORT << 1U))
+
+/* Age of the register image after which TX may refresh the write bitmap */
+#define SDIO_WR_REFRESH_MS 2U
+
+#if defined(SD8801)
+#define WR_BITMAP_LEN 2U
+#elif defined(SD8978) || defined(SD8987) || defined(SD8997) || defined(SD9097) || defined(SD9098) || defined(IW61x)
+#define WR_BITMAP_LEN 4U
+#endif
+
+static t_u8 wr_bitmap_buffer[WR_BITMAP_LEN + DMA_ALIGNMENT];
+static unsigned int mp_regs_read_ms;
+static bool mp_regs_valid;
+static wifi_sdio_reg_stats_t sdio_reg_stats;
+#endif
+
 int wifi_sdio_lock(void)
 {
     return os_mutex_get(&txrx_mutex, OS_WAIT_FOREVER);
@@ -255,11 +297,22 @@ void process_pkt_hdrs(void *pbuf, t_u32 payloadlen, t_u8 interface, t_u8 tid)
     ptxpd->priority      = tid;
     ptxpd->flags         = 0;
 
+    /* Priority specific tx_control, fall back to the interface wide one */
+    if (tid <= WMM_HIGHEST_PRIORITY)
+    {
+        ptxpd->tx_control = pmpriv->wmm.user_pri_pkt_tx_ctrl[tid];
+    }
+    if (ptxpd->tx_control == 0U)
+    {
+        ptxpd->tx_control = pmpriv->pkt_tx_ctrl;
+    }
+
     if (ptxpd->tx_pkt_type == 0xe5U)
     {
         ptxpd->tx_pkt_offset = 0x14; /* Override for special frame */
     }
 
+    /* Filled in at dequeue time when the packet waited in a WMM ra list */
     ptxpd->pkt_delay_2ms = 0;
 
     sdiohdr->size = (t_u16)payloadlen;
@@ -565,6 +618,9 @@ static t_u8 *wlan_read_rcv_packet(t_u32 port, t_u32 rxlen, t_u32 rx_blocks, t_u3
                 {
                     wifi_e("USB mount callback is not registered");
                 }
+#endif
+#ifdef CONFIG_WIFI_RECOVERY
+                wifi_hang_detected(WIFI_HANG_RX_STALL);
 #endif
                 return NULL;
             } /* if (i > MAX_READ_IOMEM_RETRY) */
@@ -597,9 +653,19 @@ static t_u8 *wlan_read_rcv_packet(t_u32 port, t_u32 rxlen, t_u32 rx_blocks, t_u3
             wifi_e("USB mount callback is not registered");
         }
 
+#endif
+#ifdef CONFIG_WIFI_RECOVERY
+        if (++rx_read_fail_cnt > MAX_READ_IOMEM_RETRY)
+        {
+            rx_read_fail_cnt = 0;
+            wifi_hang_detected(WIFI_HANG_RX_STALL);
+        }
 #endif
         return NULL;
     }
+#ifdef CONFIG_WIFI_RECOVERY
+    rx_read_fail_cnt = 0;
+#endif
 #endif
 
     SDIOPkt *insdiopkt = (SDIOPkt *)(void *)inbuf;
@@ -810,7 +876,7 @@ static void wlan_get_mac_addr_uap(void)
 }
 
 void wifi_prepare_get_fw_ver_ext_cmd(HostCmd_DS_COMMAND *cmd, int seq_number, int version_str_sel);
-static void wlan_get_fw_ver_ext(int version_str_sel)
+static void wlan_send_fw_ver_ext(int version_str_sel)
 {
     t_u32 tx_blocks = 1, buflen = MLAN_SDIO_BLOCK_SIZE;
     uint32_t resp;
@@ -835,11 +901,72 @@ static void wlan_get_fw_ver_ext(int version_str_sel)
 #endif
 
     wifi_sdio_unlock();
+}
+
+static void wlan_get_fw_ver_ext(int version_str_sel)
+{
+    wlan_send_fw_ver_ext(version_str_sel);
 
     wifi_sdio_wait_for_cmdresp();
+}
+
+#ifdef CONFIG_WIFI_WARM_START
+/*
+ * Check that a firmware found running answers commands and is the
+ * expected one. The init command chain that follows resynchronizes it
+ * with the freshly initialized host.
+ */
+static bool wlan_warm_start_check(void)
+{
+    wlan_send_fw_ver_ext(0);
 
+    if (wifi_sdio_get_command_resp_sem(os_msec_to_ticks(WARM_START_CMD_WAIT_MS)) != WM_SUCCESS)
+    {
+        wifi_io_w("Warm start: running firmware does not respond");
+        return false;
+    }
+
+    if (warm_fw_version[0] != '\0' &&
+        strncmp((const char *)dev_fw_ver_ext, warm_fw_version, sizeof(warm_fw_version)) != 0)
+    {
+        wifi_io_w("Warm start: running firmware %s is not %s", dev_fw_ver_ext, warm_fw_version);
+        return false;
+    }
+
+    return true;
+}
+
+void wifi_set_fw_warm_start(const char *fw_version)
+{
+    if (fw_version == NULL)
+    {
+        warm_start_enabled = false;
+        return;
+    }
+
+    (void)strncpy(warm_fw_version, fw_version, sizeof(warm_fw_version) - 1U);
+    warm_fw_version[sizeof(warm_fw_version) - 1U] = '\0';
+    warm_start_enabled                           = true;
+}
+
+int wifi_get_fw_boot_stats(wifi_fw_boot_stats_t *stats)
+{
+    if (stats == NULL)
+    {
+        return -WM_E_INVAL;
+    }
+
+    (void)memcpy((void *)stats, (const void *)&fw_boot_stats, sizeof(*stats));
+
+    return WM_SUCCESS;
 }
 
+bool sd_wifi_warm_start_rejected(void)
+{
+    return fw_warm_rejected;
+}
+#endif
+
 void wifi_prepare_get_value1(HostCmd_DS_COMMAND *cmd, int seq_number);
 
 static void wlan_get_value_1(void)
@@ -1192,6 +1319,74 @@ static t_u8 start_port     = -1;
 static t_u8 ports          = 0;
 static t_u8 pkt_cnt        = 0;
 
+#ifdef CONFIG_WIFI_SDIO_REG_CACHE
+/*
+ * The write port bitmap is kept up to date incrementally: TX clears the
+ * bit of each port it uses and every interrupt reloads it from the
+ * register image. When TX runs out of ports and that image is older
+ * than SDIO_WR_REFRESH_MS, or no valid image exists, only the bitmap
+ * registers are read instead of waiting for the next interrupt.
+ *
+ * The caller holds the SDIO lock and has no ports reserved for data not
+ * yet written.
+ */
+static bool wlan_refresh_wr_bitmap(void)
+{
+    uint32_t resp;
+    t_u8 *buf = (t_u8 *)ALIGN_ADDR(wr_bitmap_buffer, DMA_ALIGNMENT);
+
+    if (mp_regs_valid && (os_ticks_to_msec(os_ticks_get()) - mp_regs_read_ms) < SDIO_WR_REFRESH_MS)
+    {
+        return false;
+    }
+
+    if (!sdio_drv_read((REG_PORT + WR_BITMAP_L) | MLAN_SDIO_BYTE_MODE_MASK, 1, 1, WR_BITMAP_LEN, buf, &resp))
+    {
+        return false;
+    }
+
+    sdio_reg_stats.wr_refreshes++;
+    sdio_reg_stats.reg_bytes += WR_BITMAP_LEN;
+
+#if defined(SD8801)
+    /* the control port bit is owned by the command path */
+    mlan_adap->mp_wr_bitmap = ((((t_u32)buf[1] << 8) | (t_u32)buf[0]) & (t_u32)(~CTRL_PORT_MASK)) |
+                              (mlan_adap->mp_wr_bitmap & CTRL_PORT_MASK);
+#elif defined(SD8978) || defined(SD8987) || defined(SD8997) || defined(SD9097) || defined(SD9098) || defined(IW61x)
+    mlan_adap->mp_wr_bitmap =
+        (t_u32)buf[0] | ((t_u32)buf[1] << 8) | ((t_u32)buf[2] << 16) | ((t_u32)buf[3] << 24);
+#endif
+
+    return (((1U << txportno) & mlan_adap->mp_wr_bitmap) != 0U) ? true : false;
+}
+
+int wifi_get_sdio_reg_stats(wifi_sdio_reg_stats_t *stats)
+{
+    t_u32 pkts;
+
+    if (stats == NULL)
+    {
+        return -WM_E_INVAL;
+    }
+
+    (void)memcpy((void *)stats, (const void *)&sdio_reg_stats, sizeof(*stats));
+
+    pkts = stats->rx_pkts + stats->tx_pkts;
+    if (pkts != 0U)
+    {
+        stats->reads_per_1k_pkts =
+            (uint32_t)((((uint64_t)stats->int_reads + stats->cmd_len_reads + stats->wr_refreshes) * 1000U) / pkts);
+    }
+
+    return WM_SUCCESS;
+}
+
+void wifi_reset_sdio_reg_stats(void)
+{
+    (void)memset((void *)&sdio_reg_stats, 0, sizeof(sdio_reg_stats));
+}
+#endif
+
 /**
  *  @brief This function gets available SDIO port for writing data
  *
@@ -1320,11 +1515,24 @@ mlan_status wlan_xmit_wmm_pkt(t_u8 interface, t_u32 txlen, t_u8 *tx_buf)
     (void)PRINTF("%s: txportno = %d mlan_adap->mp_wr_bitmap: %x\n\r", __func__, txportno, mlan_adap->mp_wr_bitmap);
 #endif /* CONFIG_WIFI_IO_DEBUG */
 
+#ifdef CONFIG_WIFI_SDIO_REG_CACHE
+    /* ports reserved for the pending aggregate still read as free */
+    if (buf_block_len == 0U && ((1U << txportno) & mlan_adap->mp_wr_bitmap) == 0U)
+    {
+        (void)wifi_sdio_lock();
+        (void)wlan_refresh_wr_bitmap();
+        wifi_sdio_unlock();
+    }
+#endif
+
     ret = wlan_get_wr_port_data(&port);
     if (ret != WM_SUCCESS)
     {
         return MLAN_STATUS_RESOURCE;
     }
+#ifdef CONFIG_WIFI_SDIO_REG_CACHE
+    sdio_reg_stats.tx_pkts++;
+#endif
 
 
     if (buf_block_len == 0)
@@ -1332,7 +1540,7 @@ mlan_status wlan_xmit_wmm_pkt(t_u8 interface, t_u32 txlen, t_u8 *tx_buf)
         start_port = port;
     }
 
-    memcpy(outbuf + buf_block_len, tx_buf, txlen);
+    wifi_dp_copy(outbuf + buf_block_len, tx_buf, txlen);
 
     buf_block_len += tx_blocks * buflen;
 
@@ -1429,6 +1637,12 @@ mlan_status wlan_xmit_wmm_pkt(t_u8 interface, t_u32 txlen, t_u8 *tx_buf)
 retry_xmit:
     wifi_sdio_lock();
     ret = get_free_port();
+#ifdef CONFIG_WIFI_SDIO_REG_CACHE
+    if (ret == -WM_FAIL && wlan_refresh_wr_bitmap() == true)
+    {
+        ret = get_free_port();
+    }
+#endif
     if (ret == -WM_FAIL)
     {
         wifi_sdio_unlock();
@@ -1483,7 +1697,9 @@ retry_xmit:
         goto exit_fn;
     }
 
-
+#ifdef CONFIG_WIFI_SDIO_REG_CACHE
+    sdio_reg_stats.tx_pkts++;
+#endif
     ret = MLAN_STATUS_SUCCESS;
 
 exit_fn:
@@ -1585,19 +1801,54 @@ t_void wlan_interrupt(mlan_adapter *pmadapter)
     t_u8 *mp_regs = pmadapter->mp_regs;
 
     /* Read the registers in DMA aligned buffer */
+#ifdef CONFIG_WIFI_SDIO_REG_CACHE
+#if defined(SD8801)
+    ret = sdio_drv_read(0, 1, 1, MP_REGS_DATA_LEN, mp_regs, &resp);
+#elif defined(SD8978) || defined(SD8987) || defined(SD8997) || defined(SD9097) || defined(SD9098) || defined(IW61x)
+    ret = sdio_drv_read(REG_PORT | MLAN_SDIO_BYTE_MODE_MASK, 1, 1, MP_REGS_DATA_LEN, mp_regs, &resp);
+#endif
+#else
 #if defined(SD8801)
     ret = sdio_drv_read(0, 1, 1, MAX_MP_REGS, mp_regs, &resp);
 #elif defined(SD8978) || defined(SD8987) || defined(SD8997) || defined(SD9097) || defined(SD9098) || defined(IW61x)
     ret = sdio_drv_read(REG_PORT | MLAN_SDIO_BYTE_MODE_MASK, 1, 1, MAX_MP_REGS, mp_regs, &resp);
+#endif
 #endif
 
     if (!ret)
     {
+#ifdef CONFIG_WIFI_SDIO_REG_CACHE
+        mp_regs_valid = false;
+#endif
         return;
     }
 
     t_u8 sdio_ireg = mp_regs[HOST_INT_STATUS_REG];
 
+#ifdef CONFIG_WIFI_SDIO_REG_CACHE
+    sdio_reg_stats.int_reads++;
+    sdio_reg_stats.reg_bytes += MP_REGS_DATA_LEN;
+    mp_regs_read_ms = os_ticks_to_msec(os_ticks_get());
+    mp_regs_valid   = true;
+
+#if defined(SD8978) || defined(SD8987) || defined(SD8997) || defined(SD9097) || defined(SD9098) || defined(IW61x)
+    /* the command port length is only needed when it has something */
+    if ((sdio_ireg & UP_LD_CMD_PORT_HOST_INT_STATUS) != 0U)
+    {
+        ret = sdio_drv_read((REG_PORT + CMD_RD_LEN_0) | MLAN_SDIO_BYTE_MODE_MASK, 1, 1, 2, &mp_regs[CMD_RD_LEN_0],
+                            &resp);
+        if (!ret)
+        {
+            wifi_io_e("Failed to read command port length");
+            mp_regs[CMD_RD_LEN_0] = 0;
+            mp_regs[CMD_RD_LEN_1] = 0;
+        }
+        sdio_reg_stats.cmd_len_reads++;
+        sdio_reg_stats.reg_bytes += 2U;
+    }
+#endif
+#endif
+
     if (sdio_ireg != 0U)
     {
         /*
@@ -2045,6 +2296,9 @@ static void handle_sdio_packet_read(mlan_adapter *pmadapter)
                 {
                     (void)bus.wifi_low_level_input(interface, packet, size);
                 }
+#ifdef CONFIG_WIFI_SDIO_REG_CACHE
+                sdio_reg_stats.rx_pkts++;
+#endif
 
                 packet += size;
                 total_size += size;
@@ -2351,8 +2605,28 @@ mlan_status sd_wifi_post_init(enum wlan_type type)
     {
         case WLAN_TYPE_NORMAL:
             fw_init_cfg = 1;
+#ifdef CONFIG_WIFI_WARM_START
+            if (fw_warm && !wlan_warm_start_check())
+            {
+                fw_init_cfg      = 0;
+                fw_warm_rejected = true;
+                return MLAN_STATUS_FAILURE;
+            }
+#endif
             wlan_fw_init_cfg();
             fw_init_cfg = 0;
+#ifdef CONFIG_WIFI_WARM_START
+            fw_boot_stats.warm    = fw_warm;
+            fw_boot_stats.boot_ms = os_ticks_to_msec(os_ticks_get()) - fw_boot_start_ms;
+            if (fw_warm)
+            {
+                fw_boot_stats.warm_starts++;
+            }
+            else
+            {
+                fw_boot_stats.cold_starts++;
+            }
+#endif
             break;
         case WLAN_TYPE_WIFI_CALIB:
             g_txrx_flag = true;
@@ -2381,6 +2655,17 @@ mlan_status sd_wifi_post_init(enum wlan_type type)
 mlan_status sd_wifi_init(enum wlan_type type, const uint8_t *fw_start_addr, const size_t size)
 {
     mlan_status ret = MLAN_STATUS_SUCCESS;
+#ifdef CONFIG_WIFI_WARM_START
+    bool warm_retry = fw_warm_rejected;
+
+    /* A retry after a rejected warm start keeps the original start time */
+    if (!warm_retry)
+    {
+        fw_boot_start_ms = os_ticks_to_msec(os_ticks_get());
+    }
+    fw_warm          = false;
+    fw_warm_rejected = false;
+#endif
 
     ret = sd_wifi_preinit();
     if (ret == MLAN_STATUS_SUCCESS)
@@ -2391,6 +2676,32 @@ mlan_status sd_wifi_init(enum wlan_type type, const uint8_t *fw_start_addr, cons
             ret = (mlan_status)sdio_ioport_init();
             if (ret == MLAN_STATUS_SUCCESS)
             {
+#ifdef CONFIG_WIFI_WARM_START
+                if (type == WLAN_TYPE_NORMAL && warm_start_enabled && !warm_retry && wlan_card_fw_running() == true)
+                {
+                    uint32_t resp;
+
+                    wifi_io_d("Firmware already running, skipping download");
+                    /* Drop interrupt status left over from the previous host */
+                    (void)sdio_drv_creg_read(HOST_INT_STATUS_REG, 1, &resp);
+                    fw_warm = true;
+                    return ret;
+                }
+                if (warm_retry)
+                {
+                    fw_boot_stats.warm_rejects++;
+                    /* A late answer to the version query must not complete a later command */
+                    while (wifi_sdio_get_command_resp_sem(0) == WM_SUCCESS)
+                    {
+                    }
+                    wifi_io_d("Resetting the rejected firmware");
+                    if (wlan_card_fw_reset() != WM_SUCCESS)
+                    {
+                        wifi_io_e("Rejected firmware did not reset, power cycle the card");
+                        return MLAN_STATUS_FAILURE;
+                    }
+                }
+#endif
                 ret = (mlan_status)firmware_download(fw_start_addr, size);
             }
         }
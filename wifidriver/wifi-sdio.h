@@ -38,7 +38,7 @@
 
 #define WIFI_RESP_WAIT_TIME 10
 
-#define SDIO_INBUF_LEN (2048 * 2)
+#define SDIO_INBUF_LEN (SDIO_OUTBUF_LEN * 2U)
 
 #if (SDIO_INBUF_LEN % MLAN_SDIO_BLOCK_SIZE)
 #error "Please keep buffer length aligned to SDIO block size"
@@ -51,7 +51,11 @@
 #define SDIO_PAYLOAD_SIZE 8
 
 /*! @brief Data block count accessed in card */
+#if (MLAN_MAX_DATA_FRAME_LEN > 2048U)
+#define DATA_BLOCK_COUNT (5U)
+#else
 #define DATA_BLOCK_COUNT (4U)
+#endif
 /*! @brief Data buffer size. */
 #define DATA_BUFFER_SIZE (FSL_SDMMC_DEFAULT_BLOCK_SIZE * DATA_BLOCK_COUNT)
 
@@ -83,6 +87,11 @@ mlan_status wlan_flush_wmm_pkt(t_u8 pkt_cnt);
 
 void sd_wifi_deinit(void);
 
+#ifdef CONFIG_WIFI_WARM_START
+/* True if the last init found a running firmware it could not reuse */
+bool sd_wifi_warm_start_rejected(void);
+#endif
+
 /*
  * @internal
  *
@@ -3408,15 +3408,90 @@ static mlan_status wifi_uap_sta_info(mlan_private *priv, t_u16 action, mlan_ds_s
     return MLAN_STATUS_SUCCESS;
 }
 
+/**
+ *  @brief Hash a station add request
+ *
+ *  Used to recognise a request which repeats the last one sent for
+ *  a station, as hostapd does for retransmitted association requests.
+ *  A request is taken as a repeat only when its length and two
+ *  independent hashes all match, so a single hash collision cannot
+ *  drop a real update.
+ *
+ *  @param buf              A pointer to the request
+ *  @param len              Length of the request
+ *  @param hash2            A pointer to return the one-at-a-time hash
+ *
+ *  @return                 FNV-1a hash of the request
+ */
+static t_u32 wifi_uap_sta_req_hash(const t_u8 *buf, t_u32 len, t_u32 *hash2)
+{
+    t_u32 hash = 2166136261U;
+    t_u32 oaat = 0;
+    t_u32 i;
+
+    for (i = 0; i < len; i++)
+    {
+        hash ^= buf[i];
+        hash *= 16777619U;
+
+        oaat += buf[i];
+        oaat += oaat << 10;
+        oaat ^= oaat >> 6;
+    }
+    oaat += oaat << 3;
+    oaat ^= oaat >> 11;
+    oaat += oaat << 15;
+
+    *hash2 = oaat;
+
+    return hash;
+}
+
+/**
+ *  @brief Record that a station is authorised
+ *
+ *  @param priv             A pointer to mlan_private structure
+ *  @param sta_ptr          A pointer to the station node
+ *
+ *  @return                 N/A
+ */
+static void wifi_uap_sta_setup_done(mlan_private *priv, sta_node *sta_ptr)
+{
+    sta_setup_stat_t *stat = &priv->sta_setup;
+    t_u32 elapsed;
+
+    if (sta_ptr->setup_state != STA_SETUP_PENDING)
+    {
+        return;
+    }
+
+    elapsed                = os_ticks_to_msec(os_ticks_get()) - sta_ptr->setup_start_ms;
+    sta_ptr->setup_auth_ms = elapsed;
+    sta_ptr->setup_state   = STA_SETUP_DONE;
+
+    stat->authorized++;
+    stat->total_ms += elapsed;
+    stat->last_ms = elapsed;
+    if (elapsed > stat->max_ms)
+    {
+        stat->max_ms = elapsed;
+    }
+
+    wuap_d("station " MACSTR " authorised in %u ms", MAC2STR(sta_ptr->mac_addr), elapsed);
+}
+
 int wifi_nxp_sta_add(nxp_wifi_sta_info_t *params)
 {
     mlan_private *priv         = (mlan_private *)mlan_adap->priv[1];
     int ret                    = 0;
     mlan_ds_sta_info *sta_info = NULL;
+    sta_node *sta_ptr          = MNULL;
     t_u8 *pos;
     t_u8 qosinfo;
     MrvlIEtypes_Data_t *tlv;
-    t_u32 req_len = 0;
+    t_u32 req_len   = 0;
+    t_u32 req_hash  = 0;
+    t_u32 req_hash2 = 0;
 
     ENTER();
 
@@ -3519,6 +3594,18 @@ int wifi_nxp_sta_add(nxp_wifi_sta_info_t *params)
     }
 #endif
 
+    /* A station update identical to the last one sent changes nothing in
+     * firmware, skip the round trip. */
+    req_hash = wifi_uap_sta_req_hash((t_u8 *)sta_info, req_len, &req_hash2);
+    sta_ptr  = wlan_get_station_entry(priv, params->addr);
+    if ((params->set != 0) && (sta_ptr != MNULL) && (sta_ptr->setup_req_len == req_len) &&
+        (sta_ptr->setup_req_hash == req_hash) && (sta_ptr->setup_req_hash2 == req_hash2))
+    {
+        wuap_d("skip repeated add for station " MACSTR "", MAC2STR(params->addr));
+        priv->sta_setup.skipped++;
+        goto done;
+    }
+
     if (MLAN_STATUS_SUCCESS != wifi_uap_sta_info(priv, HostCmd_ACT_ADD_STA, sta_info))
     {
         wuap_e("uAP add station failed");
@@ -3526,6 +3613,28 @@ int wifi_nxp_sta_add(nxp_wifi_sta_info_t *params)
         goto done;
     }
 
+    priv->sta_setup.cmds++;
+
+    sta_ptr = wlan_get_station_entry(priv, params->addr);
+    if (sta_ptr != MNULL)
+    {
+        sta_ptr->setup_req_len   = req_len;
+        sta_ptr->setup_req_hash  = req_hash;
+        sta_ptr->setup_req_hash2 = req_hash2;
+
+        if ((params->set == 0) || (sta_ptr->setup_state == STA_SETUP_IDLE))
+        {
+            sta_ptr->setup_state    = STA_SETUP_PENDING;
+            sta_ptr->setup_start_ms = os_ticks_to_msec(os_ticks_get());
+            sta_ptr->setup_auth_ms  = 0;
+        }
+
+        if ((params->flags & STA_FLAG_AUTHORIZED) != 0U)
+        {
+            wifi_uap_sta_setup_done(priv, sta_ptr);
+        }
+    }
+
 done:
     if (sta_info)
         os_mem_free(sta_info);
@@ -3569,6 +3678,10 @@ int wifi_nxp_sta_remove(const uint8_t *addr)
         goto done;
     }
 
+    /* Drop the node so the station list does not grow with every client
+     * that ever associated. */
+    wlan_delete_station_entry(priv, sta_info->peer_mac);
+
 done:
     if (sta_info)
         os_mem_free(sta_info);
@@ -3577,6 +3690,81 @@ done:
     return ret;
 }
 
+void wifi_nxp_sta_key_installed(const uint8_t *addr)
+{
+    mlan_private *priv = (mlan_private *)mlan_adap->priv[1];
+    sta_node *sta_ptr  = MNULL;
+
+    if (addr == NULL)
+    {
+        return;
+    }
+
+    sta_ptr = wlan_get_station_entry(priv, (t_u8 *)addr);
+    if (sta_ptr != MNULL)
+    {
+        wifi_uap_sta_setup_done(priv, sta_ptr);
+    }
+}
+
+int wifi_uap_get_sta_setup_stats(wifi_uap_sta_setup_stats_t *stats)
+{
+    mlan_private *priv     = (mlan_private *)mlan_adap->priv[1];
+    sta_setup_stat_t *stat = &priv->sta_setup;
+    sta_node *sta_ptr      = MNULL;
+
+    if (stats == NULL)
+    {
+        return -WM_E_INVAL;
+    }
+
+    (void)memset(stats, 0x00, sizeof(wifi_uap_sta_setup_stats_t));
+
+    stats->authorized = stat->authorized;
+    stats->avg_ms     = (stat->authorized != 0U) ? (stat->total_ms / stat->authorized) : 0U;
+    stats->last_ms    = stat->last_ms;
+    stats->max_ms     = stat->max_ms;
+    stats->fw_cmds    = stat->cmds;
+    stats->skipped    = stat->skipped;
+
+    mlan_adap->callbacks.moal_spin_lock(mlan_adap->pmoal_handle, priv->wmm.ra_list_spinlock);
+    sta_ptr = (sta_node *)util_peek_list(mlan_adap->pmoal_handle, &priv->sta_list, MNULL, MNULL);
+    while ((sta_ptr != MNULL) && (sta_ptr != (sta_node *)&priv->sta_list))
+    {
+        if (sta_ptr->setup_state == STA_SETUP_PENDING)
+        {
+            stats->pending++;
+        }
+        sta_ptr = sta_ptr->pnext;
+    }
+    mlan_adap->callbacks.moal_spin_unlock(mlan_adap->pmoal_handle, priv->wmm.ra_list_spinlock);
+
+    return WM_SUCCESS;
+}
+
+int wifi_uap_get_sta_setup_time(const uint8_t *mac, uint32_t *time_ms)
+{
+    mlan_private *priv = (mlan_private *)mlan_adap->priv[1];
+    sta_node *sta_ptr  = MNULL;
+    int ret            = -WM_FAIL;
+
+    if ((mac == NULL) || (time_ms == NULL))
+    {
+        return -WM_E_INVAL;
+    }
+
+    mlan_adap->callbacks.moal_spin_lock(mlan_adap->pmoal_handle, priv->wmm.ra_list_spinlock);
+    sta_ptr = wlan_get_station_entry(priv, (t_u8 *)mac);
+    if (sta_ptr != MNULL)
+    {
+        *time_ms = (sta_ptr->setup_state == STA_SETUP_DONE) ? sta_ptr->setup_auth_ms : 0U;
+        ret      = WM_SUCCESS;
+    }
+    mlan_adap->callbacks.moal_spin_unlock(mlan_adap->pmoal_handle, priv->wmm.ra_list_spinlock);
+
+    return ret;
+}
+
 int wifi_set_uap_rts(int rts_threshold)
 {
     mlan_private *pmpriv = (mlan_private *)mlan_adap->priv[1];
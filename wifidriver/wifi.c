@@ -146,6 +146,34 @@ int wakelock_isheld(void)
 }
 #endif
 
+#ifdef CONFIG_WIFI_RECOVERY
+/* Kept outside wm_wifi so that they survive reinitialization */
+static void (*wifi_hang_cb)(wifi_hang_reason_t reason);
+static uint32_t wifi_cmd_timeout_ms = WIFI_COMMAND_RESPONSE_WAIT_MS;
+
+void wifi_set_hang_cb(void (*cb)(wifi_hang_reason_t reason))
+{
+    wifi_hang_cb = cb;
+}
+
+void wifi_set_cmd_timeout(uint32_t timeout_ms)
+{
+    wifi_cmd_timeout_ms = (timeout_ms != 0U) ? timeout_ms : WIFI_COMMAND_RESPONSE_WAIT_MS;
+}
+
+void wifi_hang_detected(wifi_hang_reason_t reason)
+{
+    if (wifi_hang_cb == NULL || wm_wifi.fw_hung)
+    {
+        return;
+    }
+
+    wm_wifi.fw_hung = true;
+    wifi_e("Firmware hang detected, reason %d", reason);
+    wifi_hang_cb(reason);
+}
+#endif
+
 unsigned wifi_get_last_cmd_sent_ms(void)
 {
     return wm_wifi.last_sent_cmd_msec;
@@ -892,6 +920,14 @@ int wifi_wait_for_cmdresp(void *cmd_resp_priv)
         return -WM_FAIL;
     }
 
+#ifdef CONFIG_WIFI_RECOVERY
+    if (wm_wifi.fw_hung)
+    {
+        (void)wifi_put_command_lock();
+        return -WM_FAIL;
+    }
+#endif
+
     tx_blocks = ((t_u32)cmd->size + MLAN_SDIO_BLOCK_SIZE - 1U) / MLAN_SDIO_BLOCK_SIZE;
 
     ret = os_rwlock_read_lock(&sleep_rwlock, MAX_WAIT_TIME);
@@ -917,8 +953,12 @@ int wifi_wait_for_cmdresp(void *cmd_resp_priv)
      */
     (void)os_rwlock_read_unlock(&sleep_rwlock);
 
+#ifdef CONFIG_WIFI_RECOVERY
+    ret = wifi_get_command_resp_sem(wifi_cmd_timeout_ms);
+#else
     /* Wait max 20 sec for the command response */
     ret = wifi_get_command_resp_sem(WIFI_COMMAND_RESPONSE_WAIT_MS);
+#endif
     if (ret != WM_SUCCESS)
     {
 #ifdef CONFIG_ENABLE_WARNING_LOGS
@@ -942,6 +982,17 @@ int wifi_wait_for_cmdresp(void *cmd_resp_priv)
         }
         else
             wifi_e("USB mount callback is not registered");
+#endif
+#ifdef CONFIG_WIFI_RECOVERY
+        if (wifi_hang_cb != NULL)
+        {
+            /* Leave the command flow to the recovery handler */
+            wifi_hang_detected(WIFI_HANG_CMD_TIMEOUT);
+            wm_wifi.cmd_resp_priv = NULL;
+            wifi_set_xfer_pending(false);
+            (void)wifi_put_command_lock();
+            return -WM_FAIL;
+        }
 #endif
         /* assert as command flow cannot work anymore */
         assert(0);
@@ -1099,6 +1150,17 @@ static int make_filter_list(char *mlist, int maxlen)
     return maddr_cnt;
 }
 
+int wifi_get_mcast_filter_list(uint8_t *mlist, int maxlen)
+{
+    if (mlist == NULL || maxlen < (int)MLAN_MAC_ADDR_LENGTH || wm_wifi.mcastf_mutex == NULL)
+    {
+        return 0;
+    }
+
+    /* make_filter_list() may go one entry past maxlen */
+    return make_filter_list((char *)mlist, maxlen - (int)MLAN_MAC_ADDR_LENGTH);
+}
+
 void wifi_get_ipv4_multicast_mac(uint32_t ipaddr, uint8_t *mac_addr)
 {
     int i = 0, j = 0;
@@ -1270,6 +1332,366 @@ int wifi_get_scan_result(unsigned int index, struct wifi_scan_result2 **desc)
     return WM_SUCCESS;
 }
 
+int wifi_scan_foreach(wifi_scan_visit_fn_t visit, void *arg)
+{
+    wifi_scan_view_t view;
+    unsigned int count = 0;
+    unsigned int i;
+
+    if (visit == NULL)
+    {
+        return -WM_E_INVAL;
+    }
+
+    (void)wifi_get_scan_result_count(&count);
+
+    for (i = 0; i < count; i++)
+    {
+        if (wrapper_bssdesc_view((int)i, &view) != WM_SUCCESS)
+        {
+            break;
+        }
+
+        if (visit(&view, arg) != 0)
+        {
+            i++;
+            break;
+        }
+    }
+
+    return (int)i;
+}
+
+static int32_t wifi_scan_rssi_key(const wifi_scan_view_t *view, void *arg)
+{
+    (void)arg;
+
+    /* RSSI is stored as an absolute value, smaller is stronger */
+    return -(int32_t)view->rssi;
+}
+
+int wifi_scan_sort_index(uint16_t *idx, unsigned int *count, wifi_scan_key_fn_t key, void *arg)
+{
+    wifi_scan_view_t view;
+    int32_t *keys;
+    unsigned int total = 0;
+    unsigned int n     = 0;
+    unsigned int max;
+    unsigned int i;
+    unsigned int j;
+
+    if ((idx == NULL) || (count == NULL))
+    {
+        return -WM_E_INVAL;
+    }
+
+    if (key == NULL)
+    {
+        key = wifi_scan_rssi_key;
+    }
+
+    (void)wifi_get_scan_result_count(&total);
+    max = MIN(total, *count);
+    if (max == 0U)
+    {
+        *count = 0;
+        return WM_SUCCESS;
+    }
+
+    keys = (int32_t *)os_mem_alloc(max * sizeof(int32_t));
+    if (keys == NULL)
+    {
+        return -WM_E_NOMEM;
+    }
+
+    /* Evaluate each key once and keep the best max (key, index) pairs by
+     * bounded insertion. Equal keys keep the scan table order. */
+    for (i = 0; i < total; i++)
+    {
+        if (wrapper_bssdesc_view((int)i, &view) != WM_SUCCESS)
+        {
+            break;
+        }
+
+        int32_t k = key(&view, arg);
+
+        if ((n == max) && (keys[n - 1U] >= k))
+        {
+            continue;
+        }
+
+        j = (n < max) ? n++ : (n - 1U);
+        for (; (j > 0U) && (keys[j - 1U] < k); j--)
+        {
+            keys[j] = keys[j - 1U];
+            idx[j]  = idx[j - 1U];
+        }
+        keys[j] = k;
+        idx[j]  = (uint16_t)i;
+    }
+
+    os_mem_free(keys);
+
+    *count = n;
+
+    return WM_SUCCESS;
+}
+
+/*
+ * Passive link monitor fed from RxPD metadata.
+ *
+ * There is a single writer (the RX path) per entry. Readers use the
+ * sequence counter to detect a concurrent update and retry, so neither
+ * side ever blocks. A reader that preempted the writer mid-update would
+ * see the same odd count on every retry, so it gives up after
+ * LINK_MON_READ_RETRIES attempts.
+ *
+ * The stale flag is the one field written from outside the RX path. Its
+ * test and clear in the writer and the set in wifi_link_mon_reset() run
+ * in a critical section, so a reset is never lost between the two.
+ */
+typedef struct
+{
+    volatile t_u32 seq;
+    /* set by wifi_link_mon_reset(), cleared by the writer, both in a
+     * critical section */
+    volatile bool stale;
+    bool in_use;
+    t_u8 mac[MLAN_MAC_ADDR_LENGTH];
+    t_u32 rx_pkts;
+    t_u32 last_rx_ms;
+    /* averages in 1/16 dB */
+    t_s32 rssi_avg_q4;
+    t_s32 snr_avg_q4;
+    t_s32 nf_avg_q4;
+    t_s16 rssi_last;
+    t_s16 snr_last;
+    t_s16 nf_last;
+    t_u8 rx_rate;
+    t_u8 rate_info;
+    t_s8 rssi_win[WIFI_LINK_MON_WINDOW];
+    t_u8 win_idx;
+    t_u8 win_cnt;
+} wifi_link_mon_t;
+
+static wifi_link_mon_t link_mon_sta;
+static wifi_link_mon_t link_mon_uap[WIFI_LINK_MON_MAX_STA];
+
+/* Snapshot attempts before a reader reports the entry busy */
+#define LINK_MON_READ_RETRIES 4U
+
+/* EWMA with weight 1/8 in 1/16 dB fixed point */
+#define LINK_MON_EWMA(avg, sample) ((avg) += ((((t_s32)(sample)) << 4) - (avg)) / 8)
+
+static wifi_link_mon_t *wifi_link_mon_find(t_u8 interface, const t_u8 *mac, bool add)
+{
+    wifi_link_mon_t *victim = MNULL;
+    wifi_link_mon_t *m;
+    unsigned long sta;
+    t_u32 now_ms;
+    t_u8 i;
+
+    if (interface == MLAN_BSS_TYPE_STA)
+    {
+        return &link_mon_sta;
+    }
+
+    if (interface != MLAN_BSS_TYPE_UAP || mac == MNULL)
+    {
+        return MNULL;
+    }
+
+    now_ms = os_ticks_to_msec(os_ticks_get());
+
+    for (i = 0; i < WIFI_LINK_MON_MAX_STA; i++)
+    {
+        m = &link_mon_uap[i];
+        if (m->in_use && !memcmp(m->mac, mac, MLAN_MAC_ADDR_LENGTH))
+        {
+            return m;
+        }
+        /* Prefer a free entry, otherwise the station heard least recently */
+        if (!m->in_use || m->stale)
+        {
+            if (victim == MNULL || (victim->in_use && !victim->stale))
+            {
+                victim = m;
+            }
+        }
+        else if (victim == MNULL || (victim->in_use && !victim->stale &&
+                                     (now_ms - m->last_rx_ms) > (now_ms - victim->last_rx_ms)))
+        {
+            victim = m;
+        }
+        else
+        {
+            /* Do Nothing */
+        }
+    }
+
+    if (!add)
+    {
+        return MNULL;
+    }
+
+    victim->seq++;
+    __DMB();
+    sta            = os_enter_critical_section();
+    victim->in_use = true;
+    victim->stale  = true;
+    os_exit_critical_section(sta);
+    (void)memcpy((void *)victim->mac, (const void *)mac, MLAN_MAC_ADDR_LENGTH);
+    __DMB();
+    victim->seq++;
+
+    return victim;
+}
+
+/* Called from the RX path only, which is the single writer */
+void wifi_link_mon_rx(t_u8 interface, const t_u8 *src_mac, t_s8 snr, t_s8 nf, t_u8 rx_rate, t_u8 rate_info)
+{
+    wifi_link_mon_t *m = wifi_link_mon_find(interface, src_mac, true);
+    /* RxPD carries the noise floor as a positive magnitude */
+    t_s16 noise = -(t_s16)(t_u8)nf;
+    t_s16 rssi  = (t_s16)snr + noise;
+    bool stale;
+    unsigned long sta;
+
+    if (m == MNULL)
+    {
+        return;
+    }
+
+    m->seq++;
+    __DMB();
+
+    sta      = os_enter_critical_section();
+    stale    = m->stale;
+    m->stale = false;
+    os_exit_critical_section(sta);
+
+    if (stale)
+    {
+        m->rx_pkts = 0;
+        m->win_cnt = 0;
+        m->win_idx = 0;
+    }
+
+    if (m->rx_pkts == 0U)
+    {
+        m->rssi_avg_q4 = (t_s32)rssi << 4;
+        m->snr_avg_q4  = (t_s32)snr << 4;
+        m->nf_avg_q4   = (t_s32)noise << 4;
+    }
+    else
+    {
+        LINK_MON_EWMA(m->rssi_avg_q4, rssi);
+        LINK_MON_EWMA(m->snr_avg_q4, snr);
+        LINK_MON_EWMA(m->nf_avg_q4, noise);
+    }
+    m->rssi_last  = rssi;
+    m->snr_last   = snr;
+    m->nf_last    = noise;
+    m->rx_rate    = rx_rate;
+    m->rate_info  = rate_info;
+    m->last_rx_ms = os_ticks_to_msec(os_ticks_get());
+    m->rx_pkts++;
+
+    m->rssi_win[m->win_idx] = (t_s8)rssi;
+    m->win_idx              = (t_u8)((m->win_idx + 1U) % WIFI_LINK_MON_WINDOW);
+    if (m->win_cnt < WIFI_LINK_MON_WINDOW)
+    {
+        m->win_cnt++;
+    }
+
+    __DMB();
+    m->seq++;
+}
+
+int wifi_link_mon_get(t_u8 interface, const t_u8 *mac, wifi_link_stats_t *stats)
+{
+    const wifi_link_mon_t *m = wifi_link_mon_find(interface, mac, false);
+    wifi_link_mon_t snap;
+    t_u32 seq;
+    t_u32 tries = 0;
+    t_s32 sum   = 0;
+    t_u8 i;
+
+    if (m == MNULL || stats == MNULL)
+    {
+        return -WM_FAIL;
+    }
+
+    do
+    {
+        if (tries++ == LINK_MON_READ_RETRIES)
+        {
+            return -WM_E_BUSY;
+        }
+        seq = m->seq;
+        __DMB();
+        (void)memcpy((void *)&snap, (const void *)m, sizeof(snap));
+        __DMB();
+    } while ((seq & 1U) != 0U || seq != m->seq);
+
+    if (snap.stale || snap.rx_pkts == 0U ||
+        (interface == MLAN_BSS_TYPE_UAP && memcmp(snap.mac, mac, MLAN_MAC_ADDR_LENGTH)))
+    {
+        return -WM_FAIL;
+    }
+
+    (void)memset((void *)stats, 0, sizeof(*stats));
+    stats->rssi_last    = snap.rssi_last;
+    stats->rssi_avg     = (int16_t)(snap.rssi_avg_q4 / 16);
+    stats->snr_last     = snap.snr_last;
+    stats->snr_avg      = (int16_t)(snap.snr_avg_q4 / 16);
+    stats->nf_last      = snap.nf_last;
+    stats->nf_avg       = (int16_t)(snap.nf_avg_q4 / 16);
+    stats->rx_rate      = snap.rx_rate;
+    stats->rate_info    = snap.rate_info;
+    stats->rx_pkts      = snap.rx_pkts;
+    stats->age_ms       = os_ticks_to_msec(os_ticks_get()) - snap.last_rx_ms;
+    stats->rssi_win_min = snap.rssi_win[0];
+    stats->rssi_win_max = snap.rssi_win[0];
+
+    for (i = 0; i < snap.win_cnt; i++)
+    {
+        sum += snap.rssi_win[i];
+        if (snap.rssi_win[i] < stats->rssi_win_min)
+        {
+            stats->rssi_win_min = snap.rssi_win[i];
+        }
+        if (snap.rssi_win[i] > stats->rssi_win_max)
+        {
+            stats->rssi_win_max = snap.rssi_win[i];
+        }
+    }
+    stats->rssi_win_avg = (int16_t)(sum / (t_s32)snap.win_cnt);
+
+    return WM_SUCCESS;
+}
+
+/* Statistics are discarded lazily by the writer on its next update */
+void wifi_link_mon_reset(t_u8 interface)
+{
+    unsigned long sta;
+    t_u8 i;
+
+    sta = os_enter_critical_section();
+    if (interface == MLAN_BSS_TYPE_STA)
+    {
+        link_mon_sta.stale = true;
+    }
+    else
+    {
+        for (i = 0; i < WIFI_LINK_MON_MAX_STA; i++)
+        {
+            link_mon_uap[i].stale = true;
+        }
+    }
+    os_exit_critical_section(sta);
+}
+
 int wifi_register_event_queue(os_queue_t *event_queue)
 {
     if (event_queue == MNULL)
@@ -1378,6 +1800,14 @@ static void wifi_core_input(void *argv)
         (void)wlan_process_int_status(mlan_adap);
 
         wifi_sdio_unlock();
+
+#ifdef CONFIG_WIFI_RX_BATCH
+        /* Everything read in this cycle, including reorder releases, is handed up at once */
+        if (wm_wifi.rx_batch_end_callback != NULL)
+        {
+            wm_wifi.rx_batch_end_callback();
+        }
+#endif
         // wakelock_put(WL_ID_WIFI_CORE_INPUT);
     } /* for ;; */
 }
@@ -1485,6 +1915,13 @@ static int wifi_core_init(void)
         goto fail;
     }
 
+    ret = os_mutex_create(&wm_wifi.roc_mutex, "roc-mutex", OS_MUTEX_INHERIT);
+    if (ret != WM_SUCCESS)
+    {
+        wifi_e("Create roc mutex failed");
+        goto fail;
+    }
+
     /*
      * Take the cmd resp lock immediately so that we can later block on
      * it.
@@ -1620,6 +2057,11 @@ static void wifi_core_deinit(void)
         (void)os_mutex_delete(&wm_wifi.mcastf_mutex);
         wm_wifi.mcastf_mutex = NULL;
     }
+    if (wm_wifi.roc_mutex != NULL)
+    {
+        (void)os_mutex_delete(&wm_wifi.roc_mutex);
+        wm_wifi.roc_mutex = NULL;
+    }
     if (wm_wifi.command_resp_sem != NULL)
     {
         (void)os_semaphore_delete(&wm_wifi.command_resp_sem);
@@ -1714,6 +2156,15 @@ int wifi_init(const uint8_t *fw_start_addr, const size_t size)
     }
 
     ret = (int)sd_wifi_post_init(WLAN_TYPE_NORMAL);
+#ifdef CONFIG_WIFI_WARM_START
+    if (ret != WM_SUCCESS && sd_wifi_warm_start_rejected())
+    {
+        wifi_w("Running firmware cannot be reused, downloading it");
+        wifi_core_deinit();
+        sd_wifi_deinit();
+        return wifi_init(fw_start_addr, size);
+    }
+#endif
     if (ret != WM_SUCCESS)
     {
         wifi_e("wifi_core_init failed. status code %d", ret);
@@ -1930,7 +2381,8 @@ void wifi_deregister_data_input_callback(void)
 
 int wifi_register_amsdu_data_input_callback(void (*amsdu_data_intput_callback)(uint8_t interface,
                                                                                uint8_t *buffer,
-                                                                               uint16_t len))
+                                                                               uint16_t len,
+                                                                               uint8_t priority))
 {
     if (wm_wifi.amsdu_data_intput_callback != NULL)
     {
@@ -1983,6 +2435,25 @@ void wifi_deregister_wrapper_net_is_ip_or_ipv6_callback(void)
     wm_wifi.wrapper_net_is_ip_or_ipv6_callback = NULL;
 }
 
+#ifdef CONFIG_WIFI_RX_BATCH
+int wifi_register_rx_batch_end_callback(void (*rx_batch_end_callback)(void))
+{
+    if (wm_wifi.rx_batch_end_callback != NULL)
+    {
+        return -WM_FAIL;
+    }
+
+    wm_wifi.rx_batch_end_callback = rx_batch_end_callback;
+
+    return WM_SUCCESS;
+}
+
+void wifi_deregister_rx_batch_end_callback(void)
+{
+    wm_wifi.rx_batch_end_callback = NULL;
+}
+#endif
+
 #ifdef CONFIG_WPA_SUPP
 
 void wpa_supp_handle_link_lost(mlan_private *priv)
@@ -2685,9 +3156,10 @@ t_u32 wifi_wmm_get_pkt_prio(t_u8 *buf, t_u8 *tid)
         return WMM_AC_BE;
 }
 
-INLINE t_u8 wifi_wmm_get_packet_cnt(void)
+INLINE t_u32 wifi_wmm_get_packet_cnt(void)
 {
-    return (MAX_WMM_BUF_NUM - mlan_adap->outbuf_pool.free_cnt);
+    return (t_u32)((MAX_WMM_BUF_NUM - mlan_adap->outbuf_pool.free_cnt) +
+                   (mlan_adap->outbuf_pool.ext_total - mlan_adap->outbuf_pool.ext_free_cnt));
 }
 
 #ifdef CONFIG_WIFI_TP_STAT
@@ -2695,6 +3167,8 @@ t_u32 g_wifi_xmit_schedule_end = 0;
 #endif
 
 #ifdef AMSDU_IN_AMPDU
+static mlan_status wifi_xmit_pkts(mlan_private *priv, t_u8 ac, raListTbl *ralist);
+
 /* aggregate one amsdu packet and xmit */
 static mlan_status wifi_xmit_amsdu_pkts(mlan_private *priv, t_u8 ac, raListTbl *ralist)
 {
@@ -2711,6 +3185,8 @@ static mlan_status wifi_xmit_amsdu_pkts(mlan_private *priv, t_u8 ac, raListTbl *
     t_u8 *buf_end = MNULL;
 #endif
 
+    max_amsdu_size = wlan_aggr_tune_amsdu_limit(ralist, max_amsdu_size);
+
     while (ralist->total_pkts > 0)
     {
         mlan_adap->callbacks.moal_semaphore_get(mlan_adap->pmoal_handle, &ralist->buf_head.plock);
@@ -2744,9 +3220,12 @@ static mlan_status wifi_xmit_amsdu_pkts(mlan_private *priv, t_u8 ac, raListTbl *
             ralist->total_pkts--;
             mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &ralist->buf_head.plock);
 
+            /* forming the A-MSDU copies the frame into internal RAM */
+            buf = wifi_wmm_buf_promote(buf, MTRUE);
             amsdu_offset += wlan_11n_form_amsdu_pkt(wifi_get_amsdu_outbuf(amsdu_offset), &buf->data[0],
                                                     buf->tx_pd.tx_pkt_length, &last_pad_len);
             amsdu_cnt++;
+            wlan_aggr_tune_sample(ralist, buf->tx_pd.tx_pkt_length);
 
 #ifdef CONFIG_WIFI_TP_STAT
             wifi_stat_tx_dequeue_end(buf_end);
@@ -2757,6 +3236,10 @@ static mlan_status wifi_xmit_amsdu_pkts(mlan_private *priv, t_u8 ac, raListTbl *
         else
         {
             mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &ralist->buf_head.plock);
+
+            /* a frame above the A-MSDU limit, e.g. with a large MTU, goes out on its own */
+            if (amsdu_cnt == 0U)
+                return wifi_xmit_pkts(priv, ac, ralist);
         }
 
         /*
@@ -2795,6 +3278,10 @@ static mlan_status wifi_xmit_pkts(mlan_private *priv, t_u8 ac, raListTbl *ralist
     mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &ralist->buf_head.plock);
     assert(buf != MNULL);
 
+    buf = wifi_wmm_buf_promote(buf, WMM_BUF_SDIO_COPIED);
+
+    buf->tx_pd.pkt_delay_2ms = wlan_wmm_compute_driver_packet_delay(priv, buf);
+
     /* TODO: this may go wrong for TxPD->tx_pkt_type 0xe5 */
     /* this will get card port lock and probably sleep */
     ret = wlan_xmit_wmm_pkt(priv->bss_index, buf->tx_pd.tx_pkt_length + sizeof(TxPD) + INTF_HEADER_LEN,
@@ -2808,6 +3295,8 @@ static mlan_status wifi_xmit_pkts(mlan_private *priv, t_u8 ac, raListTbl *ralist
         return MLAN_STATUS_RESOURCE;
     }
 
+    wlan_aggr_tune_sample(ralist, buf->tx_pd.tx_pkt_length);
+
     wifi_wmm_buf_put(buf);
     priv->wmm.pkts_queued[ac]--;
 
@@ -2815,7 +3304,36 @@ static mlan_status wifi_xmit_pkts(mlan_private *priv, t_u8 ac, raListTbl *ralist
 }
 
 /*
- *  xmit all buffers under this ralist
+ *  drop buffers at the head of this ralist which waited longer
+ *  than the expiry of their user priority
+ */
+static void wifi_xmit_drop_expired_pkts(mlan_private *priv, t_u8 ac, raListTbl *ralist)
+{
+    outbuf_t *buf = MNULL;
+
+    while (ralist->total_pkts > 0)
+    {
+        mlan_adap->callbacks.moal_semaphore_get(mlan_adap->pmoal_handle, &ralist->buf_head.plock);
+        buf = (outbuf_t *)util_peek_list(mlan_adap->pmoal_handle, &ralist->buf_head, MNULL, MNULL);
+        if (buf == MNULL || wlan_wmm_is_pkt_expired(priv, buf) == MFALSE)
+        {
+            mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &ralist->buf_head.plock);
+            break;
+        }
+        util_unlink_list(mlan_adap->pmoal_handle, &ralist->buf_head, &buf->entry, MNULL, MNULL);
+        ralist->total_pkts--;
+        ralist->drop_count++;
+        mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &ralist->buf_head.plock);
+
+        wifi_wmm_buf_put(buf);
+        priv->wmm.pkts_queued[ac]--;
+        wifi_wmm_drop_expired(priv->bss_type);
+    }
+}
+
+/*
+ *  xmit buffers under this ralist until it is empty or the interface
+ *  used up its budget for this scheduling round
  *  should be called inside wmm tid_tbl_ptr ra_list lock,
  *  return MLAN_STATUS_SUCESS to continue looping ralists,
  *  return MLAN_STATUS_RESOURCE to break looping ralists
@@ -2827,13 +3345,18 @@ static mlan_status wifi_xmit_ralist_pkts(mlan_private *priv, t_u8 ac, raListTbl
     if (ralist->tx_pause == MTRUE)
         return MLAN_STATUS_SUCCESS;
 
-    while (ralist->total_pkts > 0)
+    while (ralist->total_pkts > 0 && priv->tx_deficit > 0U)
     {
         if (wifi_is_tx_queue_empty() == MTRUE)
             break;
 
+        wifi_xmit_drop_expired_pkts(priv, ac, ralist);
+        if (ralist->total_pkts == 0)
+            break;
+
 #ifdef AMSDU_IN_AMPDU
-        if (wlan_is_amsdu_allowed(priv, priv->bss_index, ralist->total_pkts, ac))
+        if (wlan_aggr_tune_amsdu_allowed(ralist) &&
+            wlan_is_amsdu_allowed(priv, priv->bss_index, ralist->total_pkts, ac))
             ret = wifi_xmit_amsdu_pkts(priv, ac, ralist);
         else
 #endif
@@ -2842,6 +3365,9 @@ static mlan_status wifi_xmit_ralist_pkts(mlan_private *priv, t_u8 ac, raListTbl
         if (ret != MLAN_STATUS_SUCCESS)
             return ret;
 
+        priv->tx_deficit--;
+        priv->tx_sched_pkts++;
+
         /*
          * in amsdu case,
          * multiple packets aggregated as one amsdu packet, are counted as one imu packet
@@ -2856,67 +3382,148 @@ static mlan_status wifi_xmit_ralist_pkts(mlan_private *priv, t_u8 ac, raListTbl
     return MLAN_STATUS_SUCCESS;
 }
 
+/*
+ *  dequeue and xmit the buffers of one interface, highest ac first,
+ *  until its queues are empty or its round budget is used up
+ */
+static mlan_status wifi_xmit_bss_pkts(mlan_private *priv, t_u8 *pkt_cnt)
+{
+    int ac;
+    mlan_status ret;
+    raListTbl *ralist  = MNULL;
+    tid_tbl_t *tid_ptr = MNULL;
+
+    for (ac = WMM_AC_VO; ac >= 0; ac--)
+    {
+        tid_ptr = &priv->wmm.tid_tbl_ptr[ac];
+
+        mlan_adap->callbacks.moal_semaphore_get(mlan_adap->pmoal_handle, &tid_ptr->ra_list.plock);
+
+        if (priv->wmm.pkts_queued[ac] == 0)
+        {
+            mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &tid_ptr->ra_list.plock);
+            continue;
+        }
+
+        ralist = (raListTbl *)util_peek_list(mlan_adap->pmoal_handle, (mlan_list_head *)&tid_ptr->ra_list, MNULL, MNULL);
+
+        while (ralist && ralist != (raListTbl *)&tid_ptr->ra_list)
+        {
+            ret = wifi_xmit_ralist_pkts(priv, ac, ralist, pkt_cnt);
+            if (ret != MLAN_STATUS_SUCCESS)
+            {
+                mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &tid_ptr->ra_list.plock);
+                return ret;
+            }
+            if (priv->tx_deficit == 0U)
+            {
+                mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &tid_ptr->ra_list.plock);
+                return MLAN_STATUS_PENDING;
+            }
+            ralist = ralist->pnext;
+        }
+        mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &tid_ptr->ra_list.plock);
+    }
+
+    return MLAN_STATUS_SUCCESS;
+}
+
 /*
  *  dequeue and xmit all buffers under ac queue
- *  loop each priv
- *  loop each ac queue
- *  loop each ralist
- *  dequeue all buffers from buf_head list and xmit
+ *  loop rounds until nothing is left to send
+ *  loop each priv, starting where the last call ran out of ports
+ *  let each priv send up to tx_weight * WMM_BSS_QUANTUM_PKTS packets
+ *  per round (deficit round robin), so that the interfaces share the
+ *  bus and airtime by weight instead of in a fixed order
  */
 static int wifi_xmit_wmm_ac_pkts_enh()
 {
-    int i;
-    int ac;
+    static t_u8 next_bss = 0;
+    int n;
+    t_u8 i;
+    t_u8 pending;
     mlan_status ret;
     t_u8 pkt_cnt       = 0;
     mlan_private *priv = MNULL;
-    raListTbl *ralist  = MNULL;
-    tid_tbl_t *tid_ptr = MNULL;
 
 #ifdef CONFIG_WIFI_TP_STAT
     g_wifi_xmit_schedule_end = os_get_timestamp();
 #endif
 
-    for (i = 0; i < MLAN_MAX_BSS_NUM; i++)
+    /* the radio is off the home channel, keep everything queued */
+    wifi_roc_check_timeout();
+    if (mlan_adap->roc.active == MTRUE)
+        return WM_SUCCESS;
+
+    do
     {
-        priv = mlan_adap->priv[i];
-        if (priv->media_connected == MFALSE || priv->tx_pause == MTRUE)
-            continue;
+        pending = MFALSE;
 
-        for (ac = WMM_AC_VO; ac >= 0; ac--)
+        for (n = 0; n < MLAN_MAX_BSS_NUM; n++)
         {
-            tid_ptr = &priv->wmm.tid_tbl_ptr[ac];
-
-            mlan_adap->callbacks.moal_semaphore_get(mlan_adap->pmoal_handle, &tid_ptr->ra_list.plock);
-
-            if (priv->wmm.pkts_queued[ac] == 0)
+            i    = (t_u8)((next_bss + n) % MLAN_MAX_BSS_NUM);
+            priv = mlan_adap->priv[i];
+            wifi_chan_switch_check_timeout(priv);
+            if (priv->media_connected == MFALSE || priv->tx_pause == MTRUE || priv->chan_sw.active == MTRUE ||
+                wifi_wmm_bss_queued(priv) == 0U)
             {
-                mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &tid_ptr->ra_list.plock);
+                priv->tx_deficit = 0;
                 continue;
             }
 
-            ralist =
-                (raListTbl *)util_peek_list(mlan_adap->pmoal_handle, (mlan_list_head *)&tid_ptr->ra_list, MNULL, MNULL);
+            /* an interface cut short by the bus keeps what is left */
+            if (priv->tx_deficit == 0U)
+                priv->tx_deficit = (t_u32)priv->tx_weight * WMM_BSS_QUANTUM_PKTS;
 
-            while (ralist && ralist != (raListTbl *)&tid_ptr->ra_list)
+            ret = wifi_xmit_bss_pkts(priv, &pkt_cnt);
+            if (ret == MLAN_STATUS_PENDING)
             {
-                ret = wifi_xmit_ralist_pkts(priv, ac, ralist, &pkt_cnt);
-                if (ret != MLAN_STATUS_SUCCESS)
-                {
-                    mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &tid_ptr->ra_list.plock);
-                    goto RET;
-                }
-                ralist = ralist->pnext;
+                pending = MTRUE;
+            }
+            else if (ret != MLAN_STATUS_SUCCESS)
+            {
+                next_bss = i;
+                goto RET;
+            }
+            else
+            {
+                priv->tx_deficit = 0;
             }
-            mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &tid_ptr->ra_list.plock);
         }
-    }
+    } while (pending == MTRUE);
 
 RET:
     wlan_flush_wmm_pkt(pkt_cnt);
     return WM_SUCCESS;
 }
 
+int wifi_set_bss_tx_weight(mlan_bss_type bss_type, t_u8 weight)
+{
+    if (weight == 0U || (t_u32)bss_type >= MLAN_MAX_BSS_NUM)
+        return -WM_E_INVAL;
+
+    mlan_adap->priv[bss_type]->tx_weight = weight;
+
+    return WM_SUCCESS;
+}
+
+int wifi_get_bss_tx_sched_stats(mlan_bss_type bss_type, wifi_bss_tx_sched_stats_t *stats)
+{
+    mlan_private *priv;
+
+    if (stats == MNULL || (t_u32)bss_type >= MLAN_MAX_BSS_NUM)
+        return -WM_E_INVAL;
+
+    priv = mlan_adap->priv[bss_type];
+
+    stats->weight      = priv->tx_weight;
+    stats->queued      = wifi_wmm_bss_queued(priv);
+    stats->sent        = priv->tx_sched_pkts;
+    stats->share_drops = priv->tx_share_drop;
+
+    return WM_SUCCESS;
+}
+
 typedef enum _wifi_tx_event
 {
     TX_TYPE_DATA = 10U,
@@ -3070,6 +3677,9 @@ int wifi_low_level_output(const t_u8 interface,
     mlan_status i;
 #endif
     mlan_private *pmpriv = (mlan_private *)mlan_adap->priv[interface];
+#ifdef CONFIG_WMM
+    t_u8 ba_allowed;
+#endif
 
     w_pkt_d("Data TX: Kernel=>Driver, if %d, len %d", interface, len);
 
@@ -3096,6 +3706,9 @@ int wifi_low_level_output(const t_u8 interface,
     /* process packet headers with interface header and TxPD */
     process_pkt_hdrs((void *)(sd_buffer + sizeof(mlan_linked_list)), len - sizeof(mlan_linked_list), interface, tid);
 
+    /* the buffer belongs to the TX thread once queued */
+    ba_allowed = wlan_aggr_tune_ba_allowed(interface, sd_buffer, pkt_prio);
+
     /* add buffer to ra lists */
     if (wlan_wmm_add_buf_txqueue_enh(interface, sd_buffer, len, pkt_prio) != MLAN_STATUS_SUCCESS)
     {
@@ -3152,7 +3765,7 @@ int wifi_low_level_output(const t_u8 interface,
 
     if (interface == BSS_TYPE_STA && sta_ampdu_tx_enable
 #ifdef CONFIG_WMM
-        && wifi_sta_ampdu_tx_enable_per_tid_is_allowed(tid)
+        && wifi_sta_ampdu_tx_enable_per_tid_is_allowed(tid) && ba_allowed
 #endif
     )
     {
@@ -3168,7 +3781,7 @@ int wifi_low_level_output(const t_u8 interface,
 
     if (interface == BSS_TYPE_UAP && uap_ampdu_tx_enable
 #ifdef CONFIG_WMM
-        && wifi_uap_ampdu_tx_enable_per_tid_is_allowed(tid)
+        && wifi_uap_ampdu_tx_enable_per_tid_is_allowed(tid) && ba_allowed
 #endif
     )
     {
@@ -3341,6 +3954,9 @@ static int raw_low_level_output(const t_u8 interface, const t_u8 *buf, t_u32 len
 
 int wifi_inject_frame(const enum wlan_bss_type bss_type, const uint8_t *buff, const size_t len)
 {
+    /* a frame sent between slices would go out on the home channel */
+    wifi_roc_wait_home();
+
     return raw_low_level_output((t_u8)bss_type, buff, len);
 }
 
@@ -3672,7 +4288,168 @@ int wifi_remain_on_channel(const bool status, const uint8_t channel, const uint3
     }
 #endif
 
-    return wifi_send_remain_on_channel_cmd(MLAN_BSS_TYPE_STA, &roc);
+    /* the supplicant exchanges frames on the channel, never slice */
+    return wifi_roc_request(MLAN_BSS_TYPE_STA, &roc, false);
+}
+
+volatile uint32_t wifi_stats_cnt[WIFI_STAT_NUM];
+/* Counter values at the last reset, volatile so a retried snapshot reads them again */
+static volatile uint32_t wifi_stats_base[WIFI_STAT_NUM];
+/* Bumped by every reset, a snapshot is retried if it changes under it */
+static volatile uint32_t wifi_stats_epoch;
+
+static const char *const wifi_stats_names[WIFI_STAT_NUM] = {
+    [WIFI_STAT_LINK_XMIT]                                          = "link_xmit",
+    [WIFI_STAT_LINK_RECV]                                          = "link_recv",
+    [WIFI_STAT_LINK_DROP]                                          = "link_drop",
+    [WIFI_STAT_LINK_MEMERR]                                        = "link_memerr",
+    [WIFI_STAT_LINK_ERR]                                           = "link_err",
+    [WIFI_STAT_LINK_PROTERR]                                       = "link_proterr",
+    [WIFI_STAT_TX_NO_MEDIA]                                        = "sta_tx_no_media",
+    [WIFI_STAT_TX_ERR_MEM]                                         = "sta_tx_err_mem",
+    [WIFI_STAT_TX_WMM_RETRIED_DROP]                                = "sta_tx_wmm_retried_drop",
+    [WIFI_STAT_TX_WMM_PAUSE_DROP]                                  = "sta_tx_wmm_pause_drop",
+    [WIFI_STAT_TX_WMM_PAUSE_REPLACED]                              = "sta_tx_wmm_pause_replaced",
+    [WIFI_STAT_TX_WMM_EXPIRED_DROP]                                = "sta_tx_wmm_expired_drop",
+    [WIFI_STAT_RX_REORDER_DROP]                                    = "sta_rx_reorder_drop",
+    [WIFI_STAT_BSS(BSS_TYPE_UAP, WIFI_STAT_TX_NO_MEDIA)]           = "uap_tx_no_media",
+    [WIFI_STAT_BSS(BSS_TYPE_UAP, WIFI_STAT_TX_ERR_MEM)]            = "uap_tx_err_mem",
+    [WIFI_STAT_BSS(BSS_TYPE_UAP, WIFI_STAT_TX_WMM_RETRIED_DROP)]   = "uap_tx_wmm_retried_drop",
+    [WIFI_STAT_BSS(BSS_TYPE_UAP, WIFI_STAT_TX_WMM_PAUSE_DROP)]     = "uap_tx_wmm_pause_drop",
+    [WIFI_STAT_BSS(BSS_TYPE_UAP, WIFI_STAT_TX_WMM_PAUSE_REPLACED)] = "uap_tx_wmm_pause_replaced",
+    [WIFI_STAT_BSS(BSS_TYPE_UAP, WIFI_STAT_TX_WMM_EXPIRED_DROP)]   = "uap_tx_wmm_expired_drop",
+    [WIFI_STAT_BSS(BSS_TYPE_UAP, WIFI_STAT_RX_REORDER_DROP)]       = "uap_rx_reorder_drop",
+    [WIFI_STAT_MTU_TX_LARGE]                                       = "mtu_tx_large",
+    [WIFI_STAT_MTU_TX_REFRAG]                                      = "mtu_tx_refrag",
+    [WIFI_STAT_MTU_TX_DROP]                                        = "mtu_tx_drop",
+    [WIFI_STAT_MTU_PEERS_LEARNED]                                  = "mtu_peers_learned",
+    [WIFI_STAT_RX_HANDOFF_POST_FAIL]                               = "rx_handoff_post_fail",
+};
+
+int wifi_stats_snapshot(wifi_stats_snapshot_t *snap)
+{
+    uint32_t epoch;
+    int i;
+
+    if (snap == NULL)
+    {
+        return -WM_E_INVAL;
+    }
+
+    /* A reset runs in a critical section, so it either completes before
+     * the epoch is read or shows up as an epoch change */
+    do
+    {
+        epoch = wifi_stats_epoch;
+        for (i = 0; i < (int)WIFI_STAT_NUM; i++)
+        {
+            snap->cnt[i] = wifi_stats_cnt[i] - wifi_stats_base[i];
+        }
+    } while (epoch != wifi_stats_epoch);
+
+    snap->epoch   = epoch;
+    snap->time_ms = os_ticks_to_msec(os_ticks_get());
+
+    return WM_SUCCESS;
+}
+
+int wifi_stats_delta(const wifi_stats_snapshot_t *prev,
+                     const wifi_stats_snapshot_t *cur,
+                     wifi_stats_snapshot_t *delta)
+{
+    int i;
+
+    if ((prev == NULL) || (cur == NULL) || (delta == NULL))
+    {
+        return -WM_E_INVAL;
+    }
+
+    for (i = 0; i < (int)WIFI_STAT_NUM; i++)
+    {
+        /* Unsigned subtraction also covers counters which wrapped */
+        delta->cnt[i] = (prev->epoch == cur->epoch) ? (cur->cnt[i] - prev->cnt[i]) : cur->cnt[i];
+    }
+    delta->time_ms = cur->time_ms - prev->time_ms;
+    delta->epoch   = cur->epoch;
+
+    return WM_SUCCESS;
+}
+
+void wifi_stats_reset(void)
+{
+    unsigned long sta = os_enter_critical_section();
+    int i;
+
+    for (i = 0; i < (int)WIFI_STAT_NUM; i++)
+    {
+        wifi_stats_base[i] = wifi_stats_cnt[i];
+    }
+    wifi_stats_epoch++;
+
+    os_exit_critical_section(sta);
 }
 
+const char *wifi_stats_name(wifi_stat_id_t id)
+{
+    if ((uint32_t)id >= (uint32_t)WIFI_STAT_NUM)
+    {
+        return NULL;
+    }
+
+    return wifi_stats_names[id];
+}
 
+static void wifi_stats_put_le32(uint8_t *buf, uint32_t val)
+{
+    buf[0] = (uint8_t)val;
+    buf[1] = (uint8_t)(val >> 8);
+    buf[2] = (uint8_t)(val >> 16);
+    buf[3] = (uint8_t)(val >> 24);
+}
+
+int wifi_stats_export(const wifi_stats_snapshot_t *snap, uint8_t *buf, uint32_t buf_len, uint32_t *out_len)
+{
+    uint32_t pos = 12U;
+    uint32_t val;
+    int i;
+
+    if ((snap == NULL) || (buf == NULL) || (out_len == NULL))
+    {
+        return -WM_E_INVAL;
+    }
+
+    if (buf_len < pos)
+    {
+        return -WM_E_NOMEM;
+    }
+
+    buf[0] = (uint8_t)'W';
+    buf[1] = (uint8_t)'S';
+    buf[2] = (uint8_t)WIFI_STATS_EXPORT_VERSION;
+    buf[3] = (uint8_t)WIFI_STAT_NUM;
+    wifi_stats_put_le32(&buf[4], snap->time_ms);
+    wifi_stats_put_le32(&buf[8], snap->epoch);
+
+    for (i = 0; i < (int)WIFI_STAT_NUM; i++)
+    {
+        val = snap->cnt[i];
+        do
+        {
+            if (pos >= buf_len)
+            {
+                return -WM_E_NOMEM;
+            }
+            buf[pos] = (uint8_t)(val & 0x7FU);
+            val >>= 7;
+            if (val != 0U)
+            {
+                buf[pos] |= 0x80U;
+            }
+            pos++;
+        } while (val != 0U);
+    }
+
+    *out_len = pos;
+
+    return WM_SUCCESS;
+}
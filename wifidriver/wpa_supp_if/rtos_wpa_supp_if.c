@@ -1319,6 +1319,12 @@ int wifi_nxp_wpa_supp_set_key(void *if_priv,
         else
         {
             ret = 0;
+#ifdef CONFIG_WPA_SUPP_AP
+            if ((wifi_if_ctx_rtos->bss_type == BSS_TYPE_UAP) && is_pairwise)
+            {
+                wifi_nxp_sta_key_installed(addr);
+            }
+#endif
         }
 
         if (ret || skip_set_key)
@@ -121,6 +121,12 @@ enum user_request_type
     CM_STA_USER_REQUEST_HS,
     CM_STA_USER_REQUEST_PS_ENTER,
     CM_STA_USER_REQUEST_PS_EXIT,
+#ifdef CONFIG_COEX_DUTY_CYCLE
+    CM_STA_USER_REQUEST_COEX_TICK,
+#endif
+#ifdef CONFIG_WIFI_RECOVERY
+    CM_STA_USER_REQUEST_FW_RECOVERED,
+#endif
     CM_STA_USER_REQUEST_LAST,
     /* All the STA related request are above and uAP related requests are
        below */
@@ -133,6 +139,9 @@ enum user_request_type
 };
 
 static int send_user_request(enum user_request_type request, unsigned int data);
+#ifdef CONFIG_COEX_DUTY_CYCLE
+static void wlan_coex_ctrl_tick(void);
+#endif
 
 enum cm_sta_state
 {
@@ -233,9 +242,13 @@ static struct
      * thread when the scan response data has been handled and
      * is therefore free for another user.  This lock must never be taken
      * in the WLAN Connection Manager main thread and it must only be
-     * released by that thread. The lock count must be 0 or 1. */
+     * released by that thread. The lock count must be 0 or 1.
+     * wlan_scan_foreach() is the one exception: it may try the lock from
+     * that thread without waiting and releases it before returning. */
     os_semaphore_t scan_lock;
     bool is_scan_lock;
+    /* The scan result callback runs with scan_lock held on its behalf */
+    bool in_scan_cb;
 
     /* The WLAN Connection Manager event queue receives events (command
      * responses, WiFi events, TCP stack events) from the wifi interface as
@@ -374,6 +387,29 @@ static struct
 wlan_cloud_keep_alive_t cloud_keep_alive_param[MAX_KEEP_ALIVE_ID];
 #endif
 
+#ifdef CONFIG_WIFI_RECOVERY
+/* Time allowed for the reloaded firmware to finish initialization */
+#define WLAN_RECOVERY_INIT_WAIT_MS 10000U
+
+static os_thread_stack_define(g_recovery_stack, 2048);
+
+static struct
+{
+    os_thread_t thread;
+    wlan_recovery_config_t cfg;
+    wlan_recovery_stats_t stats;
+    /* Firmware image given to wlan_init() */
+    const uint8_t *fw_start_addr;
+    size_t fw_size;
+    /* Last country set by the application */
+    char country[COUNTRY_CODE_LEN];
+    unsigned int hang_ms;
+    volatile bool hang;
+    volatile bool in_progress;
+    volatile bool init_done;
+} wlan_recovery;
+#endif
+
 void wlan_wake_up_card(void);
 
 #ifdef CONFIG_WLCMGR_DEBUG
@@ -1752,8 +1788,10 @@ static void report_scan_results(void)
         {
             count = 0;
         }
+        wlan.in_scan_cb = true;
         (void)wlan.scan_cb(count);
-        wlan.scan_cb = NULL;
+        wlan.in_scan_cb = false;
+        wlan.scan_cb    = NULL;
     }
 }
 
@@ -2573,6 +2611,7 @@ static void wlcm_process_association_event(struct wifi_message *msg, enum cm_sta
         *next          = CM_STA_ASSOCIATED;
 
         wlan.scan_count = 0;
+        wifi_link_mon_reset(MLAN_BSS_TYPE_STA);
     }
 #ifndef CONFIG_WPA_SUPP
     else if (wlan.scan_count < WLAN_RESCAN_LIMIT)
@@ -4336,6 +4375,14 @@ static void wlcm_process_get_hw_spec_event(void)
 #endif
     /* Set World Wide Safe Mode Tx Power Limits in Wi-Fi firmware */
     (void)wlan_set_wwsm_txpwrlimit();
+#ifdef CONFIG_WIFI_RECOVERY
+    if (wlan_recovery.in_progress)
+    {
+        /* The recovery thread replays the configuration and reports */
+        wlan_recovery.init_done = true;
+        return;
+    }
+#endif
     CONNECTION_EVENT(WLAN_REASON_INITIALIZED, NULL);
 }
 
@@ -4452,6 +4499,16 @@ static enum cm_sta_state handle_message(struct wifi_message *msg)
             }
             wlan_disable_power_save((int)msg->data);
             break;
+#ifdef CONFIG_COEX_DUTY_CYCLE
+        case CM_STA_USER_REQUEST_COEX_TICK:
+            wlan_coex_ctrl_tick();
+            break;
+#endif
+#ifdef CONFIG_WIFI_RECOVERY
+        case CM_STA_USER_REQUEST_FW_RECOVERED:
+            CONNECTION_EVENT(WLAN_REASON_FW_RECOVERED, &wlan_recovery.stats);
+            break;
+#endif
 
         case WIFI_EVENT_SCAN_START:
 #ifdef CONFIG_WPA_SUPP
@@ -4635,6 +4692,9 @@ static enum cm_sta_state handle_message(struct wifi_message *msg)
             next = wlan.sta_state;
             pbuf_free(msg->data);
             break;
+        case WIFI_EVENT_REMAIN_ON_CHANNEL_SLICE:
+            wifi_roc_next_slice();
+            break;
 #ifdef CONFIG_WPA_SUPP
         case WIFI_EVENT_REMAIN_ON_CHANNEL:
             wifi_process_remain_on_channel(msg);
@@ -4843,6 +4903,11 @@ int wlan_init(const uint8_t *fw_start_addr, const size_t size)
         return ret;
     }
 
+#ifdef CONFIG_WIFI_RECOVERY
+    wlan_recovery.fw_start_addr = fw_start_addr;
+    wlan_recovery.fw_size       = size;
+#endif
+
     wlan.status = WLCMGR_INIT_DONE;
     wifi_mac_addr_t mac_addr;
     wifi_mac_addr_t mac_addr_uap;
@@ -5191,6 +5256,10 @@ int wlan_stop(void)
     }
 #endif
 
+#ifdef CONFIG_COEX_DUTY_CYCLE
+    (void)wlan_coex_ctrl_stop();
+#endif
+
     /* We need to tell the AP that we're going away, however we've already
      * stopped the main thread so we can't do this by means of the state
      * machine.  Unregister from the wifi interface and explicitly send a
@@ -6189,9 +6258,39 @@ int wlan_get_current_nf(void)
     return -g_data_nf_last;
 }
 
+/* Data traffic seen within this period makes RxPD link statistics
+ * preferred over querying the firmware */
+#define WLAN_LINK_MON_FRESH_MS 1000U
+/* Beacon statistics from firmware are reused for this long while
+ * data traffic keeps the data statistics up to date */
+#define WLAN_SIGNAL_INFO_CACHE_MS 5000U
+
+static wifi_rssi_info_t signal_info_cache;
+static uint32_t signal_info_cache_ms;
+static bool signal_info_cache_valid;
+
+static bool wlan_sta_link_stats_fresh(wifi_link_stats_t *stats)
+{
+    if (wifi_link_mon_get(MLAN_BSS_TYPE_STA, NULL, stats) != WM_SUCCESS)
+    {
+        return false;
+    }
+
+    return stats->age_ms < WLAN_LINK_MON_FRESH_MS;
+}
+
 int wlan_get_current_signal_strength(short *rssi, int *snr)
 {
     wifi_rssi_info_t rssi_info;
+    wifi_link_stats_t stats;
+
+    if (wlan_sta_link_stats_fresh(&stats))
+    {
+        *snr  = stats.snr_last;
+        *rssi = stats.rssi_last;
+        return WM_SUCCESS;
+    }
+
     (void)wifi_send_rssi_info_cmd(&rssi_info);
 
     *snr  = rssi_info.bcn_rssi_last - rssi_info.bcn_nf_last;
@@ -6202,6 +6301,15 @@ int wlan_get_current_signal_strength(short *rssi, int *snr)
 int wlan_get_average_signal_strength(short *rssi, int *snr)
 {
     wifi_rssi_info_t rssi_info;
+    wifi_link_stats_t stats;
+
+    if (wlan_sta_link_stats_fresh(&stats))
+    {
+        *snr  = stats.snr_avg;
+        *rssi = stats.rssi_avg;
+        return WM_SUCCESS;
+    }
+
     (void)wifi_send_rssi_info_cmd(&rssi_info);
 
     *snr  = rssi_info.bcn_snr_avg;
@@ -6209,6 +6317,11 @@ int wlan_get_average_signal_strength(short *rssi, int *snr)
     return WM_SUCCESS;
 }
 
+int wlan_get_link_stats(enum wlan_bss_type bss_type, const uint8_t *mac, wlan_link_stats_t *stats)
+{
+    return wifi_link_mon_get((t_u8)bss_type, mac, stats);
+}
+
 int wlan_get_current_rssi(short *rssi)
 {
     g_rssi = (uint8_t)(g_data_snr_last - g_data_nf_last);
@@ -6607,6 +6720,115 @@ int wlan_get_scan_result(unsigned int index, struct wlan_scan_result *res)
     return WM_SUCCESS;
 }
 
+/* The scan result callback runs in the WLAN Connection Manager main thread
+ * with the scan lock already held on behalf of the scan requester. Other
+ * callers on that thread, e.g. event callbacks, only try the lock: its
+ * holder may be waiting for a scan that this thread has to complete. */
+static int wlan_scan_table_lock(bool *locked)
+{
+    unsigned long wait = OS_WAIT_FOREVER;
+
+    *locked = false;
+
+    if (os_get_current_task_handle() == wlan.cm_main_thread)
+    {
+        if (wlan.in_scan_cb)
+        {
+            return WM_SUCCESS;
+        }
+        wait = OS_NO_WAIT;
+    }
+
+    if (os_semaphore_get(&wlan.scan_lock, wait) != WM_SUCCESS)
+    {
+        wlcm_e("failed to get scan lock");
+        return WLAN_ERROR_ACTION;
+    }
+
+    *locked = true;
+
+    return WM_SUCCESS;
+}
+
+static void wlan_scan_table_unlock(bool locked)
+{
+    if (locked)
+    {
+        (void)os_semaphore_put(&wlan.scan_lock);
+    }
+}
+
+int wlan_scan_foreach(wlan_scan_visit_fn_t visit, void *arg)
+{
+    bool locked;
+    int ret;
+
+    if (visit == NULL)
+    {
+        return -WM_E_INVAL;
+    }
+
+    if (!is_running())
+    {
+        return WLAN_ERROR_STATE;
+    }
+
+    ret = wlan_scan_table_lock(&locked);
+    if (ret != WM_SUCCESS)
+    {
+        return ret;
+    }
+
+    ret = wifi_scan_foreach(visit, arg);
+
+    wlan_scan_table_unlock(locked);
+
+    return ret;
+}
+
+int wlan_scan_sort_index(uint16_t *idx, unsigned int *count, wlan_scan_key_fn_t key, void *arg)
+{
+    bool locked;
+    int ret;
+
+    if ((idx == NULL) || (count == NULL))
+    {
+        return -WM_E_INVAL;
+    }
+
+    if (!is_running())
+    {
+        return WLAN_ERROR_STATE;
+    }
+
+    ret = wlan_scan_table_lock(&locked);
+    if (ret != WM_SUCCESS)
+    {
+        return ret;
+    }
+
+    ret = wifi_scan_sort_index(idx, count, key, arg);
+
+    wlan_scan_table_unlock(locked);
+
+    return ret;
+}
+
+int wlan_scan_view_get_security(const wlan_scan_view_t *view, wlan_scan_security_t *security)
+{
+    return wifi_scan_view_get_security(view, security);
+}
+
+int wlan_scan_view_get_caps(const wlan_scan_view_t *view, wlan_scan_caps_t *caps)
+{
+    return wifi_scan_view_get_caps(view, caps);
+}
+
+int wlan_get_scan_mem_stats(wlan_scan_mem_stats_t *stats)
+{
+    return wifi_get_scan_mem_stats(stats);
+}
+
 void wlan_set_cal_data(uint8_t *cal_data, unsigned int cal_data_size)
 {
     wifi_set_cal_data(cal_data, cal_data_size);
@@ -7238,6 +7460,11 @@ int wlan_set_txratecfg(wlan_ds_rate ds_rate, mlan_bss_type bss_type)
     return wifi_set_txratecfg(ds_rate, bss_type);
 }
 
+int wlan_set_tx_ctrl_policy(mlan_bss_type bss_type, uint8_t user_prio, uint32_t tx_control, uint16_t expiry_ms)
+{
+    return wifi_set_tx_ctrl_policy(bss_type, user_prio, tx_control, expiry_ms);
+}
+
 int wlan_get_txratecfg(wlan_ds_rate *ds_rate, mlan_bss_type bss_type)
 {
     int ret;
@@ -7397,7 +7624,7 @@ int wlan_remain_on_channel(const enum wlan_bss_type bss_type,
     }
 #endif
 
-    return wifi_send_remain_on_channel_cmd((uint32_t)bss_type, &roc);
+    return wifi_roc_request((unsigned int)bss_type, &roc, true);
 }
 
 int wlan_get_otp_user_data(uint8_t *buf, uint16_t len)
@@ -8064,142 +8291,483 @@ void wlan_uap_set_ecsa(void)
     wifi_uap_set_ecsa();
 }
 
-void wlan_uap_set_htcapinfo(const uint16_t ht_cap_info)
+int wlan_chan_switch_prepare(mlan_bss_type bss_type)
 {
-    wifi_uap_set_htcapinfo(ht_cap_info);
+    return wifi_chan_switch_prepare(bss_type);
 }
 
-void wlan_uap_set_httxcfg(unsigned short httxcfg)
+int wlan_get_chan_switch_stats(mlan_bss_type bss_type, wlan_chan_switch_stats_t *stats)
 {
-    wifi_uap_set_httxcfg(httxcfg);
+    return wifi_get_chan_switch_stats(bss_type, stats);
 }
 
+int wlan_set_roc_config(const wlan_roc_config_t *cfg)
+{
+    return wifi_set_roc_config(cfg);
+}
 
+int wlan_get_roc_stats(wlan_roc_stats_t *stats)
+{
+    return wifi_get_roc_stats(stats);
+}
 
+int wlan_stats_snapshot(wlan_stats_snapshot_t *snap)
+{
+    return wifi_stats_snapshot(snap);
+}
 
-#ifdef CONFIG_11K
-int _wlan_rrm_scan_cb(unsigned int count)
+int wlan_stats_delta(const wlan_stats_snapshot_t *prev,
+                     const wlan_stats_snapshot_t *cur,
+                     wlan_stats_snapshot_t *delta)
 {
-    t_u16 i;
-    t_u8 *rep_buf = NULL;
-    t_u8 *buf_pos = NULL;
-    /* The sufficient size is the length including reporting frame body */
-    t_u16 suffi_len           = 250U;
-    t_u32 pos_last_indication = 0U;
-    bool match_ap_found       = false;
-    int meas_report_len       = 0;
+    return wifi_stats_delta(prev, cur, delta);
+}
 
-    /* process scan result */
-    rep_buf = (t_u8 *)os_mem_alloc(BEACON_REPORT_BUF_SIZE);
-    if (rep_buf == NULL)
-    {
-        PRINTM(MERROR, "Cannot allocate memory for report buffer");
-        return -1;
-    }
+void wlan_stats_reset(void)
+{
+    wifi_stats_reset();
+}
 
-    (void)memset(rep_buf, 0, BEACON_REPORT_BUF_SIZE);
-    buf_pos = rep_buf;
-    for (i = 0; i < count; i++)
-    {
-        if (wlan_rrm_matched_ap_found(&wlan.rrm_scan_cb_param.rep_data, &mlan_adap->pscan_table[i]))
-        {
-            wlan_add_rm_beacon_report(&wlan.rrm_scan_cb_param.rep_data, &mlan_adap->pscan_table[i], &buf_pos,
-                                      BEACON_REPORT_BUF_SIZE - (buf_pos - rep_buf), &pos_last_indication);
-        }
+const char *wlan_stats_name(wlan_stat_id_t id)
+{
+    return wifi_stats_name(id);
+}
 
-        /* If current rep_buf is not enough and still have AP not added, just send the report */
-        if ((buf_pos + suffi_len - rep_buf > BEACON_REPORT_BUF_SIZE) && (i < count - 1U) &&
-            wlan_rrm_matched_ap_found(&wlan.rrm_scan_cb_param.rep_data, &mlan_adap->pscan_table[i + 1U]))
-        {
-            match_ap_found  = 1;
-            meas_report_len = buf_pos - rep_buf;
-            /* send beacon report, not the last one */
-            wlan_send_mgmt_rm_beacon_report(wlan.rrm_scan_cb_param.dialog_tok, wlan.sta_mac,
-                                            wlan.rrm_scan_cb_param.dst_addr, rep_buf, (t_u32)meas_report_len,
-                                            (bool)wlan.rrm_scan_cb_param.protect);
-            /* Prepare for the next beacon report */
-            (void)memset(rep_buf, 0, BEACON_REPORT_BUF_SIZE);
-            buf_pos = rep_buf;
-        }
+int wlan_stats_export(const wlan_stats_snapshot_t *snap, uint8_t *buf, uint32_t buf_len, uint32_t *out_len)
+{
+    return wifi_stats_export(snap, buf, buf_len, out_len);
+}
 
-        /* Last AP in scan table, and matched AP found */
-        if ((i == count - 1U) && (buf_pos > rep_buf))
-        {
-            match_ap_found = 1;
-            /* Update last indication, the last one */
-            if (wlan.rrm_scan_cb_param.rep_data.last_ind != 0U && pos_last_indication != 0U)
-            {
-                *(char *)pos_last_indication = (char)1U;
-            }
-            meas_report_len = buf_pos - rep_buf;
-            /* send beacon report, the last one */
-            wlan_send_mgmt_rm_beacon_report(wlan.rrm_scan_cb_param.dialog_tok, wlan.sta_mac,
-                                            wlan.rrm_scan_cb_param.dst_addr, rep_buf, (t_u32)meas_report_len,
-                                            (bool)wlan.rrm_scan_cb_param.protect);
-        }
-    }
+#ifdef CONFIG_WPA_SUPP_AP
+int wlan_uap_get_sta_setup_stats(wlan_uap_sta_setup_stats_t *stats)
+{
+    return wifi_uap_get_sta_setup_stats(stats);
+}
 
-    /* If no matched AP found, no beacon report detail */
-    if (!match_ap_found)
+int wlan_uap_get_sta_setup_time(const uint8_t *mac, uint32_t *time_ms)
+{
+    return wifi_uap_get_sta_setup_time(mac, time_ms);
+}
+#endif
+
+#ifdef CONFIG_WIFI_RECOVERY
+static void wlan_recovery_hang_cb(wifi_hang_reason_t reason)
+{
+    if (wlan_recovery.hang)
     {
-        *buf_pos++ = (t_u8)MEASURE_REPORT;
-        /* Tag length */
-        *buf_pos++      = 3;
-        *buf_pos++      = wlan.rrm_scan_cb_param.rep_data.token;
-        *buf_pos++      = WLAN_RRM_REPORT_MODE_ACCEPT;
-        *buf_pos++      = WLAN_RRM_MEASURE_TYPE_BEACON;
-        meas_report_len = buf_pos - rep_buf;
-        /* send beacon report */
-        wlan_send_mgmt_rm_beacon_report(wlan.rrm_scan_cb_param.dialog_tok, wlan.sta_mac,
-                                        wlan.rrm_scan_cb_param.dst_addr, rep_buf, (t_u32)meas_report_len,
-                                        (bool)wlan.rrm_scan_cb_param.protect);
+        return;
     }
 
-    os_mem_free(rep_buf);
-    return 0;
+    wlan_recovery.hang        = true;
+    wlan_recovery.hang_ms     = os_ticks_to_msec(os_ticks_get());
+    wlan_recovery.stats.hangs++;
+    wlan_recovery.stats.last_reason = (uint8_t)reason;
+    (void)os_event_notify_put(wlan_recovery.thread);
 }
 
-void wlan_rrm_request_scan(wlan_scan_params_v2_t *wlan_scan_param, wlan_rrm_scan_cb_param *scan_cb_param)
+static void wlan_recovery_probe(void)
 {
-    char *ssid = NULL;
-    char *ssid2 = NULL;
-
-    ssid = wlan_scan_param->ssid[0];
-    ssid2 = wlan_scan_param->ssid[1];
+    unsigned int now = os_ticks_to_msec(os_ticks_get());
+    wifi_fw_version_ext_t ver_ext;
 
-    if (wlan_scan_param == NULL || scan_cb_param == NULL)
+    if (wlan.status != WLCMGR_ACTIVATED || wlan.cm_ieeeps_configured || wlan.cm_deepsleepps_configured)
     {
-        wlcm_e("ignoring scan request with NULL scan or cb params");
         return;
     }
-    if (!is_scanning_allowed())
+
+    if ((now - wifi_get_last_cmd_sent_ms()) < wlan_recovery.cfg.probe_interval_ms)
     {
-        wlcm_e("ignoring scan request in invalid state");
         return;
     }
 
-    (void)memcpy(&wlan.rrm_scan_cb_param, scan_cb_param, sizeof(wlan_rrm_scan_cb_param));
+    wlan_recovery.stats.probes++;
+    /* A hung firmware trips the command watchdog */
+    (void)wifi_get_device_firmware_version_ext(&ver_ext);
+}
 
-    if (is_uap_started() || is_sta_connected())
-        wlan_scan_param->scan_chan_gap = scan_channel_gap;
-    else
-        wlan_scan_param->scan_chan_gap = (t_u16)0U;
+static void wlan_recovery_replay(struct wlan_network *networks,
+                                 const char *sta_name,
+                                 const char *uap_name,
+                                 bool ieeeps,
+                                 bool deepsleepps,
+                                 unsigned int wakeup_conditions,
+                                 const uint8_t *mlist,
+                                 int mcnt)
+{
+    int i;
 
-    int ret = wifi_send_scan_cmd((t_u8)BSS_ANY, wlan_scan_param->bssid,
-                                 ssid, ssid2,
-                                 wlan_scan_param->num_channels, wlan_scan_param->chan_list, wlan_scan_param->num_probes,
-                                 wlan_scan_param->scan_chan_gap,
-                                 false, false);
-    if (ret == WM_SUCCESS)
+    if (wlan_recovery.country[0] != '\0')
     {
-        wlan.scan_cb       = (int (*)(unsigned int count))(wlan_scan_param->cb);
-        wlan.sta_return_to = wlan.sta_state;
-        wlan.sta_state     = CM_STA_SCANNING_USER;
+        (void)wlan_set_country_code(wlan_recovery.country);
     }
-    else
+
+    for (i = 0; i < WLAN_MAX_KNOWN_NETWORKS; i++)
     {
-        wlcm_e("wifi send scan cmd failed");
-    }
+        if (networks[i].name[0] != '\0' && wlan_add_network(&networks[i]) != WM_SUCCESS)
+        {
+            wlcm_w("recovery: failed to add network %s", networks[i].name);
+        }
+    }
+
+    for (i = 0; i < mcnt; i++)
+    {
+        (void)wifi_add_mcast_filter((uint8_t *)&mlist[i * MLAN_MAC_ADDR_LENGTH]);
+    }
+
+#ifdef CONFIG_CLOUD_KEEP_ALIVE
+    /* Rearmed on the next host sleep entry, as after first set up */
+    for (i = 0; i < MAX_KEEP_ALIVE_ID; i++)
+    {
+        if (cloud_keep_alive_param[i].enable && cloud_keep_alive_param[i].pkt_len != 0U)
+        {
+            cloud_keep_alive_param[i].cached = MTRUE;
+        }
+    }
+#endif
+
+    /* Power save is accepted only while idle, so before connecting */
+    if (ieeeps)
+    {
+        (void)wlan_ieeeps_on(wakeup_conditions);
+    }
+    if (deepsleepps)
+    {
+        (void)wlan_deepsleepps_on();
+    }
+
+    if (uap_name[0] != '\0')
+    {
+        (void)wlan_start_network(uap_name);
+    }
+    if (sta_name[0] != '\0')
+    {
+        (void)wlan_connect((char *)sta_name);
+    }
+}
+
+static void wlan_recovery_run(void)
+{
+    int ret;
+    unsigned int waited = 0;
+    unsigned int downtime;
+    int mcnt;
+    bool ieeeps;
+    bool deepsleepps;
+    unsigned int wakeup_conditions;
+    int (*cb)(enum wlan_event_reason reason, void *data);
+    struct wlan_network *networks;
+    char sta_name[WLAN_NETWORK_NAME_MAX_LENGTH] = {0};
+    char uap_name[WLAN_NETWORK_NAME_MAX_LENGTH] = {0};
+    uint8_t mlist[MLAN_MAX_MULTICAST_LIST_SIZE * MLAN_MAC_ADDR_LENGTH];
+
+    if (wlan.status != WLCMGR_ACTIVATED)
+    {
+        wlcm_w("recovery: wlcmgr not active, hang ignored");
+        wlan_recovery.hang = false;
+        return;
+    }
+
+    wlcm_w("recovery: firmware hang, reason %u", wlan_recovery.stats.last_reason);
+
+    networks = (struct wlan_network *)os_mem_alloc(sizeof(wlan.networks));
+    if (networks == NULL)
+    {
+        wlcm_e("recovery: no memory for network list");
+        goto fail;
+    }
+
+    /* Record what wlan_stop() and the reload throw away */
+    (void)memcpy((void *)networks, (const void *)wlan.networks, sizeof(wlan.networks));
+    if (wlan.cur_network_idx >= 0 && (wlan.sta_state == CM_STA_SCANNING || wlan.sta_state >= CM_STA_ASSOCIATING))
+    {
+        (void)strncpy(sta_name, wlan.networks[wlan.cur_network_idx].name, sizeof(sta_name) - 1U);
+    }
+    if (wlan.cur_uap_network_idx >= 0 && wlan.uap_state >= CM_UAP_STARTED)
+    {
+        (void)strncpy(uap_name, wlan.networks[wlan.cur_uap_network_idx].name, sizeof(uap_name) - 1U);
+    }
+    ieeeps            = wlan.cm_ieeeps_configured;
+    deepsleepps       = wlan.cm_deepsleepps_configured;
+    wakeup_conditions = wlan.wakeup_conditions;
+    mcnt              = wifi_get_mcast_filter_list(mlist, (int)sizeof(mlist));
+    cb                = wlan.cb;
+
+    (void)wlan_stop();
+    wlan_deinit(0);
+
+    if (wlan_recovery.cfg.card_reset != NULL)
+    {
+        wlan_recovery.cfg.card_reset();
+    }
+
+    wlan_recovery.init_done   = false;
+    wlan_recovery.in_progress = true;
+    /* A hang from here on starts another recovery */
+    wlan_recovery.hang = false;
+
+    ret = wlan_init(wlan_recovery.fw_start_addr, wlan_recovery.fw_size);
+    if (ret == WM_SUCCESS)
+    {
+        ret = wlan_start(cb);
+    }
+    if (ret != WM_SUCCESS)
+    {
+        wlcm_e("recovery: restart failed: %d", ret);
+        os_mem_free(networks);
+        wlan.cb = cb;
+        goto fail;
+    }
+
+    while (!wlan_recovery.init_done && waited < WLAN_RECOVERY_INIT_WAIT_MS)
+    {
+        os_thread_sleep(os_msec_to_ticks(100));
+        waited += 100U;
+    }
+    if (!wlan_recovery.init_done)
+    {
+        wlcm_e("recovery: firmware did not initialize");
+        os_mem_free(networks);
+        goto fail;
+    }
+
+    wlan_recovery_replay(networks, sta_name, uap_name, ieeeps, deepsleepps, wakeup_conditions, mlist, mcnt);
+    os_mem_free(networks);
+
+    downtime = os_ticks_to_msec(os_ticks_get()) - wlan_recovery.hang_ms;
+    wlan_recovery.stats.recoveries++;
+    wlan_recovery.stats.last_downtime_ms = downtime;
+    if (downtime > wlan_recovery.stats.max_downtime_ms)
+    {
+        wlan_recovery.stats.max_downtime_ms = downtime;
+    }
+    wlan_recovery.in_progress = false;
+
+    wlcm_w("recovery: done in %u ms", downtime);
+    (void)send_user_request(CM_STA_USER_REQUEST_FW_RECOVERED, 0);
+    return;
+
+fail:
+    wlan_recovery.stats.failures++;
+    wlan_recovery.in_progress = false;
+    CONNECTION_EVENT(WLAN_REASON_FW_RECOVERY_FAILED, NULL);
+}
+
+static void wlan_recovery_main(os_thread_arg_t arg)
+{
+    unsigned long wait;
+
+    for (;;)
+    {
+        wait = (wlan_recovery.cfg.probe_interval_ms != 0U) ? os_msec_to_ticks(wlan_recovery.cfg.probe_interval_ms) :
+                                                             OS_WAIT_FOREVER;
+        (void)os_event_notify_get(wait);
+
+        if (!wlan_recovery.hang)
+        {
+            wlan_recovery_probe();
+        }
+        else
+        {
+            wlan_recovery_run();
+        }
+    }
+}
+
+int wlan_recovery_enable(const wlan_recovery_config_t *cfg)
+{
+    int ret;
+
+    if (cfg == NULL)
+    {
+        return -WM_E_INVAL;
+    }
+
+    (void)memcpy((void *)&wlan_recovery.cfg, (const void *)cfg, sizeof(wlan_recovery.cfg));
+    wifi_set_cmd_timeout(cfg->cmd_timeout_ms);
+
+    if (wlan_recovery.thread == NULL)
+    {
+        ret = os_thread_create(&wlan_recovery.thread, "wlan_recovery", wlan_recovery_main, NULL, &g_recovery_stack,
+                               OS_PRIO_2);
+        if (ret != WM_SUCCESS)
+        {
+            wlcm_e("Create recovery thread failed");
+            wlan_recovery.thread = NULL;
+            return -WM_FAIL;
+        }
+    }
+    else
+    {
+        /* Pick up the new probe interval */
+        (void)os_event_notify_put(wlan_recovery.thread);
+    }
+
+    wifi_set_hang_cb(wlan_recovery_hang_cb);
+
+    return WM_SUCCESS;
+}
+
+int wlan_get_recovery_stats(wlan_recovery_stats_t *stats)
+{
+    if (stats == NULL)
+    {
+        return -WM_E_INVAL;
+    }
+
+    (void)memcpy((void *)stats, (const void *)&wlan_recovery.stats, sizeof(*stats));
+
+    return WM_SUCCESS;
+}
+#endif
+
+#ifdef CONFIG_WIFI_WARM_START
+void wlan_set_fw_warm_start(const char *fw_version)
+{
+    wifi_set_fw_warm_start(fw_version);
+}
+
+int wlan_get_fw_boot_stats(wlan_fw_boot_stats_t *stats)
+{
+    return wifi_get_fw_boot_stats(stats);
+}
+#endif
+
+void wlan_uap_set_htcapinfo(const uint16_t ht_cap_info)
+{
+    wifi_uap_set_htcapinfo(ht_cap_info);
+}
+
+void wlan_uap_set_httxcfg(unsigned short httxcfg)
+{
+    wifi_uap_set_httxcfg(httxcfg);
+}
+
+
+
+
+#ifdef CONFIG_11K
+int _wlan_rrm_scan_cb(unsigned int count)
+{
+    t_u16 i;
+    t_u8 *rep_buf = NULL;
+    t_u8 *buf_pos = NULL;
+    /* The sufficient size is the length including reporting frame body */
+    t_u16 suffi_len           = 250U;
+    t_u32 pos_last_indication = 0U;
+    bool match_ap_found       = false;
+    int meas_report_len       = 0;
+
+    /* process scan result */
+    rep_buf = (t_u8 *)os_mem_alloc(BEACON_REPORT_BUF_SIZE);
+    if (rep_buf == NULL)
+    {
+        PRINTM(MERROR, "Cannot allocate memory for report buffer");
+        return -1;
+    }
+
+    (void)memset(rep_buf, 0, BEACON_REPORT_BUF_SIZE);
+    buf_pos = rep_buf;
+    for (i = 0; i < count; i++)
+    {
+        if (wlan_rrm_matched_ap_found(&wlan.rrm_scan_cb_param.rep_data, &mlan_adap->pscan_table[i]))
+        {
+            wlan_add_rm_beacon_report(&wlan.rrm_scan_cb_param.rep_data, &mlan_adap->pscan_table[i], &buf_pos,
+                                      BEACON_REPORT_BUF_SIZE - (buf_pos - rep_buf), &pos_last_indication);
+        }
+
+        /* If current rep_buf is not enough and still have AP not added, just send the report */
+        if ((buf_pos + suffi_len - rep_buf > BEACON_REPORT_BUF_SIZE) && (i < count - 1U) &&
+            wlan_rrm_matched_ap_found(&wlan.rrm_scan_cb_param.rep_data, &mlan_adap->pscan_table[i + 1U]))
+        {
+            match_ap_found  = 1;
+            meas_report_len = buf_pos - rep_buf;
+            /* send beacon report, not the last one */
+            wlan_send_mgmt_rm_beacon_report(wlan.rrm_scan_cb_param.dialog_tok, wlan.sta_mac,
+                                            wlan.rrm_scan_cb_param.dst_addr, rep_buf, (t_u32)meas_report_len,
+                                            (bool)wlan.rrm_scan_cb_param.protect);
+            /* Prepare for the next beacon report */
+            (void)memset(rep_buf, 0, BEACON_REPORT_BUF_SIZE);
+            buf_pos = rep_buf;
+        }
+
+        /* Last AP in scan table, and matched AP found */
+        if ((i == count - 1U) && (buf_pos > rep_buf))
+        {
+            match_ap_found = 1;
+            /* Update last indication, the last one */
+            if (wlan.rrm_scan_cb_param.rep_data.last_ind != 0U && pos_last_indication != 0U)
+            {
+                *(char *)pos_last_indication = (char)1U;
+            }
+            meas_report_len = buf_pos - rep_buf;
+            /* send beacon report, the last one */
+            wlan_send_mgmt_rm_beacon_report(wlan.rrm_scan_cb_param.dialog_tok, wlan.sta_mac,
+                                            wlan.rrm_scan_cb_param.dst_addr, rep_buf, (t_u32)meas_report_len,
+                                            (bool)wlan.rrm_scan_cb_param.protect);
+        }
+    }
+
+    /* If no matched AP found, no beacon report detail */
+    if (!match_ap_found)
+    {
+        *buf_pos++ = (t_u8)MEASURE_REPORT;
+        /* Tag length */
+        *buf_pos++      = 3;
+        *buf_pos++      = wlan.rrm_scan_cb_param.rep_data.token;
+        *buf_pos++      = WLAN_RRM_REPORT_MODE_ACCEPT;
+        *buf_pos++      = WLAN_RRM_MEASURE_TYPE_BEACON;
+        meas_report_len = buf_pos - rep_buf;
+        /* send beacon report */
+        wlan_send_mgmt_rm_beacon_report(wlan.rrm_scan_cb_param.dialog_tok, wlan.sta_mac,
+                                        wlan.rrm_scan_cb_param.dst_addr, rep_buf, (t_u32)meas_report_len,
+                                        (bool)wlan.rrm_scan_cb_param.protect);
+    }
+
+    os_mem_free(rep_buf);
+    return 0;
+}
+
+void wlan_rrm_request_scan(wlan_scan_params_v2_t *wlan_scan_param, wlan_rrm_scan_cb_param *scan_cb_param)
+{
+    char *ssid = NULL;
+    char *ssid2 = NULL;
+
+    ssid = wlan_scan_param->ssid[0];
+    ssid2 = wlan_scan_param->ssid[1];
+
+    if (wlan_scan_param == NULL || scan_cb_param == NULL)
+    {
+        wlcm_e("ignoring scan request with NULL scan or cb params");
+        return;
+    }
+    if (!is_scanning_allowed())
+    {
+        wlcm_e("ignoring scan request in invalid state");
+        return;
+    }
+
+    (void)memcpy(&wlan.rrm_scan_cb_param, scan_cb_param, sizeof(wlan_rrm_scan_cb_param));
+
+    if (is_uap_started() || is_sta_connected())
+        wlan_scan_param->scan_chan_gap = scan_channel_gap;
+    else
+        wlan_scan_param->scan_chan_gap = (t_u16)0U;
+
+    int ret = wifi_send_scan_cmd((t_u8)BSS_ANY, wlan_scan_param->bssid,
+                                 ssid, ssid2,
+                                 wlan_scan_param->num_channels, wlan_scan_param->chan_list, wlan_scan_param->num_probes,
+                                 wlan_scan_param->scan_chan_gap,
+                                 false, false);
+    if (ret == WM_SUCCESS)
+    {
+        wlan.scan_cb       = (int (*)(unsigned int count))(wlan_scan_param->cb);
+        wlan.sta_return_to = wlan.sta_state;
+        wlan.sta_state     = CM_STA_SCANNING_USER;
+    }
+    else
+    {
+        wlcm_e("wifi send scan cmd failed");
+    }
 }
 #endif
 
@@ -8532,6 +9100,53 @@ void wlan_wmm_tx_stats_dump(int bss_type)
 {
     wifi_wmm_tx_stats_dump(bss_type);
 }
+
+void wlan_set_aggr_auto_tune(bool enable)
+{
+    wifi_set_aggr_auto_tune(enable);
+}
+
+int wlan_get_aggr_tune_stats(int bss_type, const uint8_t *mac, uint8_t ac, wlan_aggr_tune_stats_t *stats)
+{
+    return wifi_get_aggr_tune_stats(bss_type, mac, ac, stats);
+}
+
+int wlan_set_tx_ext_buf_region(uint8_t *region, uint32_t len)
+{
+    return wifi_set_tx_ext_buf_region(region, len);
+}
+
+int wlan_get_tx_buf_pool_stats(wlan_tx_buf_pool_stats_t *stats)
+{
+    return wifi_get_tx_buf_pool_stats(stats);
+}
+
+int wlan_set_bss_tx_weight(mlan_bss_type bss_type, uint8_t weight)
+{
+    return wifi_set_bss_tx_weight(bss_type, weight);
+}
+
+int wlan_get_bss_tx_sched_stats(mlan_bss_type bss_type, wlan_bss_tx_sched_stats_t *stats)
+{
+    return wifi_get_bss_tx_sched_stats(bss_type, stats);
+}
+#endif
+
+void wlan_set_data_path_ops(const wlan_dp_ops_t *ops)
+{
+    wifi_dp_set_ops(ops);
+}
+
+#ifdef CONFIG_WIFI_SDIO_REG_CACHE
+int wlan_get_sdio_reg_stats(wlan_sdio_reg_stats_t *stats)
+{
+    return wifi_get_sdio_reg_stats(stats);
+}
+
+void wlan_reset_sdio_reg_stats(void)
+{
+    wifi_reset_sdio_reg_stats();
+}
 #endif
 
 int wlan_send_hostcmd(
@@ -8559,6 +9174,186 @@ int wlan_set_clocksync_cfg(const wlan_clock_sync_gpio_tsf_t *tsf_latch)
 {
     return wifi_set_clocksync_cfg(tsf_latch, (mlan_bss_type)WLAN_BSS_TYPE_STA);
 }
+
+/* Residual beyond which the model is re-anchored instead of slewed */
+#define CLOCK_SYNC_STEP_US 1000
+/* Residual below which the loop is reported as locked */
+#define CLOCK_SYNC_LOCK_US 50
+/* Extra uncertainty tolerated above twice the best observed error */
+#define CLOCK_SYNC_ERR_SLACK_US 20
+/* Frequency correction limit */
+#define CLOCK_SYNC_MAX_SKEW_PPB 500000
+#define CLOCK_SYNC_LOCK_SAMPLES 4U
+
+static struct
+{
+    bool valid;
+    /* TSF and host time of the last accepted sample */
+    uint64_t tsf_ref;
+    uint32_t host_ref;
+    /* Host clock rate error relative to TSF */
+    int32_t skew_ppb;
+    uint32_t min_err_us;
+    wlan_clock_sync_stats_t stats;
+} clock_sync;
+
+static uint64_t clock_sync_predict(uint32_t host_us)
+{
+    uint32_t dt = host_us - clock_sync.host_ref;
+
+    return clock_sync.tsf_ref + dt + (uint64_t)(((int64_t)dt * clock_sync.skew_ppb) / 1000000000);
+}
+
+int wlan_clock_sync_feed(uint32_t host_us, uint64_t tsf, uint32_t err_us)
+{
+    int64_t residual;
+    uint32_t abs_res;
+    uint32_t dt;
+    unsigned int state = os_enter_critical_section();
+
+    clock_sync.stats.samples++;
+
+    if (!clock_sync.valid)
+    {
+        clock_sync.valid      = true;
+        clock_sync.tsf_ref    = tsf;
+        clock_sync.host_ref   = host_us;
+        clock_sync.min_err_us = err_us;
+        os_exit_critical_section(state);
+        return WM_SUCCESS;
+    }
+
+    /* The best error bound seen ages upwards so that a permanently
+     * slower path (e.g. bus clock change) is eventually accepted. */
+    clock_sync.min_err_us += (clock_sync.min_err_us >> 4) + 1U;
+    if (err_us < clock_sync.min_err_us)
+    {
+        clock_sync.min_err_us = err_us;
+    }
+    clock_sync.stats.min_err_us = clock_sync.min_err_us;
+
+    if (err_us > 2U * clock_sync.min_err_us + CLOCK_SYNC_ERR_SLACK_US)
+    {
+        clock_sync.stats.rejected++;
+        os_exit_critical_section(state);
+        return -WM_E_AGAIN;
+    }
+
+    residual = (int64_t)(tsf - clock_sync_predict(host_us));
+    abs_res  = (uint32_t)(residual < 0 ? -residual : residual);
+    dt       = host_us - clock_sync.host_ref;
+
+    clock_sync.stats.last_residual_us = (int32_t)residual;
+
+    if (abs_res > CLOCK_SYNC_STEP_US)
+    {
+        /* Too far off to slew: re-anchor and keep the frequency estimate */
+        clock_sync.tsf_ref     = tsf;
+        clock_sync.host_ref    = host_us;
+        clock_sync.stats.steps++;
+        clock_sync.stats.locked = false;
+        os_exit_critical_section(state);
+        return WM_SUCCESS;
+    }
+
+    if (abs_res > clock_sync.stats.max_abs_residual_us)
+    {
+        clock_sync.stats.max_abs_residual_us = abs_res;
+    }
+
+    /* Second order loop: a quarter of the phase error is absorbed now,
+     * an eighth of the implied rate error goes into the skew estimate. */
+    if (dt != 0U)
+    {
+        int64_t skew = clock_sync.skew_ppb + ((residual * 1000000000) / (int64_t)dt) / 8;
+
+        if (skew > CLOCK_SYNC_MAX_SKEW_PPB)
+        {
+            skew = CLOCK_SYNC_MAX_SKEW_PPB;
+        }
+        else if (skew < -CLOCK_SYNC_MAX_SKEW_PPB)
+        {
+            skew = -CLOCK_SYNC_MAX_SKEW_PPB;
+        }
+        else
+        {
+            /* Do Nothing */
+        }
+        clock_sync.tsf_ref  = clock_sync_predict(host_us) + (uint64_t)(residual / 4);
+        clock_sync.host_ref = host_us;
+        clock_sync.skew_ppb = (int32_t)skew;
+    }
+
+    clock_sync.stats.drift_ppb = clock_sync.skew_ppb;
+    clock_sync.stats.locked =
+        (abs_res <= CLOCK_SYNC_LOCK_US) && (clock_sync.stats.samples - clock_sync.stats.steps >= CLOCK_SYNC_LOCK_SAMPLES);
+
+    os_exit_critical_section(state);
+    return WM_SUCCESS;
+}
+
+int wlan_clock_sync_update(void)
+{
+    wifi_tsf_sample_t sample;
+    uint32_t half_rtt;
+    int ret = wifi_get_tsf_sample(&sample);
+
+    if (ret != WM_SUCCESS)
+    {
+        return ret;
+    }
+
+    /* Firmware latched the TSF somewhere between command send and
+     * response; use the midpoint and half the round trip as bound. */
+    half_rtt = (sample.rx_us - sample.tx_us) / 2U;
+
+    return wlan_clock_sync_feed(sample.tx_us + half_rtt, sample.tsf, half_rtt);
+}
+
+int wlan_clock_sync_now(uint64_t *tsf)
+{
+    unsigned int state;
+
+    if (tsf == NULL)
+    {
+        return -WM_E_INVAL;
+    }
+
+    state = os_enter_critical_section();
+    if (!clock_sync.valid)
+    {
+        os_exit_critical_section(state);
+        return -WM_FAIL;
+    }
+    *tsf = clock_sync_predict(os_get_timestamp());
+    os_exit_critical_section(state);
+
+    return WM_SUCCESS;
+}
+
+int wlan_clock_sync_get_stats(wlan_clock_sync_stats_t *stats)
+{
+    unsigned int state;
+
+    if (stats == NULL)
+    {
+        return -WM_E_INVAL;
+    }
+
+    state = os_enter_critical_section();
+    (void)memcpy((void *)stats, (const void *)&clock_sync.stats, sizeof(*stats));
+    os_exit_critical_section(state);
+
+    return WM_SUCCESS;
+}
+
+void wlan_clock_sync_reset(void)
+{
+    unsigned int state = os_enter_critical_section();
+
+    (void)memset((void *)&clock_sync, 0, sizeof(clock_sync));
+    os_exit_critical_section(state);
+}
 #endif /* CONFIG_WIFI_CLOCKSYNC */
 
 #ifdef CONFIG_WIFI_EU_CRYPTO
@@ -9417,7 +10212,34 @@ void wlan_free_entp_cert_files(void)
 
 int wlan_get_signal_info(wlan_rssi_info_t *signal)
 {
-    return wifi_send_rssi_info_cmd(signal);
+    wifi_link_stats_t stats;
+    uint32_t now_ms = os_ticks_to_msec(os_ticks_get());
+    int ret;
+
+    /* While data is flowing, refresh the data fields from RxPD and only
+     * go to firmware for beacon statistics once the cache has aged */
+    if (signal_info_cache_valid && (now_ms - signal_info_cache_ms) < WLAN_SIGNAL_INFO_CACHE_MS &&
+        wlan_sta_link_stats_fresh(&stats))
+    {
+        (void)memcpy((void *)signal, (const void *)&signal_info_cache, sizeof(*signal));
+        signal->data_rssi_last = stats.rssi_last;
+        signal->data_rssi_avg  = stats.rssi_avg;
+        signal->data_snr_last  = stats.snr_last;
+        signal->data_snr_avg   = stats.snr_avg;
+        signal->data_nf_last   = stats.nf_last;
+        signal->data_nf_avg    = stats.nf_avg;
+        return WM_SUCCESS;
+    }
+
+    ret = wifi_send_rssi_info_cmd(signal);
+    if (ret == WM_SUCCESS)
+    {
+        (void)memcpy((void *)&signal_info_cache, (const void *)signal, sizeof(signal_info_cache));
+        signal_info_cache_ms    = now_ms;
+        signal_info_cache_valid = true;
+    }
+
+    return ret;
 }
 
 #ifdef CONFIG_TURBO_MODE
@@ -9457,6 +10279,10 @@ int wlan_set_country_code(const char *alpha2)
     country_code[1] = alpha2[1];
     country_code[2] = country3;
 
+#ifdef CONFIG_WIFI_RECOVERY
+    (void)memcpy((void *)wlan_recovery.country, (const void *)country_code, COUNTRY_CODE_LEN);
+#endif
+
 #ifdef CONFIG_WPA_SUPP
 #ifdef CONFIG_WPA_SUPP_AP
     int ret;
@@ -9522,4 +10348,218 @@ int wlan_dual_ant_duty_cycle(t_u16 enable, t_u16 nbTime, t_u16 wlanTime, t_u16 w
 {
     return wifi_dual_ant_duty_cycle(enable, nbTime, wlanTime, wlanBlockTime);
 }
+
+static os_timer_t coex_ctrl_timer;
+static wlan_coex_ctrl_config_t coex_ctrl_cfg;
+static wlan_coex_ctrl_stats_t coex_ctrl_stats;
+/* Direction asked by the last samples and how many agreed in a row */
+static uint8_t coex_ctrl_want;
+static uint8_t coex_ctrl_votes;
+static t_u32 coex_ctrl_last_drops;
+/* Set by a BT latency report, cleared by the tick that consumes it */
+static bool coex_ctrl_bt_reported;
+
+static int wlan_coex_ctrl_apply(uint16_t nb_time)
+{
+    if (coex_ctrl_cfg.dual_ant)
+    {
+        return wlan_dual_ant_duty_cycle(1, nb_time, coex_ctrl_cfg.total_time, coex_ctrl_cfg.far_range_time);
+    }
+
+    return wlan_single_ant_duty_cycle(1, nb_time, coex_ctrl_cfg.total_time);
+}
+
+static void coex_ctrl_timer_cb(os_timer_arg_t arg)
+{
+    /* Duty cycle commands are sent from the wlcmgr thread */
+    (void)send_user_request(CM_STA_USER_REQUEST_COEX_TICK, 0);
+}
+
+static void wlan_coex_ctrl_tick(void)
+{
+    t_u32 queued  = 0;
+    t_u32 drops   = 0;
+    t_u32 new_drops;
+    uint8_t want  = WIFI_COEX_CTRL_HOLD;
+    uint16_t cur  = coex_ctrl_stats.nb_time;
+    uint16_t next = cur;
+    unsigned long sta;
+
+    if (!coex_ctrl_stats.running)
+    {
+        return;
+    }
+
+    /* A BT stack that stopped reporting has no traffic left to protect */
+    sta = os_enter_critical_section();
+    if (!coex_ctrl_bt_reported)
+    {
+        coex_ctrl_stats.bt_latency_ms = 0;
+    }
+    coex_ctrl_bt_reported = false;
+    os_exit_critical_section(sta);
+
+#ifdef CONFIG_WMM
+    (void)wifi_get_wmm_load(MLAN_BSS_TYPE_STA, &queued, &drops);
+#endif
+    /* Raw 32 bit counter sums, a stats reset does not lower them and modular subtraction covers the wrap */
+    new_drops            = drops - coex_ctrl_last_drops;
+    coex_ctrl_last_drops = drops;
+
+    coex_ctrl_stats.wifi_queued = queued;
+    coex_ctrl_stats.wifi_drops  = new_drops;
+
+    if (coex_ctrl_stats.bt_latency_ms > coex_ctrl_cfg.bt_latency_budget_ms)
+    {
+        want = WIFI_COEX_CTRL_TO_BT_LATENCY;
+    }
+    else if (queued >= coex_ctrl_cfg.wifi_queue_high || new_drops != 0U)
+    {
+        want = WIFI_COEX_CTRL_TO_WIFI_LOAD;
+    }
+    else if (queued <= coex_ctrl_cfg.wifi_queue_low)
+    {
+        want = WIFI_COEX_CTRL_TO_BT_IDLE;
+    }
+    else
+    { /* Do Nothing */
+    }
+
+    if (want != coex_ctrl_want)
+    {
+        coex_ctrl_want  = want;
+        coex_ctrl_votes = 0;
+    }
+    if (want == WIFI_COEX_CTRL_HOLD || ++coex_ctrl_votes < coex_ctrl_cfg.hysteresis)
+    {
+        coex_ctrl_stats.last_reason = WIFI_COEX_CTRL_HOLD;
+        return;
+    }
+    coex_ctrl_votes = 0;
+
+    if (want == WIFI_COEX_CTRL_TO_WIFI_LOAD)
+    {
+        next = (cur - coex_ctrl_cfg.nb_time_min > coex_ctrl_cfg.nb_time_step) ?
+                   (uint16_t)(cur - coex_ctrl_cfg.nb_time_step) :
+                   coex_ctrl_cfg.nb_time_min;
+    }
+    else
+    {
+        next = (coex_ctrl_cfg.nb_time_max - cur > coex_ctrl_cfg.nb_time_step) ?
+                   (uint16_t)(cur + coex_ctrl_cfg.nb_time_step) :
+                   coex_ctrl_cfg.nb_time_max;
+    }
+
+    if (next == cur)
+    {
+        coex_ctrl_stats.last_reason = WIFI_COEX_CTRL_HOLD;
+        return;
+    }
+
+    if (wlan_coex_ctrl_apply(next) != WM_SUCCESS)
+    {
+        wlcm_e("coex ctrl: failed to set bt time %u", next);
+        return;
+    }
+
+    wlcm_d("coex ctrl: reason %u bt time %u -> %u (queued %u drops %u bt latency %u ms)", want, cur, next, queued,
+           new_drops, coex_ctrl_stats.bt_latency_ms);
+
+    coex_ctrl_stats.nb_time     = next;
+    coex_ctrl_stats.last_reason = want;
+    coex_ctrl_stats.adjustments++;
+    if (want == WIFI_COEX_CTRL_TO_WIFI_LOAD)
+    {
+        coex_ctrl_stats.to_wifi++;
+    }
+    else
+    {
+        coex_ctrl_stats.to_bt++;
+    }
+}
+
+int wlan_coex_ctrl_start(const wlan_coex_ctrl_config_t *cfg)
+{
+    int ret;
+
+    if (cfg == NULL || cfg->nb_time_step == 0U || cfg->period_ms == 0U || cfg->hysteresis == 0U ||
+        cfg->nb_time_min > cfg->nb_time_max || cfg->nb_time_max >= cfg->total_time ||
+        cfg->wifi_queue_low >= cfg->wifi_queue_high)
+    {
+        return -WM_E_INVAL;
+    }
+
+    (void)wlan_coex_ctrl_stop();
+
+    (void)memcpy((void *)&coex_ctrl_cfg, (const void *)cfg, sizeof(coex_ctrl_cfg));
+    (void)memset((void *)&coex_ctrl_stats, 0, sizeof(coex_ctrl_stats));
+    coex_ctrl_want        = WIFI_COEX_CTRL_HOLD;
+    coex_ctrl_votes       = 0;
+    coex_ctrl_bt_reported = false;
+#ifdef CONFIG_WMM
+    {
+        t_u32 queued;
+        (void)wifi_get_wmm_load(MLAN_BSS_TYPE_STA, &queued, &coex_ctrl_last_drops);
+    }
+#else
+    coex_ctrl_last_drops = 0;
+#endif
+
+    /* Start from the BT friendly end and let Wi-Fi load pull time back */
+    ret = wlan_coex_ctrl_apply(cfg->nb_time_max);
+    if (ret != WM_SUCCESS)
+    {
+        wlcm_e("coex ctrl: failed to set initial duty cycle");
+        return -WM_FAIL;
+    }
+    coex_ctrl_stats.nb_time = cfg->nb_time_max;
+
+    ret = os_timer_create(&coex_ctrl_timer, "coex-ctrl-timer", os_msec_to_ticks(cfg->period_ms), &coex_ctrl_timer_cb,
+                          NULL, OS_TIMER_PERIODIC, OS_TIMER_AUTO_ACTIVATE);
+    if (ret != WM_SUCCESS)
+    {
+        wlcm_e("coex ctrl: failed to create timer");
+        return -WM_FAIL;
+    }
+
+    coex_ctrl_stats.running = true;
+    wlcm_d("coex ctrl: started, bt time %u of %u", cfg->nb_time_max, cfg->total_time);
+
+    return WM_SUCCESS;
+}
+
+int wlan_coex_ctrl_stop(void)
+{
+    if (!coex_ctrl_stats.running)
+    {
+        return WM_SUCCESS;
+    }
+
+    coex_ctrl_stats.running = false;
+    (void)os_timer_delete(&coex_ctrl_timer);
+    wlcm_d("coex ctrl: stopped, bt time %u after %u adjustments", coex_ctrl_stats.nb_time, coex_ctrl_stats.adjustments);
+
+    return WM_SUCCESS;
+}
+
+void wlan_coex_ctrl_report_bt_latency(uint32_t latency_ms)
+{
+    unsigned long sta = os_enter_critical_section();
+
+    coex_ctrl_stats.bt_latency_ms = latency_ms;
+    coex_ctrl_bt_reported         = true;
+    os_exit_critical_section(sta);
+}
+
+int wlan_coex_ctrl_get_stats(wlan_coex_ctrl_stats_t *stats)
+{
+    if (stats == NULL)
+    {
+        return -WM_E_INVAL;
+    }
+
+    (void)memcpy((void *)stats, (const void *)&coex_ctrl_stats, sizeof(*stats));
+
+    return WM_SUCCESS;
+}
 #endif
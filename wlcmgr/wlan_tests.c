@@ -1530,6 +1530,292 @@ static void test_wlan_net_stats(int argc, char **argv)
     net_stat();
 }
 
+static void dump_wlan_stats_usage(void)
+{
+    (void)PRINTF("Usage:\r\n");
+    (void)PRINTF("wlan-stats [delta|export|reset|selftest|bench]\r\n");
+    (void)PRINTF("    no argument: counters since the last reset\r\n");
+    (void)PRINTF("    delta: changes since the previous wlan-stats delta\r\n");
+    (void)PRINTF("    export: counters in the binary telemetry format, hex encoded\r\n");
+    (void)PRINTF("    reset: restart all counters from zero\r\n");
+    (void)PRINTF("    selftest: check delta and export on fixed snapshots\r\n");
+    (void)PRINTF("    bench: time increments and take snapshots during concurrent updates\r\n");
+}
+
+/* Counter the benchmark bumps, its value is restored afterwards */
+#define STATS_BENCH_ID WIFI_STAT_LINK_PROTERR
+#define STATS_BENCH_INCS 10000U
+
+static os_thread_stack_define(stats_bench_stack, 1024);
+static os_thread_t stats_bench_thread;
+static volatile bool stats_bench_done;
+
+/* Writer racing the snapshots taken by wlan_stats_bench() */
+static void stats_bench_writer(os_thread_arg_t arg)
+{
+    uint32_t i;
+
+    for (i = 0; i < STATS_BENCH_INCS; i++)
+    {
+        wifi_stats_inc(STATS_BENCH_ID);
+        if ((i & 0xFFU) == 0xFFU)
+        {
+            os_thread_sleep(1);
+        }
+    }
+
+    stats_bench_done = true;
+    os_thread_self_complete(NULL);
+}
+
+/* Time wifi_stats_inc() and check snapshots taken while another thread
+ * increments: the counter never goes back and no increment is lost */
+static int wlan_stats_bench(void)
+{
+    static wlan_stats_snapshot_t snap;
+    uint32_t start;
+    uint32_t last;
+    uint32_t snaps = 0;
+    unsigned int t0;
+    unsigned int us;
+    uint32_t i;
+    int ret = WM_SUCCESS;
+
+    t0 = os_get_timestamp();
+    for (i = 0; i < STATS_BENCH_INCS; i++)
+    {
+        wifi_stats_inc(STATS_BENCH_ID);
+    }
+    us = os_get_timestamp() - t0;
+    wifi_stats_add(STATS_BENCH_ID, 0U - STATS_BENCH_INCS);
+    (void)PRINTF("wifi_stats_inc: %u ns per increment\r\n", (us * 1000U) / STATS_BENCH_INCS);
+
+    (void)wlan_stats_snapshot(&snap);
+    start = snap.cnt[STATS_BENCH_ID];
+    last  = start;
+
+    /* The writer preempts the snapshot loop each time it wakes up */
+    stats_bench_done = false;
+    if (os_thread_create(&stats_bench_thread, "stats_bench", stats_bench_writer, NULL, &stats_bench_stack,
+                         OS_PRIO_0) != WM_SUCCESS)
+    {
+        (void)PRINTF("FAIL: cannot create the writer thread\r\n");
+        return -WM_FAIL;
+    }
+
+    t0 = os_get_timestamp();
+    while (!stats_bench_done)
+    {
+        (void)wlan_stats_snapshot(&snap);
+        snaps++;
+        if ((snap.cnt[STATS_BENCH_ID] - start) < (last - start))
+        {
+            (void)PRINTF("FAIL: counter went back from %u to %u\r\n", last, snap.cnt[STATS_BENCH_ID]);
+            ret = -WM_FAIL;
+        }
+        last = snap.cnt[STATS_BENCH_ID];
+    }
+    us = os_get_timestamp() - t0;
+    (void)os_thread_delete(&stats_bench_thread);
+
+    (void)wlan_stats_snapshot(&snap);
+    if ((snap.cnt[STATS_BENCH_ID] - start) < STATS_BENCH_INCS)
+    {
+        (void)PRINTF("FAIL: %u of %u increments seen\r\n", snap.cnt[STATS_BENCH_ID] - start, STATS_BENCH_INCS);
+        ret = -WM_FAIL;
+    }
+    wifi_stats_add(STATS_BENCH_ID, 0U - STATS_BENCH_INCS);
+
+    if (snaps != 0U)
+    {
+        (void)PRINTF("%u snapshots during concurrent updates, %u us per snapshot\r\n", snaps, us / snaps);
+    }
+
+    return ret;
+}
+
+/* Check wlan_stats_delta() on counter and time wrap and across a reset */
+static int wlan_stats_selftest_delta(void)
+{
+    static wlan_stats_snapshot_t prev, cur, delta;
+
+    (void)memset(&prev, 0, sizeof(prev));
+    (void)memset(&cur, 0, sizeof(cur));
+
+    prev.epoch   = 7;
+    prev.time_ms = 0xFFFFFF00U;
+    prev.cnt[0]  = 0xFFFFFFF0U;
+    prev.cnt[1]  = 100;
+    cur.epoch    = 7;
+    cur.time_ms  = 0x100U;
+    cur.cnt[0]   = 0x10U;
+    cur.cnt[1]   = 105;
+
+    if (wlan_stats_delta(&prev, &cur, &delta) != WM_SUCCESS || delta.cnt[0] != 0x20U || delta.cnt[1] != 5U ||
+        delta.time_ms != 0x200U || delta.epoch != 7U)
+    {
+        (void)PRINTF("FAIL: delta across a counter or time wrap\r\n");
+        return -WM_FAIL;
+    }
+
+    /* after a reset the new values count from zero, also in place */
+    cur.epoch  = 8;
+    cur.cnt[1] = 3;
+    if (wlan_stats_delta(&prev, &cur, &cur) != WM_SUCCESS || cur.cnt[0] != 0x10U || cur.cnt[1] != 3U ||
+        cur.epoch != 8U)
+    {
+        (void)PRINTF("FAIL: delta across a reset\r\n");
+        return -WM_FAIL;
+    }
+
+    if (wlan_stats_delta(NULL, &cur, &delta) != -WM_E_INVAL)
+    {
+        (void)PRINTF("FAIL: delta accepted a NULL snapshot\r\n");
+        return -WM_FAIL;
+    }
+
+    return WM_SUCCESS;
+}
+
+/* Check the wlan_stats_export() header, LEB128 encoding and size limits */
+static int wlan_stats_selftest_export(void)
+{
+    static wlan_stats_snapshot_t snap;
+    static uint8_t buf[WIFI_STATS_EXPORT_MAX_LEN];
+    const uint8_t leb[] = {0x00, 0x7F, 0x80, 0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F};
+    uint32_t want = 12U + (uint32_t)WIFI_STAT_NUM + 1U + 4U;
+    uint32_t len  = 0;
+    uint32_t i;
+
+    (void)memset(&snap, 0, sizeof(snap));
+    snap.time_ms = 0x04030201U;
+    snap.epoch   = 0x08070605U;
+    snap.cnt[0]  = 0;
+    snap.cnt[1]  = 0x7FU;
+    snap.cnt[2]  = 0x80U;
+    snap.cnt[3]  = 0xFFFFFFFFU;
+
+    if (wlan_stats_export(&snap, buf, sizeof(buf), &len) != WM_SUCCESS || len != want)
+    {
+        (void)PRINTF("FAIL: export length %u, expected %u\r\n", len, want);
+        return -WM_FAIL;
+    }
+
+    if (buf[0] != (uint8_t)'W' || buf[1] != (uint8_t)'S' || buf[2] != (uint8_t)WIFI_STATS_EXPORT_VERSION ||
+        buf[3] != (uint8_t)WIFI_STAT_NUM || buf[4] != 0x01U || buf[7] != 0x04U || buf[8] != 0x05U ||
+        buf[11] != 0x08U)
+    {
+        (void)PRINTF("FAIL: export header\r\n");
+        return -WM_FAIL;
+    }
+
+    if (memcmp(&buf[12], leb, sizeof(leb)) != 0)
+    {
+        (void)PRINTF("FAIL: export LEB128 encoding\r\n");
+        return -WM_FAIL;
+    }
+
+    /* exactly the needed size fits, one byte less does not */
+    if (wlan_stats_export(&snap, buf, want, &len) != WM_SUCCESS ||
+        wlan_stats_export(&snap, buf, want - 1U, &len) != -WM_E_NOMEM ||
+        wlan_stats_export(&snap, buf, 11U, &len) != -WM_E_NOMEM)
+    {
+        (void)PRINTF("FAIL: export buffer size limit\r\n");
+        return -WM_FAIL;
+    }
+
+    /* every counter at its largest needs the documented maximum */
+    for (i = 0; i < (uint32_t)WIFI_STAT_NUM; i++)
+    {
+        snap.cnt[i] = 0xFFFFFFFFU;
+    }
+    if (wlan_stats_export(&snap, buf, sizeof(buf), &len) != WM_SUCCESS || len != WIFI_STATS_EXPORT_MAX_LEN)
+    {
+        (void)PRINTF("FAIL: export of full counters took %u bytes\r\n", len);
+        return -WM_FAIL;
+    }
+
+    return WM_SUCCESS;
+}
+
+static void test_wlan_stats(int argc, char **argv)
+{
+    static wlan_stats_snapshot_t prev;
+    wlan_stats_snapshot_t snap;
+    uint8_t buf[WIFI_STATS_EXPORT_MAX_LEN];
+    uint32_t len = 0;
+    uint32_t i;
+
+    if (argc > 2)
+    {
+        dump_wlan_stats_usage();
+        return;
+    }
+
+    if ((argc == 2) && (string_equal("reset", argv[1]) != 0))
+    {
+        wlan_stats_reset();
+        return;
+    }
+
+    if ((argc == 2) && (string_equal("selftest", argv[1]) != 0))
+    {
+        if (wlan_stats_selftest_delta() == WM_SUCCESS && wlan_stats_selftest_export() == WM_SUCCESS)
+        {
+            (void)PRINTF("wlan-stats selftest passed\r\n");
+        }
+        return;
+    }
+
+    if ((argc == 2) && (string_equal("bench", argv[1]) != 0))
+    {
+        if (wlan_stats_bench() == WM_SUCCESS)
+        {
+            (void)PRINTF("wlan-stats bench passed\r\n");
+        }
+        return;
+    }
+
+    (void)wlan_stats_snapshot(&snap);
+
+    if (argc == 1)
+    {
+        /* Show the counters as they are */
+    }
+    else if (string_equal("delta", argv[1]) != 0)
+    {
+        wlan_stats_snapshot_t cur = snap;
+
+        (void)wlan_stats_delta(&prev, &cur, &snap);
+        prev = cur;
+        (void)PRINTF("Over %u ms:\r\n", snap.time_ms);
+    }
+    else if (string_equal("export", argv[1]) != 0)
+    {
+        if (wlan_stats_export(&snap, buf, sizeof(buf), &len) != WM_SUCCESS)
+        {
+            (void)PRINTF("Error: export failed\r\n");
+            return;
+        }
+        for (i = 0; i < len; i++)
+        {
+            (void)PRINTF("%02x", buf[i]);
+        }
+        (void)PRINTF("\r\n");
+        return;
+    }
+    else
+    {
+        dump_wlan_stats_usage();
+        return;
+    }
+
+    for (i = 0; i < (uint32_t)WIFI_STAT_NUM; i++)
+    {
+        (void)PRINTF("%-28s %u\r\n", wlan_stats_name((wlan_stat_id_t)i), snap.cnt[i]);
+    }
+}
+
 static void test_wlan_scan(int argc, char **argv)
 {
     if (wlan_scan(__scan_cb) != 0)
@@ -1542,6 +1828,73 @@ static void test_wlan_scan(int argc, char **argv)
     }
 }
 
+static int scan_mem_count_visit(const wlan_scan_view_t *view, void *arg)
+{
+    (*(uint32_t *)arg)++;
+    return 0;
+}
+
+/* Report scan table memory per BSS and time parse, store and lookup */
+static void test_wlan_scan_mem(int argc, char **argv)
+{
+    static struct wlan_scan_result res;
+    wlan_scan_mem_stats_t stats;
+    uint32_t visited = 0;
+    unsigned int t0;
+    unsigned int us;
+    uint32_t i;
+
+    if (wlan_get_scan_mem_stats(&stats) != WM_SUCCESS)
+    {
+        (void)PRINTF("Failed to get scan table statistics\r\n");
+        return;
+    }
+
+    (void)PRINTF("Scan table entries: %u\r\n", stats.entries);
+    (void)PRINTF("Slot: %u bytes, inline IE copies would add %u bytes\r\n", stats.slot_bytes, stats.inline_ie_bytes);
+    if (stats.arena_bytes != 0U)
+    {
+        (void)PRINTF("IE arena: %u of %u bytes used, %u IEs dropped\r\n", stats.arena_used, stats.arena_bytes,
+                     stats.ie_dropped);
+        if (stats.entries != 0U)
+        {
+            (void)PRINTF("Per BSS: %u bytes, %u bytes with inline IEs\r\n",
+                         stats.slot_bytes + (stats.arena_used / stats.entries),
+                         stats.slot_bytes + stats.inline_ie_bytes);
+        }
+    }
+    else
+    {
+        (void)PRINTF("Per BSS: %u bytes\r\n", stats.slot_bytes);
+    }
+    if (stats.parse_cnt != 0U)
+    {
+        (void)PRINTF("Parse: %u beacons, %u us each\r\n", stats.parse_cnt, stats.parse_us / stats.parse_cnt);
+    }
+    if (stats.store_cnt != 0U)
+    {
+        (void)PRINTF("Store: %u entries, %u us each\r\n", stats.store_cnt, stats.store_us / stats.store_cnt);
+    }
+
+    if (stats.entries == 0U)
+    {
+        return;
+    }
+
+    t0 = os_get_timestamp();
+    (void)wlan_scan_foreach(scan_mem_count_visit, &visited);
+    us = os_get_timestamp() - t0;
+    (void)PRINTF("Lookup by view: %u entries in %u us\r\n", visited, us);
+
+    t0 = os_get_timestamp();
+    for (i = 0; i < stats.entries; i++)
+    {
+        (void)wlan_get_scan_result(i, &res);
+    }
+    us = os_get_timestamp() - t0;
+    (void)PRINTF("Lookup by copy: %u entries in %u us\r\n", stats.entries, us);
+}
+
 static void dump_wlan_scan_opt_usage(void)
 {
     (void)PRINTF("Usage:\r\n");
@@ -4413,12 +4766,254 @@ static void test_wlan_set_turbo_mode(int argc, char **argv)
 }
 #endif
 
+#ifdef CONFIG_WIFI_MAX_MTU
+
+#include "lwip/udp.h"
+#include "lwip/tcpip.h"
+
+#define MTU_BENCH_PORT 5005U
+/* IPv4 and UDP headers */
+#define MTU_BENCH_HDR_LEN 28U
+
+static struct
+{
+    struct udp_pcb *pcb;
+    volatile uint32_t pkts;
+    volatile uint32_t bytes;
+} mtu_bench;
+
+typedef struct
+{
+    unsigned int start_us;
+#if (configGENERATE_RUN_TIME_STATS == 1) && (INCLUDE_xTaskGetIdleTaskHandle == 1)
+    uint32_t idle;
+    uint32_t total;
+#endif
+    wlan_stats_snapshot_t stats;
+} mtu_bench_mark_t;
+
+static void dump_wlan_mtu_bench_usage(void)
+{
+    (void)PRINTF("Usage:\r\n");
+    (void)PRINTF("wlan-mtu-bench mtu <mtu> [<peer_mac>]\r\n");
+    (void)PRINTF("    set the station MTU and optionally the MTU a peer takes\r\n");
+    (void)PRINTF("wlan-mtu-bench tx <ip> <seconds>\r\n");
+    (void)PRINTF("    send UDP datagrams filling the station MTU to port %u of <ip>\r\n", MTU_BENCH_PORT);
+    (void)PRINTF("wlan-mtu-bench rx <seconds>\r\n");
+    (void)PRINTF("    count UDP datagrams received on port %u\r\n", MTU_BENCH_PORT);
+}
+
+static void mtu_bench_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+    mtu_bench.pkts++;
+    mtu_bench.bytes += p->tot_len;
+    (void)pbuf_free(p);
+}
+
+static void mtu_bench_mark(mtu_bench_mark_t *mark)
+{
+    (void)wlan_stats_snapshot(&mark->stats);
+#if (configGENERATE_RUN_TIME_STATS == 1) && (INCLUDE_xTaskGetIdleTaskHandle == 1)
+    mark->idle  = (uint32_t)ulTaskGetIdleRunTimeCounter();
+    mark->total = (uint32_t)portGET_RUN_TIME_COUNTER_VALUE();
+#endif
+    mark->start_us = os_get_timestamp();
+}
+
+/* Print packets/s, CPU time per byte and the large MTU counters since start */
+static void mtu_bench_report(const mtu_bench_mark_t *start, uint32_t pkts, uint32_t bytes)
+{
+    mtu_bench_mark_t end;
+    uint32_t us;
+
+    mtu_bench_mark(&end);
+    us = end.start_us - start->start_us;
+    if (us == 0U || bytes == 0U)
+    {
+        (void)PRINTF("No traffic\r\n");
+        return;
+    }
+
+    (void)PRINTF("%u datagrams, %u bytes in %u ms\r\n", pkts, bytes, us / 1000U);
+    (void)PRINTF("%u packets/s, %u kbit/s\r\n", (uint32_t)(((uint64_t)pkts * 1000000U) / us),
+                 (uint32_t)(((uint64_t)bytes * 8000U) / us));
+#if (configGENERATE_RUN_TIME_STATS == 1) && (INCLUDE_xTaskGetIdleTaskHandle == 1)
+    {
+        uint32_t total = end.total - start->total;
+        uint32_t busy  = total - (end.idle - start->idle);
+
+        if (total != 0U)
+        {
+            uint64_t busy_us = ((uint64_t)us * busy) / total;
+
+            (void)PRINTF("CPU %u%% busy, %u ns per byte\r\n", (uint32_t)(((uint64_t)busy * 100U) / total),
+                         (uint32_t)((busy_us * 1000U) / bytes));
+        }
+    }
+#else
+    (void)PRINTF("CPU load needs configGENERATE_RUN_TIME_STATS\r\n");
+#endif
+    (void)PRINTF("Large frames %u, refragmented %u, dropped %u\r\n",
+                 end.stats.cnt[WIFI_STAT_MTU_TX_LARGE] - start->stats.cnt[WIFI_STAT_MTU_TX_LARGE],
+                 end.stats.cnt[WIFI_STAT_MTU_TX_REFRAG] - start->stats.cnt[WIFI_STAT_MTU_TX_REFRAG],
+                 end.stats.cnt[WIFI_STAT_MTU_TX_DROP] - start->stats.cnt[WIFI_STAT_MTU_TX_DROP]);
+}
+
+static void mtu_bench_tx(const char *ip, unsigned int secs)
+{
+    static mtu_bench_mark_t start;
+    struct udp_pcb *pcb;
+    struct pbuf *p;
+    ip_addr_t dest;
+    uint16_t mtu     = 0;
+    uint32_t pkts    = 0;
+    uint32_t retries = 0;
+    unsigned int len;
+    err_t err;
+
+    if (net_get_mtu(WLAN_BSS_TYPE_STA, &mtu) != WM_SUCCESS || mtu <= MTU_BENCH_HDR_LEN)
+    {
+        (void)PRINTF("Station interface is not up\r\n");
+        return;
+    }
+    len = mtu - MTU_BENCH_HDR_LEN;
+    ip_addr_set_ip4_u32(&dest, net_inet_aton(ip));
+
+    LOCK_TCPIP_CORE();
+    pcb = udp_new();
+    UNLOCK_TCPIP_CORE();
+    if (pcb == NULL)
+    {
+        (void)PRINTF("Failed to create UDP pcb\r\n");
+        return;
+    }
+
+    (void)PRINTF("Sending %u byte datagrams for %u s\r\n", len, secs);
+    mtu_bench_mark(&start);
+    while ((os_get_timestamp() - start.start_us) < (secs * 1000000U))
+    {
+        LOCK_TCPIP_CORE();
+        p = pbuf_alloc(PBUF_TRANSPORT, (u16_t)len, PBUF_RAM);
+        err = (p != NULL) ? udp_sendto(pcb, p, &dest, (u16_t)MTU_BENCH_PORT) : ERR_MEM;
+        if (p != NULL)
+        {
+            (void)pbuf_free(p);
+        }
+        UNLOCK_TCPIP_CORE();
+
+        if (err == ERR_OK)
+        {
+            pkts++;
+        }
+        else
+        {
+            /* let the driver drain its queues */
+            retries++;
+            os_thread_sleep(1);
+        }
+    }
+
+    mtu_bench_report(&start, pkts, pkts * len);
+    (void)PRINTF("%u sends waited for buffers\r\n", retries);
+
+    LOCK_TCPIP_CORE();
+    udp_remove(pcb);
+    UNLOCK_TCPIP_CORE();
+}
+
+static void mtu_bench_rx(unsigned int secs)
+{
+    static mtu_bench_mark_t start;
+    err_t err;
+
+    LOCK_TCPIP_CORE();
+    mtu_bench.pcb = udp_new();
+    err           = (mtu_bench.pcb != NULL) ? udp_bind(mtu_bench.pcb, IP_ADDR_ANY, (u16_t)MTU_BENCH_PORT) : ERR_MEM;
+    if (err == ERR_OK)
+    {
+        mtu_bench.pkts  = 0;
+        mtu_bench.bytes = 0;
+        udp_recv(mtu_bench.pcb, mtu_bench_recv, NULL);
+    }
+    else if (mtu_bench.pcb != NULL)
+    {
+        udp_remove(mtu_bench.pcb);
+    }
+    else
+    { /* Do Nothing */
+    }
+    UNLOCK_TCPIP_CORE();
+
+    if (err != ERR_OK)
+    {
+        (void)PRINTF("Failed to bind UDP port %u\r\n", MTU_BENCH_PORT);
+        return;
+    }
+
+    (void)PRINTF("Receiving for %u s\r\n", secs);
+    mtu_bench_mark(&start);
+    os_thread_sleep(os_msec_to_ticks(secs * 1000U));
+
+    LOCK_TCPIP_CORE();
+    udp_remove(mtu_bench.pcb);
+    mtu_bench.pcb = NULL;
+    UNLOCK_TCPIP_CORE();
+
+    mtu_bench_report(&start, mtu_bench.pkts, mtu_bench.bytes);
+}
+
+/* Device to device TX/RX test at the configured large MTU */
+static void test_wlan_mtu_bench(int argc, char **argv)
+{
+    uint8_t mac[MLAN_MAC_ADDR_LENGTH];
+    unsigned int value = 0;
+
+    if (argc >= 3 && argc <= 4 && string_equal("mtu", argv[1]) != 0 &&
+        get_uint(argv[2], &value, strlen(argv[2])) == 0)
+    {
+        if (net_set_mtu(WLAN_BSS_TYPE_STA, (uint16_t)value) != WM_SUCCESS)
+        {
+            (void)PRINTF("Invalid MTU %u\r\n", value);
+            return;
+        }
+        if (argc == 4)
+        {
+            if (get_mac(argv[3], (char *)mac, ':') != 0 || net_set_peer_mtu(mac, (uint16_t)value) != WM_SUCCESS)
+            {
+                (void)PRINTF("Invalid peer MAC address\r\n");
+                return;
+            }
+        }
+        (void)PRINTF("MTU set to %u\r\n", value);
+        return;
+    }
+
+    if (argc == 4 && string_equal("tx", argv[1]) != 0 && get_uint(argv[3], &value, strlen(argv[3])) == 0 &&
+        value != 0U)
+    {
+        mtu_bench_tx(argv[2], value);
+        return;
+    }
+
+    if (argc == 3 && string_equal("rx", argv[1]) != 0 && get_uint(argv[2], &value, strlen(argv[2])) == 0 &&
+        value != 0U)
+    {
+        mtu_bench_rx(value);
+        return;
+    }
+
+    dump_wlan_mtu_bench_usage();
+}
+#endif
+
 static struct cli_command tests[] = {
     {"wlan-thread-info", NULL, test_wlan_thread_info},
     {"wlan-net-stats", NULL, test_wlan_net_stats},
+    {"wlan-stats", "[delta|export|reset|selftest|bench]", test_wlan_stats},
     {"wlan-set-mac", "<MAC_Address>", test_wlan_set_mac_address},
     {"wlan-scan", NULL, test_wlan_scan},
     {"wlan-scan-opt", "ssid <ssid> bssid ...", test_wlan_scan_opt},
+    {"wlan-scan-mem", NULL, test_wlan_scan_mem},
     {"wlan-add", "<profile_name> ssid <ssid> bssid...", test_wlan_add},
     {"wlan-remove", "<profile_name>", test_wlan_remove},
     {"wlan-list", NULL, test_wlan_list},
@@ -4519,6 +5114,9 @@ static struct cli_command tests[] = {
     {"wlan-get-turbo-mode", "<STA/UAP>", test_wlan_get_turbo_mode},
     {"wlan-set-turbo-mode", "<STA/UAP> <mode>", test_wlan_set_turbo_mode},
 #endif
+#ifdef CONFIG_WIFI_MAX_MTU
+    {"wlan-mtu-bench", "<mtu|tx|rx> ...", test_wlan_mtu_bench},
+#endif
 #ifdef CONFIG_CLOUD_KEEP_ALIVE
     {"wlan-cloud-keep-alive", "<start/stop/reset>", test_wlan_cloud_keep_alive},
     {"wlan_tcp_client", "dst_ip <dst_ip> src_port <src_port> dst_port <dst_port>", test_wlan_tcp_client},